@@ -0,0 +1,45 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "allocations.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+  std::atomic<std::size_t> counter{0};
+}
+
+std::size_t allocations::count() {
+  return counter.load(std::memory_order_relaxed);
+}
+
+void * operator new(std::size_t size) {
+  counter.fetch_add(1, std::memory_order_relaxed);
+  if (auto pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void * operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void * pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void * pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void * pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
@@ -0,0 +1,20 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Counts every allocation of the process through a replacement of the global operator new
+ *
+ * Linking allocations.cpp into a binary is what enables it
+ */
+namespace allocations {
+
+  /**
+   * @return the number of allocations so far
+   */
+  std::size_t count();
+}
@@ -0,0 +1,55 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include <mfl/out.hpp>
+
+#include "../src/filter.hpp"
+#include "../src/logger.hpp"
+
+namespace logger {
+  std::atomic<Level> verboseLevel{logger::NONE};
+}
+
+namespace {
+
+  constexpr std::size_t DEFAULT_ENTRIES = 10000000;
+
+  /**
+   * Writes `count` random 15 digit identifiers, one per line, as a filter file would have them
+   */
+  void writeFilter(const std::string & path, std::size_t count) {
+    auto file = std::fopen(path.c_str(), "w");
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<std::uint64_t> distribution{100000000000000, 999999999999999};
+    for (std::size_t i = 0; i < count; ++i) {
+      std::fprintf(file, "%llu\n", static_cast<unsigned long long>(distribution(random)));
+    }
+    std::fclose(file);
+  }
+}
+
+/**
+ * Times loading a filter file of 10M entries, or as many as given
+ */
+int main(int argc, char ** argv) {
+  auto count = argc > 1 ? std::stoul(argv[1]) : DEFAULT_ENTRIES;
+  const std::string path = "/tmp/radius-cacher-bench-filter.txt";
+  writeFilter(path, count);
+
+  auto start = std::chrono::steady_clock::now();
+  Filter filter{path, std::chrono::seconds{0}};
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  mfl::out::println(stdout, "{:d} entries loaded in {:d} ms ({:d})",
+                    count,
+                    elapsed.count(),
+                    filter.contains(0));
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,103 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <mfl/out.hpp>
+
+#include "../src/radius_parser.hpp"
+
+namespace logger {
+  std::atomic<Level> verboseLevel{logger::NONE};
+}
+
+namespace {
+
+  constexpr std::size_t ITERATIONS = 1000000;
+
+  void addAttribute(std::vector<std::uint8_t> & packet, std::uint8_t type, const std::vector<std::uint8_t> & value) {
+    packet.push_back(type);
+    packet.push_back(static_cast<std::uint8_t>(value.size() + 2));
+    packet.insert(packet.end(), value.begin(), value.end());
+  }
+
+  /**
+   * Builds an Accounting-Request with `count` attributes, padded with vendor-specific ones
+   *
+   * The attributes of interest come last, so the whole chain has to be walked to find them
+   */
+  std::vector<std::uint8_t> buildPacket(std::size_t count) {
+    std::vector<std::uint8_t> packet(radius::Header::SIZE, 0);
+    packet[0] = radius::Header::REQUEST;
+
+    for (std::size_t i = 3; i < count; ++i) {
+      addAttribute(packet, 26, {0, 0, 0, 9, 1, 6, 'a', 'v', 'p', 'x'});
+    }
+    addAttribute(packet, radius::Attribute::ACCT_STATUS_TYPE, {0, 0, 0, radius::START});
+    addAttribute(packet, radius::Attribute::FRAMED_IP_ADDRESS, {192, 168, 10, 22});
+    addAttribute(packet, radius::Attribute::USER_NAME, {'9', '8', '7', '6', '5', '4', '3', '2', '1'});
+
+    packet[2] = static_cast<std::uint8_t>(packet.size() >> 8u);
+    packet[3] = static_cast<std::uint8_t>(packet.size() & 0xFF);
+    return packet;
+  }
+
+  template <typename F>
+  void measure(const char * name, std::size_t size, const char * unit, F && function) {
+    auto start = std::chrono::steady_clock::now();
+    std::size_t sink{0};
+    for (std::size_t i = 0; i < ITERATIONS; ++i) {
+      sink += function();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    mfl::out::println(stdout, "{:<10s} {:>3d} {:s} {:>8.1f} ns ({:d})",
+                      name,
+                      size,
+                      unit,
+                      static_cast<double>(elapsed.count()) / ITERATIONS,
+                      sink);
+  }
+}
+
+/**
+ * Times the attribute scan alone and the full parse on packets of growing attribute counts,
+ * then the User-Name conversion against std::stoull
+ */
+int main() {
+  RadiusParser parser{"", std::chrono::minutes{0}};
+  radius::AttributeScanner::Selection selection{{0, radius::Attribute::ACCT_STATUS_TYPE},
+                                                {0, radius::Attribute::USER_NAME},
+                                                {0, radius::Attribute::FRAMED_IP_ADDRESS}};
+
+  for (auto count : {5, 30, 80}) {
+    auto packet = buildPacket(count);
+    auto begin = packet.data();
+    auto end = packet.data() + packet.size();
+
+    measure("scan", count, "attributes", [&]() {
+      radius::AttributeScanner attributes{selection, begin + radius::Header::SIZE, end};
+      return attributes[radius::Attribute::USER_NAME].length;
+    });
+
+    measure("parse", count, "attributes", [&]() {
+      return parser(packet.size(), begin, end).action;
+    });
+  }
+
+  std::string userName{"987654321012"};
+  auto begin = reinterpret_cast<const std::uint8_t *>(userName.data());
+
+  measure("stoull", userName.size(), "digits", [&]() {
+    return std::stoull(std::string{userName.data(), userName.size()});
+  });
+
+  measure("decimal", userName.size(), "digits", [&]() {
+    return *decimal::parse(begin, begin + userName.size());
+  });
+
+  return 0;
+}
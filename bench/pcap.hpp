@@ -0,0 +1,193 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+/**
+ * Minimal reader for the UDP payloads of a classic libpcap capture
+ *
+ * Supports microsecond and nanosecond captures of either byte order, on Ethernet (with VLAN tags),
+ * Linux cooked (v1 and v2), BSD loopback and raw IP links. IPv4 fragments and IPv6 extension headers
+ * are skipped, as accounting requests fit a single datagram. pcapng is not supported: convert with
+ * `editcap -F pcap`
+ */
+namespace pcap {
+
+  struct Packet {
+    std::chrono::nanoseconds timestamp;
+    std::vector<std::uint8_t> payload;
+  };
+
+  namespace detail {
+
+    enum LinkType : std::uint32_t {
+      NULL_LOOPBACK = 0,
+      ETHERNET = 1,
+      RAW = 101,
+      LINUX_SLL = 113,
+      LINUX_SLL2 = 276
+    };
+
+    constexpr std::uint16_t ETHERTYPE_IPV4 = 0x0800;
+    constexpr std::uint16_t ETHERTYPE_IPV6 = 0x86DD;
+    constexpr std::uint16_t ETHERTYPE_VLAN = 0x8100;
+    constexpr std::uint8_t PROTOCOL_UDP = 17;
+    constexpr std::size_t UDP_HEADER_SIZE = 8;
+    constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+
+    inline std::uint16_t readBigEndian16(const std::uint8_t * data) {
+      return static_cast<std::uint16_t>(data[0] << 8u | data[1]);
+    }
+
+    /**
+     * Reads a field of the capture headers, which are in the byte order of the capturing host:
+     * little-endian, unless the magic number says they are swapped
+     */
+    inline std::uint32_t read32(const std::uint8_t * data, bool swapped) {
+      return swapped
+             ? static_cast<std::uint32_t>(data[0]) << 24u | static_cast<std::uint32_t>(data[1]) << 16u
+               | static_cast<std::uint32_t>(data[2]) << 8u | data[3]
+             : static_cast<std::uint32_t>(data[3]) << 24u | static_cast<std::uint32_t>(data[2]) << 16u
+               | static_cast<std::uint32_t>(data[1]) << 8u | data[0];
+    }
+
+    /**
+     * Finds the network layer of a frame
+     *
+     * @return the offset of the IP header, or NONE if the frame carries no IP
+     */
+    inline std::size_t networkOffset(std::uint32_t linkType, const std::vector<std::uint8_t> & frame) {
+      switch (linkType) {
+        case ETHERNET: {
+          std::size_t offset{12};
+          while (frame.size() >= offset + 2 && readBigEndian16(&frame[offset]) == ETHERTYPE_VLAN) {
+            offset += 4;
+          }
+          if (frame.size() < offset + 2) return NONE;
+          auto type = readBigEndian16(&frame[offset]);
+          return type == ETHERTYPE_IPV4 || type == ETHERTYPE_IPV6 ? offset + 2 : NONE;
+        }
+        case LINUX_SLL:
+          return 16;
+        case LINUX_SLL2:
+          return 20;
+        case NULL_LOOPBACK:
+          return 4;
+        case RAW:
+          return 0;
+        default:
+          throw std::runtime_error(fmt::format("pcap: unsupported link type {:d}", linkType));
+      }
+    }
+
+    /**
+     * Extracts the payload of a UDP datagram to `port`
+     *
+     * @return whether the frame holds one
+     */
+    inline bool extract(const std::vector<std::uint8_t> & frame,
+                        std::size_t offset,
+                        std::uint16_t port,
+                        std::vector<std::uint8_t> & payload) {
+      if (offset == NONE || offset >= frame.size()) {
+        return false;
+      }
+
+      auto ip = &frame[offset];
+      auto available = frame.size() - offset;
+      std::size_t headerSize;
+      std::size_t totalSize;
+
+      switch (ip[0] >> 4u) {
+        case 4: {
+          headerSize = (ip[0] & 0x0Fu) * 4u;
+          if (available < 20 || headerSize < 20 || ip[9] != PROTOCOL_UDP) return false;
+          if (readBigEndian16(ip + 6) & 0x3FFFu) return false; // Fragment
+          totalSize = readBigEndian16(ip + 2);
+          break;
+        }
+        case 6: {
+          headerSize = 40;
+          if (available < headerSize || ip[6] != PROTOCOL_UDP) return false;
+          totalSize = headerSize + readBigEndian16(ip + 4);
+          break;
+        }
+        default:
+          return false;
+      }
+
+      totalSize = std::min(totalSize, available);
+      if (totalSize < headerSize + UDP_HEADER_SIZE) return false;
+
+      auto udp = ip + headerSize;
+      if (readBigEndian16(udp + 2) != port) return false;
+
+      auto udpSize = std::min<std::size_t>(readBigEndian16(udp + 4), totalSize - headerSize);
+      if (udpSize < UDP_HEADER_SIZE) return false;
+
+      payload.assign(udp + UDP_HEADER_SIZE, udp + udpSize);
+      return true;
+    }
+  }
+
+  /**
+   * Reads the payloads of the UDP datagrams sent to `port`
+   *
+   * @throws runtime_error unreadable or unsupported capture
+   */
+  inline std::vector<Packet> read(const std::string & path, std::uint16_t port) {
+    std::ifstream stream{path, std::ios::binary};
+    if (!stream.is_open()) {
+      throw std::runtime_error(fmt::format("pcap: could not open \"{:s}\"", path));
+    }
+
+    std::uint8_t header[24];
+    if (!stream.read(reinterpret_cast<char *>(header), sizeof(header))) {
+      throw std::runtime_error("pcap: truncated file header");
+    }
+
+    bool swapped;
+    std::uint32_t fractionToNanos;
+    switch (detail::read32(header, false)) {
+      case 0xA1B2C3D4: swapped = false; fractionToNanos = 1000; break;
+      case 0xD4C3B2A1: swapped = true; fractionToNanos = 1000; break;
+      case 0xA1B23C4D: swapped = false; fractionToNanos = 1; break;
+      case 0x4D3CB2A1: swapped = true; fractionToNanos = 1; break;
+      default:
+        throw std::runtime_error("pcap: not a libpcap capture (pcapng must be converted first)");
+    }
+    auto linkType = detail::read32(header + 20, swapped) & 0x0FFFFFFFu;
+
+    std::vector<Packet> packets;
+    std::vector<std::uint8_t> frame;
+    std::uint8_t record[16];
+    while (stream.read(reinterpret_cast<char *>(record), sizeof(record))) {
+      auto seconds = detail::read32(record, swapped);
+      auto fraction = detail::read32(record + 4, swapped);
+      auto size = detail::read32(record + 8, swapped);
+
+      frame.resize(size);
+      if (!stream.read(reinterpret_cast<char *>(frame.data()), size)) {
+        break; // Capture cut short
+      }
+
+      auto offset = detail::networkOffset(linkType, frame);
+      Packet packet{std::chrono::seconds{seconds} + std::chrono::nanoseconds{std::uint64_t{fraction} * fractionToNanos}, {}};
+      if (detail::extract(frame, offset, port, packet.payload)) {
+        packets.push_back(std::move(packet));
+      }
+    }
+    return packets;
+  }
+}
@@ -0,0 +1,243 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <mfl/out.hpp>
+#include <mfl/args.hpp>
+
+#include "allocations.hpp"
+#include "pcap.hpp"
+#include "../src/config.hpp"
+#include "../src/encoder.hpp"
+#include "../src/radius_parser.hpp"
+#include "../src/session_store.hpp"
+
+namespace logger {
+  std::atomic<Level> verboseLevel{logger::NONE};
+}
+
+namespace {
+
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Runs one stage `passes` times over every packet and reports its cost per packet
+   *
+   * @tparam F callable taking the packet index and returning something to sink
+   */
+  template <typename F>
+  void measure(const char * name, std::size_t packets, std::size_t passes, F && function) {
+    std::size_t sink{0};
+    auto allocated = allocations::count();
+    auto start = Clock::now();
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+      for (std::size_t i = 0; i < packets; ++i) {
+        sink += function(i);
+      }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    auto total = static_cast<double>(packets * passes);
+
+    mfl::out::println(stdout, "{:<8s} {:>10.1f} ns/packet {:>8.2f} allocations/packet ({:d})",
+                      name,
+                      static_cast<double>(elapsed.count()) / total,
+                      static_cast<double>(allocations::count() - allocated) / total,
+                      sink);
+  }
+
+  /**
+   * Feeds the payloads through the parser, the encoder and the local store, with no sockets
+   *
+   * Each stage runs on its own over the output of the previous one, so that they are timed
+   * without the clock in the loop. The cache write itself is left out, as it is a socket write
+   */
+  void runOffline(const std::vector<pcap::Packet> & packets,
+                  const Config & config,
+                  const RadiusParser & parser,
+                  std::size_t passes) {
+    Encoder encoder{config.cache};
+    SessionStore store{config.cache};
+
+    measure("parse", packets.size(), passes, [&](std::size_t i) {
+      const auto & payload = packets[i].payload;
+      return parser(payload.size(), payload.data(), payload.data() + payload.size()).action;
+    });
+
+    std::vector<Action> actions;
+    actions.reserve(packets.size());
+    std::array<std::size_t, Action::TYPES> counts{};
+    for (const auto & packet : packets) {
+      actions.push_back(parser(packet.payload.size(), packet.payload.data(), packet.payload.data() + packet.payload.size()));
+      ++counts[actions.back().action];
+    }
+
+    // The keys and values of a STORE, or the keys of a REMOVE, or nothing
+    using Encoded = std::vector<std::pair<std::string, std::string>>;
+    auto encode = [&](const Action & action, std::time_t now) {
+      Encoded encoded;
+      if (action.action != Action::STORE && action.action != Action::REMOVE) {
+        return encoded;
+      }
+
+      auto value = action.action == Action::STORE ? encoder.value(action, now) : std::string{};
+      if (action.key) {
+        encoded.emplace_back(encoder.key(action), value);
+      }
+      for (const auto & prefix : action.prefixes) {
+        encoded.emplace_back(encoder.key(prefix), value);
+      }
+      return encoded;
+    };
+
+    auto now = std::time(nullptr);
+    measure("encode", actions.size(), passes, [&](std::size_t i) {
+      return encode(actions[i], now).size();
+    });
+
+    std::vector<Encoded> encoded;
+    encoded.reserve(actions.size());
+    for (const auto & action : actions) {
+      encoded.push_back(encode(action, now));
+    }
+
+    measure("store", encoded.size(), passes, [&](std::size_t i) {
+      for (const auto & [key, value] : encoded[i]) {
+        if (actions[i].action == Action::STORE) {
+          store.store(key, value, now);
+        } else {
+          store.remove(key);
+        }
+      }
+      return store.expire(now);
+    });
+
+    mfl::out::println(stdout, "{:d} packets x {:d} passes: {:d} STORE, {:d} REMOVE, {:d} FILTER, {:d} DO_NOTHING{:s}",
+                      packets.size(),
+                      passes,
+                      counts[Action::STORE],
+                      counts[Action::REMOVE],
+                      counts[Action::FILTER],
+                      counts[Action::DO_NOTHING],
+                      store.enabled() ? "" : " (LOCAL_STORE is off, so the store stage is a no-op)");
+  }
+
+  /**
+   * Re-sends the payloads over UDP, spaced as captured and divided by `speed`, or back to back if 0
+   */
+  void runSend(const std::vector<pcap::Packet> & packets, const char * address, std::uint16_t port, double speed) {
+    auto fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+      throw std::runtime_error("replay: could not open socket");
+    }
+
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address, &destination.sin_addr) != 1) {
+      ::close(fd);
+      throw std::runtime_error(fmt::format("replay: invalid address {:s}", address));
+    }
+
+    std::size_t sent{0};
+    auto start = Clock::now();
+    for (const auto & packet : packets) {
+      if (speed > 0) {
+        auto offset = std::chrono::duration<double, std::nano>((packet.timestamp - packets.front().timestamp).count() / speed);
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(offset));
+      }
+
+      if (::sendto(fd,
+                   packet.payload.data(),
+                   packet.payload.size(),
+                   0,
+                   reinterpret_cast<const sockaddr *>(&destination),
+                   sizeof(destination)) >= 0) {
+        ++sent;
+      }
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    ::close(fd);
+
+    mfl::out::println(stdout, "sent {:d} of {:d} packets in {:.3f} s ({:.0f} packets/s)",
+                      sent,
+                      packets.size(),
+                      elapsed,
+                      elapsed > 0 ? sent / elapsed : 0.0);
+  }
+
+  void printUsage(std::FILE * file = stdout) {
+    mfl::out::println(file, "Usage for radius-cacher-replay:");
+    mfl::out::println(file, "radius-cacher-replay -r CAPTURE [-p PORT] [-s SERVER_CONFIG] [-m CACHE_CONFIG] [-n PASSES]");
+    mfl::out::println(file, "radius-cacher-replay -r CAPTURE [-p PORT] -u TARGET_PORT [-a ADDRESS] [-x SPEED]");
+    mfl::out::println(file, "  {:<15s}{:s}", "CAPTURE", "libpcap capture of the accounting traffic");
+    mfl::out::println(file, "  {:<15s}{:s}", "PORT", "UDP port of the accounting traffic in the capture (default: 1813)");
+    mfl::out::println(file, "  {:<15s}{:s}", "SERVER_CONFIG", "server configuration for the parser (default: none)");
+    mfl::out::println(file, "  {:<15s}{:s}", "CACHE_CONFIG", "cache configuration for the encoder and store (default: none)");
+    mfl::out::println(file, "  {:<15s}{:s}", "PASSES", "times the capture is run through each stage (default: 10)");
+    mfl::out::println(file, "  {:<15s}{:s}", "TARGET_PORT", "re-send the payloads over UDP to this port instead");
+    mfl::out::println(file, "  {:<15s}{:s}", "ADDRESS", "IPv4 address to re-send to (default: 127.0.0.1)");
+    mfl::out::println(file, "  {:<15s}{:s}", "SPEED", "timing scale: 1 as captured, 2 twice as fast, 0 back to back (default: 1)");
+  }
+}
+
+/**
+ * Replays a capture of accounting traffic, either offline through the processing stages
+ * or over UDP to a running radius-cacher
+ */
+int main(int argc, char * argv[]) {
+  if (mfl::args::findOption(argv, argv + argc, "-h")) {
+    printUsage();
+    return 0;
+  }
+
+  auto capture = mfl::args::extractOption(argv, argv + argc, "-r");
+  if (!capture) {
+    printUsage(stderr);
+    return -1;
+  }
+
+  try {
+    auto option = [&](const char * name, const char * fallback) {
+      auto value = mfl::args::extractOption(argv, argv + argc, name);
+      return value ? value : fallback;
+    };
+
+    auto packets = pcap::read(capture, static_cast<std::uint16_t>(std::stoi(option("-p", "1813"))));
+    if (packets.empty()) {
+      mfl::out::println(stderr, "replay: no UDP payloads in the capture for that port");
+      return -1;
+    }
+
+    if (auto targetPort = mfl::args::extractOption(argv, argv + argc, "-u")) {
+      runSend(packets,
+              option("-a", "127.0.0.1"),
+              static_cast<std::uint16_t>(std::stoi(targetPort)),
+              std::stod(option("-x", "1")));
+      return 0;
+    }
+
+    Config config{option("-s", ""), option("-m", "")};
+    RadiusParser parser{config.server.filterFile,
+                        std::chrono::minutes{0},
+                        config.server.key,
+                        config.server.value,
+                        config.server.rangeFilterFile};
+    runOffline(packets, config, parser, std::stoul(option("-n", "10")));
+
+  } catch (const std::exception & ex) {
+    mfl::out::println(stderr, "replay: {:s}", ex.what());
+    return -1;
+  }
+
+  return 0;
+}
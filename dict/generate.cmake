@@ -0,0 +1,127 @@
+##------------------------------------------------------------------------------
+## Compiles a FreeRADIUS-style dictionary into a constexpr table
+##
+## cmake -DINPUT=<dictionary> -DOUTPUT=<header> -P generate.cmake
+##
+
+cmake_minimum_required(VERSION 3.2)
+
+if (NOT INPUT OR NOT OUTPUT)
+  message(FATAL_ERROR "Usage: cmake -DINPUT=<dictionary> -DOUTPUT=<header> -P generate.cmake")
+endif ()
+
+# Dictionary types and the radius::ValueType they decode to
+set(TYPE_string STRING)
+set(TYPE_octets OCTETS)
+set(TYPE_ipaddr ADDRESS)
+set(TYPE_integer UNSIGNED_INT)
+set(TYPE_date TIME)
+set(TYPE_ifid OCTETS)
+set(TYPE_ipv6addr IPV6_ADDRESS)
+set(TYPE_ipv6prefix IPV6_PREFIX)
+
+# Read line by line, keeping list separators and brackets out of the way
+file(READ ${INPUT} CONTENT)
+string(REGEX REPLACE "[][;]" " " CONTENT "${CONTENT}")
+string(REPLACE "\n" ";" LINES "${CONTENT}")
+
+set(CURRENT_VENDOR 0)
+set(VENDOR_NAME "")
+set(NAMES "")
+set(IDS "")
+set(ENTRIES "")
+set(COUNT 0)
+set(NUMBER 0)
+
+foreach (LINE IN LISTS LINES)
+  math(EXPR NUMBER "${NUMBER} + 1")
+  string(REGEX REPLACE "#.*" "" LINE "${LINE}")
+  string(STRIP "${LINE}" LINE)
+  if (LINE STREQUAL "")
+    continue()
+  endif ()
+
+  string(REGEX REPLACE "[ \t]+" ";" FIELDS "${LINE}")
+  list(LENGTH FIELDS FIELD_COUNT)
+  list(GET FIELDS 0 KEYWORD)
+
+  if (KEYWORD STREQUAL "VENDOR" AND FIELD_COUNT GREATER 2)
+    list(GET FIELDS 1 NAME)
+    list(GET FIELDS 2 ID)
+    if (FIELD_COUNT GREATER 3)
+      list(GET FIELDS 3 FORMAT)
+      if (NOT FORMAT STREQUAL "format=1,1")
+        message(FATAL_ERROR "${INPUT}:${NUMBER}: vendor ${NAME} uses ${FORMAT}. Only format=1,1 is supported")
+      endif ()
+    endif ()
+    set(VENDOR_ID_${NAME} ${ID})
+
+  elseif (KEYWORD STREQUAL "BEGIN-VENDOR" AND FIELD_COUNT GREATER 1)
+    list(GET FIELDS 1 NAME)
+    if (NOT DEFINED VENDOR_ID_${NAME})
+      message(FATAL_ERROR "${INPUT}:${NUMBER}: unknown vendor ${NAME}")
+    endif ()
+    set(CURRENT_VENDOR ${VENDOR_ID_${NAME}})
+    set(VENDOR_NAME ${NAME})
+
+  elseif (KEYWORD STREQUAL "END-VENDOR")
+    set(CURRENT_VENDOR 0)
+    set(VENDOR_NAME "")
+
+  elseif (KEYWORD STREQUAL "ATTRIBUTE" AND FIELD_COUNT GREATER 3)
+    list(GET FIELDS 1 NAME)
+    list(GET FIELDS 2 TYPE)
+    list(GET FIELDS 3 VALUE_TYPE)
+
+    if (NOT TYPE MATCHES "^[0-9]+$" OR TYPE GREATER 255)
+      message(FATAL_ERROR "${INPUT}:${NUMBER}: ${NAME} has an invalid number ${TYPE}")
+    endif ()
+    if (NOT DEFINED TYPE_${VALUE_TYPE})
+      message(FATAL_ERROR "${INPUT}:${NUMBER}: ${NAME} has an unsupported type ${VALUE_TYPE}")
+    endif ()
+
+    # Names are matched in upper case with underscores, like the configuration values
+    string(TOUPPER "${NAME}" CANONICAL)
+    string(REPLACE "-" "_" CANONICAL "${CANONICAL}")
+    list(FIND NAMES "${CANONICAL}" FOUND)
+    if (NOT FOUND EQUAL -1)
+      message(FATAL_ERROR "${INPUT}:${NUMBER}: ${NAME} is defined twice")
+    endif ()
+    list(FIND IDS "${CURRENT_VENDOR}:${TYPE}" FOUND)
+    if (NOT FOUND EQUAL -1)
+      message(FATAL_ERROR "${INPUT}:${NUMBER}: ${NAME} reuses the number ${TYPE}")
+    endif ()
+    list(APPEND NAMES "${CANONICAL}")
+    list(APPEND IDS "${CURRENT_VENDOR}:${TYPE}")
+
+    set(ENTRIES "${ENTRIES}      {\"${CANONICAL}\", {${CURRENT_VENDOR}, ${TYPE}}, ${TYPE_${VALUE_TYPE}}},\n")
+    math(EXPR COUNT "${COUNT} + 1")
+
+  elseif (NOT KEYWORD STREQUAL "VALUE")
+    message(FATAL_ERROR "${INPUT}:${NUMBER}: cannot parse \"${LINE}\"")
+  endif ()
+endforeach ()
+
+if (NOT VENDOR_NAME STREQUAL "")
+  message(FATAL_ERROR "${INPUT}: missing END-VENDOR ${VENDOR_NAME}")
+endif ()
+
+get_filename_component(SOURCE ${INPUT} NAME)
+file(WRITE ${OUTPUT}
+     "//\n"
+     "// Generated from ${SOURCE} by dict/generate.cmake. Do not edit\n"
+     "//\n"
+     "\n"
+     "#pragma once\n"
+     "\n"
+     "#include <array>\n"
+     "\n"
+     "#include \"radius.hpp\"\n"
+     "\n"
+     "namespace radius::dictionary {\n"
+     "\n"
+     "  constexpr std::array<AttributeDefinition, ${COUNT}> ENTRIES{{\n"
+     "${ENTRIES}"
+     "  }};\n"
+     "\n"
+     "}\n")
@@ -4,8 +4,12 @@
 
 #pragma once
 
+#include <array>
 #include <string>
+#include <vector>
 #include <optional>
+#include <utility>
+#include <cstdint>
 
 /**
  * Possible actions to be taken given a certain packet
@@ -18,18 +22,74 @@ struct Action {
     FILTER
   };
 
+  static constexpr std::size_t TYPES = FILTER + 1;
+
+  static constexpr const char * name(ActionType action) {
+    switch (action) {
+      case DO_NOTHING: return "DO_NOTHING";
+      case STORE: return "STORE";
+      case REMOVE: return "REMOVE";
+      case FILTER: return "FILTER";
+      default: return "UNKNOWN";
+    }
+  }
+
   const ActionType action;
   const std::optional<std::string> key;
   const std::optional<std::string> value;
 
+  /**
+   * The raw Acct-Status-Type of the packet, or 0 if not seen
+   */
+  const std::uint32_t status;
+
+  /**
+   * The raw Framed-IP-Address behind `key`, for the compact encoding
+   */
+  const std::optional<std::array<std::uint8_t, 4>> address;
+
+  /**
+   * The numeric User-Name behind `value`, if it is all digits
+   */
+  const std::optional<std::uint64_t> subscriberId;
+
+  /**
+   * The packed record of every projected attribute, sent to the cache instead of `value`
+   * when more than one is projected
+   */
+  const std::optional<std::string> record;
+
+  /**
+   * The IPv6 prefixes of the session, 16 octets with the host bits cleared, each written
+   * as a key of its own along with `key`. Either may be missing, but not both
+   */
+  const std::vector<std::array<std::uint8_t, 16>> prefixes;
+
   Action()
       : action{DO_NOTHING},
         key{},
-        value{} {}
+        value{},
+        status{0},
+        address{},
+        subscriberId{},
+        record{},
+        prefixes{} {}
 
-  Action(ActionType action, std::optional<std::string> && key, std::optional<std::string> && value)
+  Action(ActionType action,
+         std::optional<std::string> && key,
+         std::optional<std::string> && value,
+         std::uint32_t status = 0,
+         std::optional<std::array<std::uint8_t, 4>> address = std::nullopt,
+         std::optional<std::uint64_t> subscriberId = std::nullopt,
+         std::optional<std::string> && record = std::nullopt,
+         std::vector<std::array<std::uint8_t, 16>> && prefixes = {})
       : action{action},
         key{key},
-        value{value} {}
+        value{value},
+        status{status},
+        address{address},
+        subscriberId{subscriberId},
+        record{std::move(record)},
+        prefixes{std::move(prefixes)} {}
 };
 
@@ -0,0 +1,195 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <initializer_list>
+
+#include "radius.hpp"
+
+namespace radius {
+
+  /**
+   * Single pass over the AVP chain of a packet
+   *
+   * Validates that every attribute fits the packet and that the chain ends exactly at its end,
+   * recording on the way where the attributes of interest are. Extraction is then a direct
+   * lookup by type instead of a walk that re-checks bounds and switches on every attribute.
+   *
+   * Every attribute is stored through a type-to-slot table, with the types of no interest all
+   * landing on a discard slot. The walk stops as soon as every selected attribute has been seen,
+   * so the rest of the chain is neither read nor validated. Repeated attributes keep the last
+   * occurrence before that point.
+   *
+   * Vendor-Specific attributes are decoded lazily: the scan only notes that there are some, and
+   * their sub-attributes are walked when a vendor attribute is looked up. If no vendor attribute
+   * is selected, they are discarded like any other. Selecting one disables the early stop, since
+   * the scan cannot tell whether the sub-attribute is there
+   */
+  class AttributeScanner {
+  public:
+
+    /**
+     * The value of an attribute, without its preamble
+     */
+    struct Span {
+      const std::uint8_t * begin{nullptr};
+      std::uint8_t length{0};
+
+      const std::uint8_t * end() const {
+        return begin + length;
+      }
+
+      explicit operator bool() const {
+        return begin != nullptr;
+      }
+    };
+
+    /**
+     * The attributes a scan records, resolved once when the parser is built
+     */
+    class Selection {
+      friend class AttributeScanner;
+
+      // Never matched by the slots seen, for selections that cannot stop early
+      static constexpr std::uint32_t NEVER = 1u << 31u;
+
+      std::array<std::uint8_t, 256> mSlots{};
+      std::uint8_t mSize{0};
+      std::uint32_t mComplete{0};
+
+    public:
+      static constexpr std::size_t MAX = 15;
+
+      Selection(std::initializer_list<AttributeId> ids) {
+        for (auto id : ids) {
+          add(id);
+        }
+      }
+
+      /**
+       * @throws runtime_error more than MAX attribute types
+       */
+      void add(AttributeId id) {
+        auto type = id.vendor == 0 ? id.type : static_cast<std::uint8_t>(Attribute::VENDOR_SPECIFIC);
+        if (mSlots[type] != 0) {
+          return;
+        }
+        if (mSize == MAX) {
+          throw std::runtime_error("AttributeScanner::Selection: too many attributes");
+        }
+        mSlots[type] = ++mSize;
+        mComplete |= id.vendor == 0 ? 1u << mSize : NEVER;
+      }
+    };
+
+  private:
+
+    // Vendor-Id preamble of a Vendor-Specific value
+    static constexpr std::uint8_t VENDOR_ID_SIZE = 4;
+
+    const Selection & mSelection;
+    const std::uint8_t * const mBegin;
+    const std::uint8_t * const mEnd;
+    std::array<Span, Selection::MAX + 1> mSpans{};
+    bool mValid{false};
+
+    /**
+     * Walks the Vendor-Specific attributes of the vendor for the sub-attribute
+     *
+     * A Vendor-Specific attribute with malformed sub-attributes is skipped from there on
+     */
+    Span findVendor(AttributeId id) const {
+      auto slot = mSelection.mSlots[Attribute::VENDOR_SPECIFIC];
+      if (slot == 0 || !mSpans[slot]) {
+        return {};
+      }
+
+      Span found{};
+      for (auto it = mBegin; it < mEnd; it += it[1]) {
+        if (it[0] != Attribute::VENDOR_SPECIFIC || it[1] < Attribute::SIZE + VENDOR_ID_SIZE) {
+          continue;
+        }
+
+        auto vendor = ValueReader::getUnsignedInt(it + Attribute::SIZE, it + it[1]);
+        if (vendor != id.vendor) {
+          continue;
+        }
+
+        auto sub = it + Attribute::SIZE + VENDOR_ID_SIZE;
+        auto subEnd = it + it[1];
+        while (subEnd - sub >= static_cast<std::ptrdiff_t>(Attribute::SIZE)) {
+          std::uint8_t length = sub[1];
+          if (length < Attribute::SIZE || length > subEnd - sub) {
+            break;
+          }
+          if (sub[0] == id.type) {
+            found = {sub + Attribute::SIZE, static_cast<std::uint8_t>(length - Attribute::SIZE)};
+          }
+          sub += length;
+        }
+      }
+      return found;
+    }
+
+  public:
+
+    /**
+     * @param selection the attributes to record
+     * @param begin the first attribute, right after the header
+     * @param end the end of the packet as given by the header length
+     */
+    AttributeScanner(const Selection & selection, const std::uint8_t * begin, const std::uint8_t * end)
+        : mSelection{selection},
+          mBegin{begin},
+          mEnd{end} {
+      auto it = begin;
+      std::uint32_t seen{0};
+      while (end - it >= static_cast<std::ptrdiff_t>(Attribute::SIZE)) {
+        std::uint8_t length = it[1];
+        if (length < Attribute::SIZE || length > end - it) {
+          return;
+        }
+
+        auto slot = selection.mSlots[it[0]];
+        mSpans[slot] = {it + Attribute::SIZE, static_cast<std::uint8_t>(length - Attribute::SIZE)};
+        it += length;
+
+        seen |= 1u << slot;
+        if ((seen & selection.mComplete) == selection.mComplete) {
+          mValid = true;
+          return;
+        }
+      }
+      mValid = it == end;
+    }
+
+    /**
+     * Whether the chain is well formed up to where the scan stopped. Nothing else is meaningful if not
+     */
+    bool valid() const {
+      return mValid;
+    }
+
+    /**
+     * The value of a selected attribute, or an empty span if absent
+     */
+    Span operator[](AttributeId id) const {
+      if (id.vendor != 0) {
+        return findVendor(id);
+      }
+
+      auto slot = mSelection.mSlots[id.type];
+      return slot ? mSpans[slot] : Span{};
+    }
+
+    Span operator[](Attribute::Type type) const {
+      return (*this)[AttributeId{0, static_cast<std::uint8_t>(type)}];
+    }
+  };
+
+}
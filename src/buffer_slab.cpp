@@ -0,0 +1,46 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "buffer_slab.hpp"
+
+#include <stdexcept>
+
+#include <sys/mman.h>
+
+#include "logger.hpp"
+
+BufferSlab::BufferSlab(std::size_t count, std::size_t size)
+    : mCount{count},
+      mSize{size},
+      mStride{(size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE},
+      mMappingSize{(mStride * count + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE} {
+  if (count == 0 || size == 0) {
+    throw std::runtime_error("BufferSlab: count and size must be positive");
+  }
+
+  auto mapping = ::mmap(nullptr, mMappingSize, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+  if (mapping != MAP_FAILED) {
+    mHuge = true;
+  } else {
+    mapping = ::mmap(nullptr, mMappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+      throw std::runtime_error("BufferSlab: could not map buffers");
+    }
+    ::madvise(mapping, mMappingSize, MADV_HUGEPAGE);
+  }
+  mData = static_cast<std::uint8_t *>(mapping);
+
+  LOG(logger::INFO, "BufferSlab: {:d} buffers of {:d} bytes in {:d} bytes of {:s} pages",
+      mCount,
+      mSize,
+      mMappingSize,
+      mHuge ? "huge" : "regular");
+}
+
+BufferSlab::~BufferSlab() {
+  if (mData) {
+    ::munmap(mData, mMappingSize);
+  }
+}
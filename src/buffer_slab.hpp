@@ -0,0 +1,61 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * A fixed set of equally sized packet buffers carved from a single mapping
+ *
+ * The mapping is backed by huge pages when the system has them reserved, and is otherwise
+ * advised for transparent huge pages. Every buffer starts on its own cache line, so buffers
+ * handled by different threads never share one
+ */
+class BufferSlab {
+private:
+
+  static constexpr std::size_t CACHE_LINE = 64;
+  static constexpr std::size_t HUGE_PAGE = 2 * 1024 * 1024;
+
+  const std::size_t mCount;
+  const std::size_t mSize;
+  const std::size_t mStride;
+  std::size_t mMappingSize;
+  std::uint8_t * mData{nullptr};
+  bool mHuge{false};
+
+public:
+
+  /**
+   * @param count number of buffers
+   * @param size usable size of each buffer
+   * @throws runtime_error if the memory cannot be mapped
+   */
+  BufferSlab(std::size_t count, std::size_t size);
+
+  ~BufferSlab();
+  BufferSlab(const BufferSlab &) = delete;
+  void operator=(const BufferSlab &) = delete;
+
+  std::uint8_t * operator[](std::size_t index) const {
+    return mData + index * mStride;
+  }
+
+  std::size_t count() const {
+    return mCount;
+  }
+
+  std::size_t size() const {
+    return mSize;
+  }
+
+  /**
+   * Whether the slab got explicit huge pages
+   */
+  bool huge() const {
+    return mHuge;
+  }
+};
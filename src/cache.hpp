@@ -5,36 +5,95 @@
 #pragma once
 
 #include <string>
-#include <vector>
-
-#include <libmemcached/memcached.hpp>
-#include <fmt/format.h>
+#include <memory>
 
 #include "config.hpp"
+#include "logger.hpp"
+#include "circuit_breaker.hpp"
+#include "cache_backend.hpp"
+#include "memcached_backend.hpp"
+#include "redis_backend.hpp"
 
 class Cache {
 public:
 
-  inline void set(const std::string & key, const std::string & value) {
-    if (!mMemcache.set(key, std::vector<char>{value.cbegin(), value.cend()}, mTTL, 0)) {
+  inline bool set(const std::string & key, const std::string & value) {
+    return set(key, value, mTTL);
+  }
+
+  inline bool set(const std::string & key, const std::string & value, time_t ttl) {
+    if (!mBreaker.allow()) return false;
+
+    if (!mBackend->set(key, value, ttl)) {
       LOG(logger::INFO, "Cache::set: Failed to set {:s}:{:s}", key, value);
+      return fail();
     }
+    return succeed();
   }
 
-  inline void remove(const std::string & key) {
-    if (!mMemcache.remove(key)) {
+  /**
+   * Removing a key that is not in the cache counts as a success
+   */
+  inline bool remove(const std::string & key) {
+    if (!mBreaker.allow()) return false;
+
+    if (!mBackend->remove(key)) {
       LOG(logger::INFO, "Cache::remove: Failed to remove {:s}", key);
+      return fail();
+    }
+    return succeed();
+  }
+
+  /**
+   * Pushes out any requests held back by a pipelined connection
+   */
+  inline bool flush() {
+    if (!mBreaker.allow()) return false;
+
+    if (!mBackend->flush()) {
+      LOG(logger::INFO, "Cache::flush: Failed to flush buffered requests");
+      return fail();
+    }
+    return succeed();
+  }
+
+  /**
+   * Drops any requests held back by a pipelined connection, once they have been saved elsewhere
+   */
+  inline void discard() {
+    mBackend->discard();
+  }
+
+  /**
+   * Opens the connection ahead of the first request
+   */
+  inline bool connect() {
+    if (!mBreaker.allow()) return false;
+
+    if (!mBackend->connect()) {
+      LOG(logger::INFO, "Cache::connect: Failed to connect");
+      return fail();
     }
+    return succeed();
+  }
+
+  /**
+   * Whether the circuit to the cache is closed
+   *
+   * While not healthy, calls fail fast without touching the network
+   */
+  inline bool healthy() const {
+    return mBreaker.healthy();
   }
 
-  explicit Cache(const Config::Cache & config)
-      : mMemcache{fmt::format("--SERVER={:s}:{:d} {:s} {:s} {:s}",
-                              config.host,
-                              config.port,
-                              config.noReply ? "--NOREPLY" : "",
-                              config.useBinary ? "--BINARY-PROTOCOL" : "",
-                              config.tcpKeepAlive ? "--TCP-KEEPALIVE" : "")},
-        mTTL{config.ttl} {
+  /**
+   * @param config the cache configuration
+   * @param pipelined if set, requests are buffered and only sent when the buffer fills up or on `flush`
+   */
+  explicit Cache(const Config::Cache & config, bool pipelined = false)
+      : mBackend{makeBackend(config, pipelined)},
+        mTTL{config.ttl},
+        mBreaker{config.failureThreshold, config.cooldownMillis, config.cooldownMaxMillis} {
   }
 
   /**
@@ -58,6 +117,33 @@ public:
   void operator=(const Cache &) = delete;
 
 private:
-  memcache::Memcache mMemcache;
+  std::unique_ptr<CacheBackend> mBackend;
   time_t mTTL;
+  CircuitBreaker mBreaker;
+
+  inline bool succeed() {
+    if (!mBreaker.healthy()) {
+      LOG(logger::LOG, "Cache: connection recovered. Closing circuit");
+    }
+    mBreaker.success();
+    return true;
+  }
+
+  inline bool fail() {
+    auto wasHealthy = mBreaker.healthy();
+    mBreaker.failure();
+    if (wasHealthy && !mBreaker.healthy()) {
+      LOG(logger::WARN, "Cache: too many failures. Opening circuit");
+    }
+    return false;
+  }
+
+  static std::unique_ptr<CacheBackend> makeBackend(const Config::Cache & config, bool pipelined) {
+    switch (config.backend) {
+      case Config::Cache::REDIS:
+        return std::make_unique<RedisBackend>(config, pipelined);
+      default:
+        return std::make_unique<MemcachedBackend>(config, pipelined);
+    }
+  }
 };
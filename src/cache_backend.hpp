@@ -0,0 +1,45 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <string>
+#include <ctime>
+
+/**
+ * The wire client behind `Cache`
+ *
+ * Implementations only talk to the server and report success. Failure accounting
+ * and the circuit breaker stay in `Cache`, so they behave the same for every backend
+ */
+class CacheBackend {
+public:
+
+  /**
+   * @param ttl seconds to live, or 0 for no expiry
+   */
+  virtual bool set(const std::string & key, const std::string & value, std::time_t ttl) = 0;
+
+  /**
+   * Removing a key that is not in the cache counts as a success
+   */
+  virtual bool remove(const std::string & key) = 0;
+
+  /**
+   * Opens the connection ahead of the first request, if not open yet
+   */
+  virtual bool connect() = 0;
+
+  /**
+   * Pushes out any requests held back by a pipelined connection
+   */
+  virtual bool flush() = 0;
+
+  /**
+   * Drops the requests held back by a pipelined connection, so that they are never sent late
+   */
+  virtual void discard() = 0;
+
+  virtual ~CacheBackend() = default;
+};
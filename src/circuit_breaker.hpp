@@ -0,0 +1,102 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <algorithm>
+
+/**
+ * Health tracking for a single cache connection
+ *
+ * CLOSED: calls go through; consecutive failures are counted
+ * OPEN: calls are refused without touching the network until the cooldown is over
+ * HALF_OPEN: a single probe call goes through; its outcome closes or re-opens the circuit
+ *
+ * Every failed probe doubles the cooldown, up to a maximum, so a cache that stays down
+ * is retried less and less often. Closing the circuit resets the cooldown
+ *
+ * Not thread-safe; each connection is owned by one thread
+ */
+class CircuitBreaker {
+public:
+
+  using Clock = std::chrono::steady_clock;
+
+  enum State {
+    CLOSED,
+    OPEN,
+    HALF_OPEN
+  };
+
+private:
+
+  const unsigned short mFailureThreshold;
+  const Clock::duration mMinCooldown;
+  const Clock::duration mMaxCooldown;
+  Clock::duration mCooldown;
+
+  State mState{CLOSED};
+  unsigned short mFailures{0};
+  Clock::time_point mOpenedAt{};
+
+public:
+
+  /**
+   * @param failureThreshold consecutive failures that open the circuit
+   * @param cooldown time the circuit stays open before a probe
+   * @param maxCooldown limit for the cooldown as probes keep failing
+   */
+  CircuitBreaker(unsigned short failureThreshold,
+                 std::chrono::milliseconds cooldown,
+                 std::chrono::milliseconds maxCooldown = std::chrono::milliseconds{0})
+      : mFailureThreshold{failureThreshold},
+        mMinCooldown{cooldown},
+        mMaxCooldown{std::max(cooldown, maxCooldown)},
+        mCooldown{cooldown} {}
+
+  /**
+   * Whether a call should be attempted now
+   */
+  bool allow(Clock::time_point now = Clock::now()) {
+    switch (mState) {
+      case CLOSED:
+        return true;
+      case OPEN:
+        if (now - mOpenedAt < mCooldown) {
+          return false;
+        }
+        mState = HALF_OPEN;
+        return true;
+      case HALF_OPEN:
+      default:
+        return false;
+    }
+  }
+
+  void success() {
+    mState = CLOSED;
+    mFailures = 0;
+    mCooldown = mMinCooldown;
+  }
+
+  void failure(Clock::time_point now = Clock::now()) {
+    if (mState == HALF_OPEN) {
+      mCooldown = std::min(mCooldown * 2, mMaxCooldown);
+    }
+    if (mState == HALF_OPEN || ++mFailures >= mFailureThreshold) {
+      mState = OPEN;
+      mOpenedAt = now;
+      mFailures = 0;
+    }
+  }
+
+  State state() const {
+    return mState;
+  }
+
+  bool healthy() const {
+    return mState == CLOSED;
+  }
+};
@@ -0,0 +1,181 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "codec.hpp"
+
+namespace {
+
+  template <typename T>
+  void appendBigEndian(std::string & buffer, T value) {
+    for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+      buffer.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+  }
+
+  template <typename T>
+  T readBigEndian(std::string_view buffer) {
+    T value{0};
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+      value = static_cast<T>((value << 8) | static_cast<std::uint8_t>(buffer[i]));
+    }
+    return value;
+  }
+
+  template <std::size_t N>
+  std::string encodeAddressKey(std::string_view prefix, const std::array<std::uint8_t, N> & octets) {
+    std::string key;
+    key.reserve(prefix.size() + N);
+    key.append(prefix);
+    key.append(reinterpret_cast<const char *>(octets.data()), octets.size());
+    return key;
+  }
+
+  template <std::size_t N>
+  std::optional<std::array<std::uint8_t, N>> decodeAddressKey(std::string_view prefix, std::string_view key) {
+    if (key.size() != prefix.size() + N || key.substr(0, prefix.size()) != prefix) {
+      return std::nullopt;
+    }
+
+    std::array<std::uint8_t, N> octets{};
+    for (std::size_t i = 0; i < N; ++i) {
+      octets[i] = static_cast<std::uint8_t>(key[prefix.size() + i]);
+    }
+    return octets;
+  }
+
+  std::string encodeHeader(codec::Format format, std::uint32_t status, std::time_t timestamp, std::size_t payload) {
+    std::string buffer;
+    buffer.reserve(codec::VALUE_HEADER_SIZE + payload);
+    buffer.push_back(static_cast<char>(format));
+    buffer.push_back(static_cast<char>(status));
+    appendBigEndian(buffer, static_cast<std::uint32_t>(timestamp));
+    return buffer;
+  }
+}
+
+std::string codec::encodeKey(std::string_view prefix, const std::array<std::uint8_t, IPV4_SIZE> & octets) {
+  return encodeAddressKey(prefix, octets);
+}
+
+std::optional<std::array<std::uint8_t, codec::IPV4_SIZE>> codec::decodeKey(std::string_view prefix,
+                                                                          std::string_view key) {
+  return decodeAddressKey<IPV4_SIZE>(prefix, key);
+}
+
+std::string codec::encodeKey(std::string_view prefix, const std::array<std::uint8_t, IPV6_SIZE> & octets) {
+  return encodeAddressKey(prefix, octets);
+}
+
+std::optional<std::array<std::uint8_t, codec::IPV6_SIZE>> codec::decodeIpv6Key(std::string_view prefix,
+                                                                              std::string_view key) {
+  return decodeAddressKey<IPV6_SIZE>(prefix, key);
+}
+
+std::string codec::encodeValue(std::uint32_t status, std::time_t timestamp, std::uint64_t subscriberId) {
+  auto buffer = encodeHeader(NUMERIC, status, timestamp, sizeof(subscriberId));
+  appendBigEndian(buffer, subscriberId);
+  return buffer;
+}
+
+std::string codec::encodeValue(std::uint32_t status, std::time_t timestamp, std::string_view userName) {
+  auto buffer = encodeHeader(TEXT, status, timestamp, userName.size());
+  buffer.append(userName);
+  return buffer;
+}
+
+std::string codec::encodeRecordValue(std::uint32_t status, std::time_t timestamp, std::string_view record) {
+  auto buffer = encodeHeader(RECORD, status, timestamp, record.size());
+  buffer.append(record);
+  return buffer;
+}
+
+std::string codec::beginRecord(std::size_t fields, std::size_t reserve) {
+  std::string record;
+  record.reserve(1 + fields + reserve);
+  record.push_back(static_cast<char>(fields));
+  return record;
+}
+
+void codec::appendField(std::string & record, std::optional<std::string_view> field) {
+  if (!field) {
+    record.push_back(static_cast<char>(ABSENT));
+    return;
+  }
+  record.push_back(static_cast<char>(field->size()));
+  record.append(*field);
+}
+
+std::optional<codec::Fields> codec::decodeRecord(std::string_view record) {
+  if (record.empty()) {
+    return std::nullopt;
+  }
+
+  auto count = static_cast<std::uint8_t>(record[0]);
+  Fields fields;
+  fields.reserve(count);
+  std::size_t offset{1};
+  for (std::size_t i = 0; i < count; ++i) {
+    if (offset >= record.size()) {
+      return std::nullopt;
+    }
+
+    auto length = static_cast<std::uint8_t>(record[offset++]);
+    if (length == ABSENT) {
+      fields.emplace_back();
+      continue;
+    }
+    if (length > record.size() - offset) {
+      return std::nullopt;
+    }
+    fields.emplace_back(record.substr(offset, length));
+    offset += length;
+  }
+
+  if (offset != record.size()) {
+    return std::nullopt;
+  }
+  return fields;
+}
+
+std::optional<codec::Session> codec::decodeValue(std::string_view value) {
+  if (value.size() < VALUE_HEADER_SIZE) {
+    return std::nullopt;
+  }
+
+  Session session{static_cast<std::uint8_t>(value[1]),
+                  static_cast<std::time_t>(readBigEndian<std::uint32_t>(value.substr(2))),
+                  std::nullopt,
+                  {},
+                  {}};
+  auto payload = value.substr(VALUE_HEADER_SIZE);
+
+  switch (static_cast<std::uint8_t>(value[0])) {
+    case NUMERIC:
+      if (payload.size() != sizeof(std::uint64_t)) {
+        return std::nullopt;
+      }
+      session.subscriberId = readBigEndian<std::uint64_t>(payload);
+      session.userName = std::to_string(*session.subscriberId);
+      return session;
+    case TEXT:
+      if (payload.empty()) {
+        return std::nullopt;
+      }
+      session.userName = std::string{payload};
+      return session;
+    case RECORD: {
+      auto fields = decodeRecord(payload);
+      if (!fields) {
+        return std::nullopt;
+      }
+      if (!fields->empty() && fields->front()) {
+        session.userName = *fields->front();
+      }
+      session.record = std::string{payload};
+      return session;
+    }
+    default:
+      return std::nullopt;
+  }
+}
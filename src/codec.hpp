@@ -0,0 +1,110 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * Compact binary encoding of cache entries
+ *
+ * Shipped as a standalone library (radius-cacher-codec) with no dependencies besides the
+ * standard library, so that cache consumers can decode entries with the same code that encoded them
+ *
+ * Key: prefix | IPv4 octets (4 bytes, network order)
+ * IPv6 key: prefix | IPv6 prefix octets (16 bytes, network order, bits past the prefix length cleared)
+ * Value: format (uint8) | status (uint8) | timestamp (uint32, big-endian) | payload
+ *   NUMERIC payload: subscriber ID (uint64, big-endian)
+ *   TEXT payload: the raw User-Name, for names that are not numeric
+ *   RECORD payload: a record of several attributes
+ *
+ * Record: field count (uint8) | per field: length (uint8) | raw attribute value
+ *   An attribute missing from the packet has length ABSENT and no value. RADIUS values are
+ *   at most 253 bytes, so ABSENT never clashes with a real length
+ *
+ * Binary keys are not valid in the memcached text protocol, so this requires the binary protocol.
+ * IPv6 keys are always binary, whatever the encoding of the rest
+ */
+namespace codec {
+
+  enum Format : std::uint8_t {
+    NUMERIC = 1,
+    TEXT = 2,
+    RECORD = 3
+  };
+
+  constexpr std::size_t IPV4_SIZE = 4;
+  constexpr std::size_t IPV6_SIZE = 16;
+  constexpr std::size_t VALUE_HEADER_SIZE = 2 + sizeof(std::uint32_t);
+  constexpr std::size_t NUMERIC_VALUE_SIZE = VALUE_HEADER_SIZE + sizeof(std::uint64_t);
+  constexpr std::uint8_t ABSENT = 0xFF;
+
+  /**
+   * The fields of a record, in the order they were projected
+   */
+  using Fields = std::vector<std::optional<std::string>>;
+
+  /**
+   * A decoded cache value
+   */
+  struct Session {
+    std::uint8_t status;
+    std::time_t timestamp;
+    std::optional<std::uint64_t> subscriberId;
+    std::string userName;
+
+    /**
+     * The raw record of a RECORD value, for `decodeRecord`. userName then holds its first field
+     */
+    std::string record;
+  };
+
+  std::string encodeKey(std::string_view prefix, const std::array<std::uint8_t, IPV4_SIZE> & octets);
+
+  /**
+   * @return the IPv4 octets, or nothing if `key` does not belong to `prefix`
+   */
+  std::optional<std::array<std::uint8_t, IPV4_SIZE>> decodeKey(std::string_view prefix, std::string_view key);
+
+  std::string encodeKey(std::string_view prefix, const std::array<std::uint8_t, IPV6_SIZE> & octets);
+
+  /**
+   * @return the IPv6 prefix octets, or nothing if `key` is not an IPv6 key of `prefix`
+   */
+  std::optional<std::array<std::uint8_t, IPV6_SIZE>> decodeIpv6Key(std::string_view prefix, std::string_view key);
+
+  std::string encodeValue(std::uint32_t status, std::time_t timestamp, std::uint64_t subscriberId);
+
+  std::string encodeValue(std::uint32_t status, std::time_t timestamp, std::string_view userName);
+
+  std::string encodeRecordValue(std::uint32_t status, std::time_t timestamp, std::string_view record);
+
+  /**
+   * Starts a record, to be filled with exactly `fields` calls to `appendField`
+   *
+   * @param reserve the expected size of the values, to allocate once
+   */
+  std::string beginRecord(std::size_t fields, std::size_t reserve = 0);
+
+  /**
+   * @param field the raw value, or nothing if the attribute is absent
+   */
+  void appendField(std::string & record, std::optional<std::string_view> field);
+
+  /**
+   * @return the fields, or nothing if `record` is malformed
+   */
+  std::optional<Fields> decodeRecord(std::string_view record);
+
+  /**
+   * @return the decoded session, or nothing if `value` is malformed
+   */
+  std::optional<Session> decodeValue(std::string_view value);
+}
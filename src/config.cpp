@@ -4,35 +4,90 @@
 
 #include "config.hpp"
 
-#include <regex>
-#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <string_view>
 
 #include <mfl/string.hpp>
 
+#include "decimal.hpp"
+#include "dictionary.hpp"
 #include "logger.hpp"
+#include "mapped_file.hpp"
 
 namespace {
 
+  /**
+   * A `KEY = VALUE` line of a configuration file
+   */
+  struct Line {
+    std::string key;
+    std::string value;
+  };
+
+  /**
+   * Keys that can be set to nothing, which turns off what they configure
+   */
+  const std::vector<std::string_view> EMPTIABLE{"SPILL_FILE"};
+
+  bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+  }
+
+  /**
+   * Splits a `KEY = VALUE` line in place, ignoring blanks around both
+   *
+   * @return false if the line assigns nothing to any of the keys, or nothing to one that cannot
+   * be empty
+   */
+  bool tokenize(std::string_view line,
+                const std::vector<std::string_view> & keys,
+                std::string_view & key,
+                std::string_view & value) {
+    std::size_t i{0};
+    while (i < line.size() && isBlank(line[i])) ++i;
+
+    auto keyBegin = i;
+    while (i < line.size() && !isBlank(line[i]) && line[i] != '=') ++i;
+    key = line.substr(keyBegin, i - keyBegin);
+
+    while (i < line.size() && isBlank(line[i])) ++i;
+    if (i == line.size() || line[i] != '=') {
+      return false;
+    }
+    ++i;
+    while (i < line.size() && isBlank(line[i])) ++i;
+
+    auto end = line.size();
+    while (end > i && isBlank(line[end - 1])) --end;
+    value = line.substr(i, end - i);
+
+    if (value.empty() && std::find(EMPTIABLE.begin(), EMPTIABLE.end(), key) == EMPTIABLE.end()) {
+      return false;
+    }
+    return std::find(keys.begin(), keys.end(), key) != keys.end();
+  }
+
   template <typename C>
-  void parse(const std::string & path, const std::regex & regex, C callback) {
-    std::ifstream stream{path};
+  void parse(const std::string & path, const std::vector<std::string_view> & keys, C callback) {
+    MappedFile file{path};
 
-    if (!stream.is_open()) {
+    if (!file.isOpen()) {
       LOG(logger::ERROR, "config::parse: could not load configuration file \"{:s}\"."
                          " Using default configuration", path);
       return;
     }
 
-    std::string buffer;
-
     try {
-      while (std::getline(stream, buffer)) {
-        std::smatch match;
-        if (std::regex_match(buffer, match, regex)) {
-          LOG(logger::INFO, "config::parse: found configuration in file: {:s} = {:s}", match[1], match[2]);
-          callback(match);
+      MappedFile::forEachLine(file.view(), [&](std::string_view text) {
+        std::string_view key;
+        std::string_view value;
+        if (tokenize(text, keys, key, value)) {
+          Line line{std::string{key}, std::string{value}};
+          LOG(logger::INFO, "config::parse: found configuration in file: {:s} = {:s}", line.key, line.value);
+          callback(line);
         }
-      }
+      });
     } catch (const std::exception & ex) {
       LOG(logger::FATAL, "config::parse: configuration file \"{:s}\" is invalid: {}", path, ex.what());
       throw std::runtime_error{ex.what()};
@@ -47,16 +102,28 @@ namespace {
     return static_cast<unsigned short>(asInt);
   }
 
-  auto getShort(const std::smatch & match) {
-    return getShort(match[1], match[2]);
+  auto getShort(const Line & line) {
+    return getShort(line.key, line.value);
+  }
+
+  auto getUnsigned(const std::string & key, const std::string & value) {
+    auto asLong = std::stoll(value);
+    if (asLong < 0 || asLong > 4294967295) {
+      throw std::runtime_error(fmt::format("{:s} should be between 0 and 4294967295", key));
+    }
+    return static_cast<std::uint32_t>(asLong);
+  }
+
+  auto getUnsigned(const Line & line) {
+    return getUnsigned(line.key, line.value);
   }
 
   auto getInt(const std::string & key, const std::string & value) {
     return std::stoi(value);
   }
 
-  auto getInt(const std::smatch & match) {
-    return getInt(match[1], match[2]);
+  auto getInt(const Line & line) {
+    return getInt(line.key, line.value);
   }
 
   auto getString(const std::string & key, const std::string & value) {
@@ -66,8 +133,8 @@ namespace {
     return value;
   }
 
-  auto getString(const std::smatch & match) {
-    return getString(match[1], match[2]);
+  auto getString(const Line & line) {
+    return getString(line.key, line.value);
   }
 
   auto getBool(const std::string & key, const std::string & value) {
@@ -79,18 +146,85 @@ namespace {
     }
   }
 
-  auto getBool(const std::smatch & match) {
-    return getBool(match[1], match[2]);
+  auto getBool(const Line & line) {
+    return getBool(line.key, line.value);
+  }
+
+  auto getLevel(const std::string & key, const std::string & value) {
+    if (!logger::toLevel(value.c_str())) {
+      throw std::runtime_error(fmt::format("{:s} can take NONE, FATAL, ERROR, WARN, LOG, INFO or DEBUG only", key));
+    }
+    return value;
+  }
+
+  auto getLevel(const Line & line) {
+    return getLevel(line.key, line.value);
+  }
+
+  auto getCpuList(const std::string & key, const std::string & value) {
+    auto toCpu = [&key](std::string_view digits) {
+      auto cpu = decimal::parse(reinterpret_cast<const std::uint8_t *>(digits.data()),
+                                reinterpret_cast<const std::uint8_t *>(digits.data() + digits.size()));
+      if (!cpu || *cpu > std::numeric_limits<unsigned int>::max()) {
+        throw std::runtime_error(fmt::format("{:s} should be a list of CPUs and ranges, like 0,2-3", key));
+      }
+      return static_cast<unsigned int>(*cpu);
+    };
+
+    std::vector<unsigned int> cpus;
+    std::string_view list{value};
+    while (!list.empty()) {
+      auto comma = std::min(list.find(','), list.size());
+      auto range = list.substr(0, comma);
+      list.remove_prefix(std::min(comma + 1, list.size()));
+
+      auto dash = range.find('-');
+      auto first = toCpu(range.substr(0, dash));
+      auto last = dash == std::string_view::npos ? first : toCpu(range.substr(dash + 1));
+      if (last < first) {
+        throw std::runtime_error(fmt::format("{:s} has an inverted range {:s}", key, range));
+      }
+      for (auto cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+
+  auto getCpuList(const Line & line) {
+    return getCpuList(line.key, line.value);
+  }
+
+  std::string toString(const std::vector<unsigned int> & cpus) {
+    std::string string;
+    for (auto cpu : cpus) {
+      string += (string.empty() ? "" : ",") + std::to_string(cpu);
+    }
+    return string;
+  }
+
+  auto getBackend(const std::string & key, const std::string & value) {
+    using namespace mfl::string::hash32;
+    switch (hash(value)) {
+      case "MEMCACHED"_h: return Config::Cache::MEMCACHED;
+      case "REDIS"_h: return Config::Cache::REDIS;
+      default: throw std::runtime_error(fmt::format("{:s} can take MEMCACHED or REDIS only", key));
+    }
+  }
+
+  auto getBackend(const Line & line) {
+    return getBackend(line.key, line.value);
   }
 }
 
 Config::Server Config::Server::load(const std::string & path) {
   using namespace mfl::string::hash32;
-  static const std::regex LINE_REGEX{"^[[:space:]]*"
-                                     "(PORT|THREAD_POOL_SIZE|SINGLE_CORE|KEY|VALUE|FILTER_FILE|FILTER_REFRESH_MINUTES)"
-                                     "[[:space:]]*=[[:space:]]*"
-                                     "(.+)"
-                                     "[[:space:]]*$"};
+  static const std::vector<std::string_view> KEYS{
+      "PORT", "THREAD_POOL_SIZE", "SINGLE_CORE", "KEY", "VALUE", "FILTER_FILE", "FILTER_REFRESH_MINUTES",
+      "STATS_INTERVAL_SECONDS", "IO_URING", "BUSY_POLL", "CPU_LIST", "BUSY_POLL_MICROS",
+      "BUSY_POLL_IDLE_MICROS", "BUFFER_COUNT", "BUFFER_SIZE", "RANGE_FILTER_FILE", "UPSTREAMS",
+      "PROXY_SOCKETS", "PROXY_TIMEOUT_MILLIS", "NAS_RATE", "NAS_BURST", "GLOBAL_RATE", "TOP_K",
+      "STATS_SOCKET", "VERBOSE_LEVEL", "HANDOVER_SOCKET", "DRAIN_TIMEOUT_MILLIS"};
 
   unsigned short port{1813};
   unsigned short threadPoolSize{1};
@@ -99,29 +233,110 @@ Config::Server Config::Server::load(const std::string & path) {
   std::string value{"USER_NAME"};
   std::string filterFile{"/etc/radius-cacher/filter.txt"};
   std::chrono::minutes filterRefreshMinutes{12 * 60};
-
-  parse(path, LINE_REGEX, [&](const std::smatch & match) {
-    switch (hash(match[1])) {
+  std::chrono::seconds statsIntervalSeconds{60};
+  bool ioUring{false};
+  bool busyPoll{false};
+  std::vector<unsigned int> cpuList{};
+  std::chrono::microseconds busyPollMicros{50};
+  std::chrono::microseconds busyPollIdleMicros{1000};
+  // Defaults to one more than the threads, once those are known
+  unsigned short bufferCount{0};
+  unsigned short bufferSize{4096};
+  std::string rangeFilterFile{"/etc/radius-cacher/range-filter.txt"};
+  std::string upstreams{};
+  unsigned short proxySockets{4};
+  std::chrono::milliseconds proxyTimeoutMillis{3000};
+  std::uint32_t nasRate{0};
+  std::uint32_t nasBurst{0};
+  std::uint32_t globalRate{0};
+  unsigned short topK{10};
+  std::string statsSocket{};
+  std::string verboseLevel{};
+  std::string handoverSocket{};
+  std::chrono::milliseconds drainTimeoutMillis{5000};
+
+  parse(path, KEYS, [&](const Line & line) {
+    switch (hash(line.key)) {
       case "PORT"_h:
-        port = getShort(match);
+        port = getShort(line);
         break;
       case "THREAD_POOL_SIZE"_h:
-        threadPoolSize = getShort(match);
+        threadPoolSize = getShort(line);
         break;
       case "SINGLE_CORE"_h:
-        singleCore = getBool(match);
+        singleCore = getBool(line);
         break;
       case "KEY"_h:
-        key = getString(match);
+        key = getString(line);
         break;
       case "VALUE"_h:
-        value = getString(match);
+        value = getString(line);
         break;
       case "FILTER_FILE"_h:
-        filterFile = getString(match);
+        filterFile = getString(line);
         break;
       case "FILTER_REFRESH_MINUTES"_h:
-        filterRefreshMinutes = std::chrono::minutes{getShort(match)};
+        filterRefreshMinutes = std::chrono::minutes{getShort(line)};
+        break;
+      case "STATS_INTERVAL_SECONDS"_h:
+        statsIntervalSeconds = std::chrono::seconds{getShort(line)};
+        break;
+      case "IO_URING"_h:
+        ioUring = getBool(line);
+        break;
+      case "BUSY_POLL"_h:
+        busyPoll = getBool(line);
+        break;
+      case "CPU_LIST"_h:
+        cpuList = getCpuList(line);
+        break;
+      case "BUSY_POLL_MICROS"_h:
+        busyPollMicros = std::chrono::microseconds{getShort(line)};
+        break;
+      case "BUSY_POLL_IDLE_MICROS"_h:
+        busyPollIdleMicros = std::chrono::microseconds{getShort(line)};
+        break;
+      case "BUFFER_COUNT"_h:
+        bufferCount = getShort(line);
+        break;
+      case "BUFFER_SIZE"_h:
+        bufferSize = getShort(line);
+        break;
+      case "RANGE_FILTER_FILE"_h:
+        rangeFilterFile = getString(line);
+        break;
+      case "UPSTREAMS"_h:
+        upstreams = getString(line);
+        break;
+      case "PROXY_SOCKETS"_h:
+        proxySockets = getShort(line);
+        break;
+      case "PROXY_TIMEOUT_MILLIS"_h:
+        proxyTimeoutMillis = std::chrono::milliseconds{getShort(line)};
+        break;
+      case "NAS_RATE"_h:
+        nasRate = getUnsigned(line);
+        break;
+      case "NAS_BURST"_h:
+        nasBurst = getUnsigned(line);
+        break;
+      case "GLOBAL_RATE"_h:
+        globalRate = getUnsigned(line);
+        break;
+      case "TOP_K"_h:
+        topK = getShort(line);
+        break;
+      case "STATS_SOCKET"_h:
+        statsSocket = getString(line);
+        break;
+      case "VERBOSE_LEVEL"_h:
+        verboseLevel = getLevel(line);
+        break;
+      case "HANDOVER_SOCKET"_h:
+        handoverSocket = getString(line);
+        break;
+      case "DRAIN_TIMEOUT_MILLIS"_h:
+        drainTimeoutMillis = std::chrono::milliseconds{getShort(line)};
         break;
     }
   });
@@ -148,6 +363,77 @@ Config::Server Config::Server::load(const std::string & path) {
   env = std::getenv("RADIUS_FILTER_REFRESH_MINUTES");
   if (env) filterRefreshMinutes = std::chrono::minutes{getShort("FILTER_REFRESH_MINUTES", env)};
 
+  env = std::getenv("RADIUS_STATS_INTERVAL_SECONDS");
+  if (env) statsIntervalSeconds = std::chrono::seconds{getShort("STATS_INTERVAL_SECONDS", env)};
+
+  env = std::getenv("RADIUS_IO_URING");
+  if (env) ioUring = getBool("IO_URING", env);
+
+  env = std::getenv("RADIUS_BUSY_POLL");
+  if (env) busyPoll = getBool("BUSY_POLL", env);
+
+  env = std::getenv("RADIUS_CPU_LIST");
+  if (env) cpuList = getCpuList("CPU_LIST", env);
+
+  env = std::getenv("RADIUS_BUSY_POLL_MICROS");
+  if (env) busyPollMicros = std::chrono::microseconds{getShort("BUSY_POLL_MICROS", env)};
+
+  env = std::getenv("RADIUS_BUSY_POLL_IDLE_MICROS");
+  if (env) busyPollIdleMicros = std::chrono::microseconds{getShort("BUSY_POLL_IDLE_MICROS", env)};
+
+  env = std::getenv("RADIUS_BUFFER_COUNT");
+  if (env) bufferCount = getShort("BUFFER_COUNT", env);
+
+  env = std::getenv("RADIUS_BUFFER_SIZE");
+  if (env) bufferSize = getShort("BUFFER_SIZE", env);
+
+  env = std::getenv("RADIUS_RANGE_FILTER_FILE");
+  if (env) rangeFilterFile = getString("RANGE_FILTER_FILE", env);
+
+  env = std::getenv("RADIUS_UPSTREAMS");
+  if (env) upstreams = getString("UPSTREAMS", env);
+
+  env = std::getenv("RADIUS_PROXY_SOCKETS");
+  if (env) proxySockets = getShort("PROXY_SOCKETS", env);
+
+  env = std::getenv("RADIUS_PROXY_TIMEOUT_MILLIS");
+  if (env) proxyTimeoutMillis = std::chrono::milliseconds{getShort("PROXY_TIMEOUT_MILLIS", env)};
+
+  env = std::getenv("RADIUS_NAS_RATE");
+  if (env) nasRate = getUnsigned("NAS_RATE", env);
+
+  env = std::getenv("RADIUS_NAS_BURST");
+  if (env) nasBurst = getUnsigned("NAS_BURST", env);
+
+  env = std::getenv("RADIUS_GLOBAL_RATE");
+  if (env) globalRate = getUnsigned("GLOBAL_RATE", env);
+
+  env = std::getenv("RADIUS_TOP_K");
+  if (env) topK = getShort("TOP_K", env);
+
+  env = std::getenv("RADIUS_STATS_SOCKET");
+  if (env) statsSocket = getString("STATS_SOCKET", env);
+
+  env = std::getenv("RADIUS_VERBOSE_LEVEL");
+  if (env) verboseLevel = getLevel("VERBOSE_LEVEL", env);
+
+  env = std::getenv("RADIUS_HANDOVER_SOCKET");
+  if (env) handoverSocket = getString("HANDOVER_SOCKET", env);
+
+  env = std::getenv("RADIUS_DRAIN_TIMEOUT_MILLIS");
+  if (env) drainTimeoutMillis = std::chrono::milliseconds{getShort("DRAIN_TIMEOUT_MILLIS", env)};
+
+  // The multi-core listener arms the next buffer before parsing its own, so with no more buffers
+  // than threads, one still being parsed could be received into. io_uring falls back to it
+  auto multiCore = !singleCore && !busyPoll;
+  if (bufferCount == 0) {
+    bufferCount = static_cast<unsigned short>(std::clamp(threadPoolSize + 1, 16, 65535));
+  }
+  if (multiCore && bufferCount <= threadPoolSize) {
+    throw std::runtime_error(fmt::format("BUFFER_COUNT should be greater than THREAD_POOL_SIZE ({:d})",
+                                         threadPoolSize));
+  }
+
   LOG(logger::LOG,
       "config::Server::load: configuring server with\n"
       "{:s} = {}\n"
@@ -156,6 +442,26 @@ Config::Server Config::Server::load(const std::string & path) {
       "{:s} = {}\n"
       "{:s} = {}\n"
       "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
       "{:s} = {}",
       "PORT", port,
       "THREAD_POOL_SIZE", threadPoolSize,
@@ -163,19 +469,65 @@ Config::Server Config::Server::load(const std::string & path) {
       "KEY", key,
       "VALUE", value,
       "FILTER_FILE", filterFile,
-      "FILTER_REFRESH_MINUTES", filterRefreshMinutes.count()
+      "FILTER_REFRESH_MINUTES", filterRefreshMinutes.count(),
+      "STATS_INTERVAL_SECONDS", statsIntervalSeconds.count(),
+      "IO_URING", ioUring,
+      "BUSY_POLL", busyPoll,
+      "CPU_LIST", toString(cpuList),
+      "BUSY_POLL_MICROS", busyPollMicros.count(),
+      "BUSY_POLL_IDLE_MICROS", busyPollIdleMicros.count(),
+      "BUFFER_COUNT", bufferCount,
+      "BUFFER_SIZE", bufferSize,
+      "RANGE_FILTER_FILE", rangeFilterFile,
+      "UPSTREAMS", upstreams,
+      "PROXY_SOCKETS", proxySockets,
+      "PROXY_TIMEOUT_MILLIS", proxyTimeoutMillis.count(),
+      "NAS_RATE", nasRate,
+      "NAS_BURST", nasBurst,
+      "GLOBAL_RATE", globalRate,
+      "TOP_K", topK,
+      "STATS_SOCKET", statsSocket,
+      "VERBOSE_LEVEL", verboseLevel,
+      "HANDOVER_SOCKET", handoverSocket,
+      "DRAIN_TIMEOUT_MILLIS", drainTimeoutMillis.count()
   );
 
-  return {port, threadPoolSize, singleCore, key, value, filterFile, filterRefreshMinutes};
+  return {port,
+          threadPoolSize,
+          singleCore,
+          key,
+          value,
+          filterFile,
+          filterRefreshMinutes,
+          statsIntervalSeconds,
+          ioUring,
+          busyPoll,
+          cpuList,
+          busyPollMicros,
+          busyPollIdleMicros,
+          bufferCount,
+          bufferSize,
+          rangeFilterFile,
+          upstreams,
+          proxySockets,
+          proxyTimeoutMillis,
+          nasRate,
+          nasBurst,
+          globalRate,
+          topK,
+          statsSocket,
+          verboseLevel,
+          handoverSocket,
+          drainTimeoutMillis};
 }
 
 Config::Cache Config::Cache::load(const std::string & path) {
   using namespace mfl::string::hash32;
-  static const std::regex LINE_REGEX{"^[[:space:]]*"
-                                     "(HOST|PORT|TTL|NO_REPLY|USE_BINARY|TCP_KEEP_ALIVE)"
-                                     "[[:space:]]*=[[:space:]]*"
-                                     "(.+)"
-                                     "[[:space:]]*$"};
+  static const std::vector<std::string_view> KEYS{
+      "HOST", "PORT", "TTL", "NO_REPLY", "USE_BINARY", "TCP_KEEP_ALIVE", "LOCAL_STORE", "EXPIRY_BUDGET",
+      "SNAPSHOT_FILE", "SNAPSHOT_INTERVAL_SECONDS", "SPILL_FILE", "SPILL_SIZE_MEGABYTES", "TIMEOUT_MILLIS",
+      "FAILURE_THRESHOLD", "COOLDOWN_MILLIS", "COMPACT_ENCODING", "KEY_PREFIX", "BACKEND", "POOL_SIZE",
+      "PIPELINE_DEPTH", "COOLDOWN_MAX_MILLIS"};
 
   std::string host{"localhost"};
   unsigned short port{11211};
@@ -183,26 +535,87 @@ Config::Cache Config::Cache::load(const std::string & path) {
   bool noReply{true};
   bool useBinary{true};
   bool tcpKeepAlive{true};
-
-  parse(path, LINE_REGEX, [&](const std::smatch & match) {
-    switch (hash(match[1])) {
+  bool localStore{false};
+  unsigned short expiryBudget{1024};
+  std::string snapshotFile{"/var/lib/radius-cacher/sessions.snapshot"};
+  std::chrono::seconds snapshotIntervalSeconds{60};
+  std::string spillFile{"/var/lib/radius-cacher/spill.journal"};
+  unsigned short spillSizeMegabytes{64};
+  std::chrono::milliseconds timeoutMillis{100};
+  unsigned short failureThreshold{5};
+  std::chrono::milliseconds cooldownMillis{1000};
+  bool compactEncoding{false};
+  std::string keyPrefix{"rc"};
+  Backend backend{MEMCACHED};
+  unsigned short poolSize{1};
+  unsigned short pipelineDepth{1};
+  std::chrono::milliseconds cooldownMaxMillis{30000};
+
+  parse(path, KEYS, [&](const Line & line) {
+    switch (hash(line.key)) {
       case "HOST"_h:
-        host = getString(match);
+        host = getString(line);
         break;
       case "PORT"_h:
-        port = getShort(match);
+        port = getShort(line);
         break;
       case "TTL"_h:
-        ttl = getInt(match);
+        ttl = getInt(line);
         break;
       case "NO_REPLY"_h:
-        noReply = getBool(match);
+        noReply = getBool(line);
         break;
       case "USE_BINARY"_h:
-        useBinary = getBool(match);
+        useBinary = getBool(line);
         break;
       case "TCP_KEEP_ALIVE"_h:
-        tcpKeepAlive = getBool(match);
+        tcpKeepAlive = getBool(line);
+        break;
+      case "LOCAL_STORE"_h:
+        localStore = getBool(line);
+        break;
+      case "EXPIRY_BUDGET"_h:
+        expiryBudget = getShort(line);
+        break;
+      case "SNAPSHOT_FILE"_h:
+        snapshotFile = getString(line);
+        break;
+      case "SNAPSHOT_INTERVAL_SECONDS"_h:
+        snapshotIntervalSeconds = std::chrono::seconds{getShort(line)};
+        break;
+      case "SPILL_FILE"_h:
+        // Empty runs without a journal
+        spillFile = line.value;
+        break;
+      case "SPILL_SIZE_MEGABYTES"_h:
+        spillSizeMegabytes = getShort(line);
+        break;
+      case "TIMEOUT_MILLIS"_h:
+        timeoutMillis = std::chrono::milliseconds{getShort(line)};
+        break;
+      case "FAILURE_THRESHOLD"_h:
+        failureThreshold = getShort(line);
+        break;
+      case "COOLDOWN_MILLIS"_h:
+        cooldownMillis = std::chrono::milliseconds{getShort(line)};
+        break;
+      case "COMPACT_ENCODING"_h:
+        compactEncoding = getBool(line);
+        break;
+      case "KEY_PREFIX"_h:
+        keyPrefix = getString(line);
+        break;
+      case "BACKEND"_h:
+        backend = getBackend(line);
+        break;
+      case "POOL_SIZE"_h:
+        poolSize = getShort(line);
+        break;
+      case "PIPELINE_DEPTH"_h:
+        pipelineDepth = getShort(line);
+        break;
+      case "COOLDOWN_MAX_MILLIS"_h:
+        cooldownMaxMillis = std::chrono::milliseconds{getShort(line)};
         break;
     }
   });
@@ -226,6 +639,56 @@ Config::Cache Config::Cache::load(const std::string & path) {
   env = std::getenv("RADIUS_CACHE_TCP_KEEP_ALIVE");
   if (env) tcpKeepAlive = getBool("TCP_KEEP_ALIVE", env);
 
+  env = std::getenv("RADIUS_CACHE_LOCAL_STORE");
+  if (env) localStore = getBool("LOCAL_STORE", env);
+
+  env = std::getenv("RADIUS_CACHE_EXPIRY_BUDGET");
+  if (env) expiryBudget = getShort("EXPIRY_BUDGET", env);
+
+  env = std::getenv("RADIUS_CACHE_SNAPSHOT_FILE");
+  if (env) snapshotFile = getString("SNAPSHOT_FILE", env);
+
+  env = std::getenv("RADIUS_CACHE_SNAPSHOT_INTERVAL_SECONDS");
+  if (env) snapshotIntervalSeconds = std::chrono::seconds{getShort("SNAPSHOT_INTERVAL_SECONDS", env)};
+
+  env = std::getenv("RADIUS_CACHE_SPILL_FILE");
+  if (env) spillFile = env;
+
+  env = std::getenv("RADIUS_CACHE_SPILL_SIZE_MEGABYTES");
+  if (env) spillSizeMegabytes = getShort("SPILL_SIZE_MEGABYTES", env);
+
+  env = std::getenv("RADIUS_CACHE_TIMEOUT_MILLIS");
+  if (env) timeoutMillis = std::chrono::milliseconds{getShort("TIMEOUT_MILLIS", env)};
+
+  env = std::getenv("RADIUS_CACHE_FAILURE_THRESHOLD");
+  if (env) failureThreshold = getShort("FAILURE_THRESHOLD", env);
+
+  env = std::getenv("RADIUS_CACHE_COOLDOWN_MILLIS");
+  if (env) cooldownMillis = std::chrono::milliseconds{getShort("COOLDOWN_MILLIS", env)};
+
+  env = std::getenv("RADIUS_CACHE_COMPACT_ENCODING");
+  if (env) compactEncoding = getBool("COMPACT_ENCODING", env);
+
+  env = std::getenv("RADIUS_CACHE_KEY_PREFIX");
+  if (env) keyPrefix = getString("KEY_PREFIX", env);
+
+  env = std::getenv("RADIUS_CACHE_BACKEND");
+  if (env) backend = getBackend("BACKEND", env);
+
+  env = std::getenv("RADIUS_CACHE_POOL_SIZE");
+  if (env) poolSize = getShort("POOL_SIZE", env);
+
+  env = std::getenv("RADIUS_CACHE_PIPELINE_DEPTH");
+  if (env) pipelineDepth = getShort("PIPELINE_DEPTH", env);
+
+  env = std::getenv("RADIUS_CACHE_COOLDOWN_MAX_MILLIS");
+  if (env) cooldownMaxMillis = std::chrono::milliseconds{getShort("COOLDOWN_MAX_MILLIS", env)};
+
+  // Binary keys are not valid in the memcached text protocol
+  if (compactEncoding && backend == MEMCACHED && !useBinary) {
+    throw std::runtime_error("COMPACT_ENCODING requires USE_BINARY with MEMCACHED");
+  }
+
   LOG(logger::LOG,
       "config::Server::load: configuring cache with\n"
       "{:s} = {}\n"
@@ -233,13 +696,85 @@ Config::Cache Config::Cache::load(const std::string & path) {
       "{:s} = {}\n"
       "{:s} = {}\n"
       "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
+      "{:s} = {}\n"
       "{:s} = {}",
       "HOST", host,
       "PORT", port,
       "TTL", ttl,
       "NO_REPLY", noReply,
       "USE_BINARY", useBinary,
-      "TCP_KEEP_ALIVE", tcpKeepAlive);
+      "TCP_KEEP_ALIVE", tcpKeepAlive,
+      "LOCAL_STORE", localStore,
+      "EXPIRY_BUDGET", expiryBudget,
+      "SNAPSHOT_FILE", snapshotFile,
+      "SNAPSHOT_INTERVAL_SECONDS", snapshotIntervalSeconds.count(),
+      "SPILL_FILE", spillFile,
+      "SPILL_SIZE_MEGABYTES", spillSizeMegabytes,
+      "TIMEOUT_MILLIS", timeoutMillis.count(),
+      "FAILURE_THRESHOLD", failureThreshold,
+      "COOLDOWN_MILLIS", cooldownMillis.count(),
+      "COMPACT_ENCODING", compactEncoding,
+      "KEY_PREFIX", keyPrefix,
+      "BACKEND", backend == REDIS ? "REDIS" : "MEMCACHED",
+      "POOL_SIZE", poolSize,
+      "PIPELINE_DEPTH", pipelineDepth,
+      "COOLDOWN_MAX_MILLIS", cooldownMaxMillis.count());
+
+  return {host,
+          port,
+          ttl,
+          noReply,
+          useBinary,
+          tcpKeepAlive,
+          localStore,
+          expiryBudget,
+          snapshotFile,
+          snapshotIntervalSeconds,
+          spillFile,
+          spillSizeMegabytes,
+          timeoutMillis,
+          failureThreshold,
+          cooldownMillis,
+          compactEncoding,
+          keyPrefix,
+          backend,
+          poolSize,
+          pipelineDepth,
+          cooldownMaxMillis};
+}
+
+void Config::validate() const {
+  if (cache.backend != Cache::MEMCACHED || cache.useBinary) {
+    return;
+  }
 
-  return {host, port, ttl, noReply, useBinary, tcpKeepAlive};
+  // IPv6 prefix keys are always binary, like compact ones. Names not in the dictionary are left to the parser
+  std::string_view keys{server.key};
+  while (!keys.empty()) {
+    auto comma = std::min(keys.find(','), keys.size());
+    auto name = keys.substr(0, comma);
+    keys.remove_prefix(std::min(comma + 1, keys.size()));
+
+    name.remove_prefix(std::min(name.find_first_not_of(" \t"), name.size()));
+    name.remove_suffix(name.size() - std::min(name.find_last_not_of(" \t") + 1, name.size()));
+
+    auto definition = radius::dictionary::find(name);
+    if (definition && definition->valueType == radius::IPV6_PREFIX) {
+      throw std::runtime_error(fmt::format("KEY {:s} is an IPv6 prefix, which requires USE_BINARY with MEMCACHED", name));
+    }
+  }
 }
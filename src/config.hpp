@@ -5,7 +5,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <chrono>
+#include <cstdint>
 
 struct Config {
   struct Server {
@@ -16,6 +18,26 @@ struct Config {
     const std::string value;
     const std::string filterFile;
     const std::chrono::minutes filterRefreshMinutes;
+    const std::chrono::seconds statsIntervalSeconds;
+    const bool ioUring;
+    const bool busyPoll;
+    const std::vector<unsigned int> cpuList;
+    const std::chrono::microseconds busyPollMicros;
+    const std::chrono::microseconds busyPollIdleMicros;
+    const unsigned short bufferCount;
+    const unsigned short bufferSize;
+    const std::string rangeFilterFile;
+    const std::string upstreams;
+    const unsigned short proxySockets;
+    const std::chrono::milliseconds proxyTimeoutMillis;
+    const std::uint32_t nasRate;
+    const std::uint32_t nasBurst;
+    const std::uint32_t globalRate;
+    const unsigned short topK;
+    const std::string statsSocket;
+    const std::string verboseLevel;
+    const std::string handoverSocket;
+    const std::chrono::milliseconds drainTimeoutMillis;
 
     static Server load(const std::string & path);
 
@@ -25,23 +47,83 @@ struct Config {
            std::string key,
            std::string value,
            std::string filterFile,
-           const std::chrono::minutes filterRefreshMinutes)
+           const std::chrono::minutes filterRefreshMinutes,
+           const std::chrono::seconds statsIntervalSeconds,
+           const bool ioUring,
+           const bool busyPoll,
+           std::vector<unsigned int> cpuList,
+           const std::chrono::microseconds busyPollMicros,
+           const std::chrono::microseconds busyPollIdleMicros,
+           const unsigned short bufferCount,
+           const unsigned short bufferSize,
+           std::string rangeFilterFile,
+           std::string upstreams,
+           const unsigned short proxySockets,
+           const std::chrono::milliseconds proxyTimeoutMillis,
+           const std::uint32_t nasRate,
+           const std::uint32_t nasBurst,
+           const std::uint32_t globalRate,
+           const unsigned short topK,
+           std::string statsSocket,
+           std::string verboseLevel,
+           std::string handoverSocket,
+           const std::chrono::milliseconds drainTimeoutMillis)
         : port{port},
           threadPoolSize{threadPoolSize},
           singleCore{singleCore},
           key{std::move(key)},
           value{std::move(value)},
           filterFile{std::move(filterFile)},
-          filterRefreshMinutes{filterRefreshMinutes} {}
+          filterRefreshMinutes{filterRefreshMinutes},
+          statsIntervalSeconds{statsIntervalSeconds},
+          ioUring{ioUring},
+          busyPoll{busyPoll},
+          cpuList{std::move(cpuList)},
+          busyPollMicros{busyPollMicros},
+          busyPollIdleMicros{busyPollIdleMicros},
+          bufferCount{bufferCount},
+          bufferSize{bufferSize},
+          rangeFilterFile{std::move(rangeFilterFile)},
+          upstreams{std::move(upstreams)},
+          proxySockets{proxySockets},
+          proxyTimeoutMillis{proxyTimeoutMillis},
+          nasRate{nasRate},
+          nasBurst{nasBurst},
+          globalRate{globalRate},
+          topK{topK},
+          statsSocket{std::move(statsSocket)},
+          verboseLevel{std::move(verboseLevel)},
+          handoverSocket{std::move(handoverSocket)},
+          drainTimeoutMillis{drainTimeoutMillis} {}
   };
 
   struct Cache {
+    enum Backend {
+      MEMCACHED,
+      REDIS
+    };
+
     const std::string host;
     const unsigned short port;
     const std::time_t ttl;
     const bool noReply;
     const bool useBinary;
     const bool tcpKeepAlive;
+    const bool localStore;
+    const unsigned short expiryBudget;
+    const std::string snapshotFile;
+    const std::chrono::seconds snapshotIntervalSeconds;
+    const std::string spillFile;
+    const unsigned short spillSizeMegabytes;
+    const std::chrono::milliseconds timeoutMillis;
+    const unsigned short failureThreshold;
+    const std::chrono::milliseconds cooldownMillis;
+    const bool compactEncoding;
+    const std::string keyPrefix;
+    const Backend backend;
+    const unsigned short poolSize;
+    const unsigned short pipelineDepth;
+    const std::chrono::milliseconds cooldownMaxMillis;
 
     static Cache load(const std::string & path);
 
@@ -50,21 +132,63 @@ struct Config {
           const time_t ttl,
           const bool noReply,
           const bool useBinary,
-          const bool tcpKeepAlive)
+          const bool tcpKeepAlive,
+          const bool localStore,
+          const unsigned short expiryBudget,
+          std::string snapshotFile,
+          const std::chrono::seconds snapshotIntervalSeconds,
+          std::string spillFile,
+          const unsigned short spillSizeMegabytes,
+          const std::chrono::milliseconds timeoutMillis,
+          const unsigned short failureThreshold,
+          const std::chrono::milliseconds cooldownMillis,
+          const bool compactEncoding,
+          std::string keyPrefix,
+          const Backend backend,
+          const unsigned short poolSize,
+          const unsigned short pipelineDepth,
+          const std::chrono::milliseconds cooldownMaxMillis)
         : host{std::move(host)},
           port{port},
           ttl{ttl},
           noReply{noReply},
           useBinary{useBinary},
-          tcpKeepAlive{tcpKeepAlive} {}
+          tcpKeepAlive{tcpKeepAlive},
+          localStore{localStore},
+          expiryBudget{expiryBudget},
+          snapshotFile{std::move(snapshotFile)},
+          snapshotIntervalSeconds{snapshotIntervalSeconds},
+          spillFile{std::move(spillFile)},
+          spillSizeMegabytes{spillSizeMegabytes},
+          timeoutMillis{timeoutMillis},
+          failureThreshold{failureThreshold},
+          cooldownMillis{cooldownMillis},
+          compactEncoding{compactEncoding},
+          keyPrefix{std::move(keyPrefix)},
+          backend{backend},
+          poolSize{poolSize},
+          pipelineDepth{pipelineDepth},
+          cooldownMaxMillis{cooldownMaxMillis} {}
 
   };
 
+  /**
+   * @throws runtime_error either configuration is invalid, or the two do not work together
+   */
   Config(const std::string & serverConfigPath, const std::string & cacheConfigPath)
       : server{Server::load(serverConfigPath)},
-        cache{Cache::load(cacheConfigPath)} {}
+        cache{Cache::load(cacheConfigPath)} {
+    validate();
+  }
 
   const Server server;
   const Cache cache;
+
+private:
+
+  /**
+   * Checks the settings that depend on both the server and the cache
+   */
+  void validate() const;
 };
 
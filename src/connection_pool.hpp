@@ -0,0 +1,199 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <functional>
+
+#include "config.hpp"
+#include "logger.hpp"
+#include "cache.hpp"
+#include "spill_journal.hpp"
+
+/**
+ * The cache connections of a single worker thread
+ *
+ * Each worker owns a pool of POOL_SIZE connections, so no two threads ever share one
+ * and no locking is needed around them. Keys are spread over the connections by hash, which
+ * keeps every mutation of a key on the same connection and in order.
+ *
+ * With a PIPELINE_DEPTH above 1 the connections buffer their requests, and the pool pushes
+ * them out once that many are queued or on `flush`, which the workers call whenever their
+ * socket runs dry. A buffered request that fails is only noticed when flushed, so each is kept
+ * until then: if the flush fails, every request queued on that connection is spilled to the
+ * journal and dropped from the connection, never to be sent late.
+ *
+ * Reconnection is left to each connection's circuit breaker, whose cooldown backs off
+ * while the cache stays down
+ */
+class ConnectionPool {
+private:
+
+  /**
+   * A request buffered on a connection, kept to be spilled should its flush fail
+   */
+  struct Queued {
+    SpillJournal::Operation operation;
+    std::string key;
+    std::string value;
+  };
+
+  const unsigned short mDepth;
+  SpillJournal * const mJournal;
+  std::deque<Cache> mConnections{};
+  std::vector<std::vector<Queued>> mQueued;
+  unsigned short mTotalQueued{0};
+
+  std::size_t indexFor(const std::string & key) const {
+    return std::hash<std::string>{}(key) % mConnections.size();
+  }
+
+  /**
+   * Accounts for a request queued on a connection and flushes if the pipeline is full
+   *
+   * A request that fails right away is left to the caller, but whatever was queued before it on
+   * the same connection is spilled
+   */
+  bool queued(std::size_t index, bool result, SpillJournal::Operation operation, const std::string & key, const std::string & value) {
+    if (mDepth == 1) {
+      return result;
+    }
+    if (!result) {
+      spill(index);
+      return false;
+    }
+
+    mQueued[index].push_back({operation, key, value});
+    if (++mTotalQueued >= mDepth) {
+      return flush();
+    }
+    return true;
+  }
+
+  /**
+   * Hands the requests queued on a connection over to the journal, and drops them from the connection
+   */
+  void spill(std::size_t index) {
+    auto & queued = mQueued[index];
+    mConnections[index].discard();
+    if (queued.empty()) {
+      return;
+    }
+
+    if (!mJournal) {
+      LOG(logger::WARN, "ConnectionPool::spill: no journal. Dropping {:d} pipelined requests", queued.size());
+    } else {
+      // A disabled journal counts what it drops, and reports it
+      LOG(logger::INFO, "ConnectionPool::spill: spilling {:d} pipelined requests", queued.size());
+      for (const auto & request : queued) {
+        if (request.operation == SpillJournal::SET) {
+          mJournal->set(request.key, request.value);
+        } else {
+          mJournal->remove(request.key);
+        }
+      }
+    }
+    mTotalQueued = static_cast<unsigned short>(mTotalQueued - queued.size());
+    queued.clear();
+  }
+
+public:
+
+  /**
+   * @param journal where failed pipelined requests are spilled. Must outlive the pool
+   */
+  explicit ConnectionPool(const Config::Cache & config, SpillJournal * journal = nullptr)
+      : mDepth{config.pipelineDepth},
+        mJournal{journal},
+        mQueued(config.poolSize) {
+    for (unsigned short i = 0; i < config.poolSize; ++i) {
+      mConnections.emplace_back(config, mDepth > 1);
+    }
+  }
+
+  bool set(const std::string & key, const std::string & value) {
+    auto index = indexFor(key);
+    return queued(index, mConnections[index].set(key, value), SpillJournal::SET, key, value);
+  }
+
+  bool remove(const std::string & key) {
+    auto index = indexFor(key);
+    return queued(index, mConnections[index].remove(key), SpillJournal::REMOVE, key, {});
+  }
+
+  /**
+   * Pushes out the requests queued on every connection, spilling those of any that fails
+   *
+   * @return false if any connection failed
+   */
+  bool flush() {
+    if (mTotalQueued == 0) {
+      return true;
+    }
+
+    auto result = true;
+    for (std::size_t i = 0; i < mConnections.size(); ++i) {
+      if (mQueued[i].empty()) {
+        continue;
+      }
+      if (mConnections[i].flush()) {
+        mTotalQueued = static_cast<unsigned short>(mTotalQueued - mQueued[i].size());
+        mQueued[i].clear();
+      } else {
+        spill(i);
+        result = false;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Opens every connection ahead of the first packet
+   *
+   * @return false if any connection could not be opened. It is retried on use
+   */
+  bool warmup() {
+    std::size_t connected{0};
+    for (auto & connection : mConnections) {
+      if (connection.connect()) {
+        ++connected;
+      }
+    }
+
+    if (connected < mConnections.size()) {
+      LOG(logger::WARN, "ConnectionPool::warmup: only {:d} of {:d} connections opened",
+          connected,
+          mConnections.size());
+      return false;
+    }
+    LOG(logger::INFO, "ConnectionPool::warmup: {:d} connections opened", connected);
+    return true;
+  }
+
+  /**
+   * Whether every connection has its circuit closed
+   */
+  bool healthy() const {
+    for (const auto & connection : mConnections) {
+      if (!connection.healthy()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::size_t size() const {
+    return mConnections.size();
+  }
+
+  ~ConnectionPool() {
+    flush();
+  }
+
+  ConnectionPool(const ConnectionPool &) = delete;
+  void operator=(const ConnectionPool &) = delete;
+};
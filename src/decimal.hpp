@@ -0,0 +1,105 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <optional>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Parsing of unsigned decimal numbers straight from packet bytes
+ *
+ * Eight digits are validated and converted at a time within a 64-bit word (SWAR), so a typical
+ * subscriber ID costs two or three word operations instead of a digit loop. Nothing is allocated
+ * and anything that is not a plain run of digits is reported instead of thrown
+ */
+namespace decimal {
+
+  /**
+   * The most digits an unsigned 64-bit value can take, not counting leading zeros
+   */
+  constexpr std::ptrdiff_t MAX_DIGITS = 20;
+
+  namespace detail {
+
+    /**
+     * Loads eight characters with the first one in the lowest byte
+     */
+    inline std::uint64_t load(const std::uint8_t * begin) {
+      std::uint64_t chunk;
+      std::memcpy(&chunk, begin, sizeof(chunk));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+      chunk = __builtin_bswap64(chunk);
+#endif
+      return chunk;
+    }
+
+    /**
+     * Whether every byte is within '0' (0x30) and '9' (0x39)
+     *
+     * The high nibble of each byte must be 3, and must stay 3 after adding 6 to the low nibble
+     */
+    inline bool isEightDigits(std::uint64_t chunk) {
+      return ((chunk & 0xF0F0F0F0F0F0F0F0)
+              | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+    }
+
+    /**
+     * Combines eight digits into their value: pairs, then quads, then the whole word
+     */
+    inline std::uint32_t parseEightDigits(std::uint64_t chunk) {
+      chunk = ((chunk & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+      chunk = ((chunk & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+      return static_cast<std::uint32_t>(((chunk & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+    }
+  }
+
+  /**
+   * Parses a run of decimal digits
+   *
+   * Leading zeros are accepted and ignored
+   *
+   * @param begin the first character
+   * @param end past the last character
+   * @return the value, or nothing if empty, not all digits or beyond 64 bits
+   */
+  inline std::optional<std::uint64_t> parse(const std::uint8_t * begin, const std::uint8_t * end) {
+    if (begin == end) {
+      return std::nullopt;
+    }
+
+    while (end - begin > 1 && *begin == '0') {
+      ++begin;
+    }
+    if (end - begin > MAX_DIGITS) {
+      return std::nullopt;
+    }
+
+    // The digits that do not fill a word go first, so the rest is whole words
+    std::uint64_t value{0};
+    for (auto head = (end - begin) % 8; head > 0; --head, ++begin) {
+      unsigned digit = *begin - '0';
+      if (digit > 9) {
+        return std::nullopt;
+      }
+      value = value * 10 + digit;
+    }
+
+    for (; begin < end; begin += 8) {
+      auto chunk = detail::load(begin);
+      if (!detail::isEightDigits(chunk)) {
+        return std::nullopt;
+      }
+
+      // Only 20 digits can overflow
+      if (__builtin_mul_overflow(value, 100000000u, &value)
+          || __builtin_add_overflow(value, detail::parseEightDigits(chunk), &value)) {
+        return std::nullopt;
+      }
+    }
+
+    return value;
+  }
+}
@@ -0,0 +1,81 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <string_view>
+
+#include "radius.hpp"
+#include "dictionary_table.hpp"
+
+/**
+ * Lookups into the attribute dictionary
+ *
+ * The table is generated at build time from dict/dictionary, so the lookups are constexpr
+ * and the attributes the parser depends on are checked at compile time
+ */
+namespace radius::dictionary {
+
+  namespace detail {
+    constexpr char canonical(char c) {
+      return c == '-' ? '_' : (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    /**
+     * Compares a name regardless of case and of dashes against underscores
+     */
+    constexpr bool matches(std::string_view name, const char * entry) {
+      std::size_t i{0};
+      for (; i < name.size(); ++i) {
+        if (entry[i] == '\0' || canonical(name[i]) != entry[i]) {
+          return false;
+        }
+      }
+      return entry[i] == '\0';
+    }
+  }
+
+  /**
+   * Finds an attribute by name, either as in the dictionary (Framed-IP-Address)
+   * or as in the configuration (FRAMED_IP_ADDRESS)
+   *
+   * @return the definition, or nullptr if unknown
+   */
+  constexpr const AttributeDefinition * find(std::string_view name) {
+    for (const auto & entry : ENTRIES) {
+      if (detail::matches(name, entry.name)) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @return the definition, or nullptr if unknown
+   */
+  constexpr const AttributeDefinition * find(AttributeId id) {
+    for (const auto & entry : ENTRIES) {
+      if (entry.id == id) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  constexpr bool defines(std::string_view name, Attribute::Type type, ValueType valueType) {
+    auto entry = find(name);
+    return entry && entry->id == AttributeId{0, static_cast<std::uint8_t>(type)} && entry->valueType == valueType;
+  }
+
+  static_assert(defines("Acct-Status-Type", Attribute::ACCT_STATUS_TYPE, UNSIGNED_INT),
+                "the dictionary must define Acct-Status-Type as integer 40");
+  static_assert(defines("User-Name", Attribute::USER_NAME, STRING),
+                "the dictionary must define User-Name as string 1");
+  static_assert(defines("Framed-IP-Address", Attribute::FRAMED_IP_ADDRESS, ADDRESS),
+                "the dictionary must define Framed-IP-Address as ipaddr 8");
+  static_assert(defines("Framed-IPv6-Prefix", Attribute::FRAMED_IPV6_PREFIX, IPV6_PREFIX),
+                "the dictionary must define Framed-IPv6-Prefix as ipv6prefix 97");
+  static_assert(defines("Delegated-IPv6-Prefix", Attribute::DELEGATED_IPV6_PREFIX, IPV6_PREFIX),
+                "the dictionary must define Delegated-IPv6-Prefix as ipv6prefix 123");
+}
@@ -0,0 +1,86 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <utility>
+#include <ctime>
+
+#include "config.hpp"
+#include "action.hpp"
+#include "codec.hpp"
+
+/**
+ * Turns an action into the key and value sent to the cache
+ *
+ * By default both are the text forms from the packet. With COMPACT_ENCODING, they are
+ * packed with the codec, so everything downstream (cache, local store, spill journal, snapshot)
+ * holds the compact bytes
+ *
+ * A projection of several attributes is sent as its packed record either way, and IPv6
+ * prefixes are always binary keys
+ */
+class Encoder {
+private:
+
+  const bool mCompact;
+  const std::string mPrefix;
+
+  /**
+   * Only names that round-trip through the numeric form can be packed as numbers,
+   * so leading zeros keep the text form
+   */
+  static bool isNumeric(const Action & action) {
+    return action.subscriberId && (action.value->front() != '0' || action.value->size() == 1);
+  }
+
+public:
+
+  explicit Encoder(const Config::Cache & config)
+      : mCompact{config.compactEncoding},
+        mPrefix{config.keyPrefix} {}
+
+  /**
+   * @param action a STORE or REMOVE action with a key
+   */
+  std::string key(const Action & action) const {
+    return mCompact && action.address ? codec::encodeKey(mPrefix, *action.address) : *action.key;
+  }
+
+  /**
+   * IPv6 prefixes are always binary, as their text forms are neither unique nor cheap
+   */
+  std::string key(const std::array<std::uint8_t, codec::IPV6_SIZE> & prefix) const {
+    return codec::encodeKey(mPrefix, prefix);
+  }
+
+  /**
+   * The value is compact only if every key of the action is binary
+   *
+   * @param action a STORE action, with value
+   * @param now the timestamp packed in the compact value
+   */
+  std::string value(const Action & action, std::time_t now = std::time(nullptr)) const {
+    if (!mCompact || (action.key && !action.address)) {
+      return action.record ? *action.record : *action.value;
+    }
+
+    return action.record
+           ? codec::encodeRecordValue(action.status, now, *action.record)
+           : isNumeric(action)
+             ? codec::encodeValue(action.status, now, *action.subscriberId)
+             : codec::encodeValue(action.status, now, *action.value);
+  }
+
+  /**
+   * @param action a STORE or REMOVE action, with key and value
+   * @param now the timestamp packed in the compact value
+   * @return the key and value
+   */
+  std::pair<std::string, std::string> operator()(const Action & action, std::time_t now = std::time(nullptr)) const {
+    return {key(action), value(action, now)};
+  }
+};
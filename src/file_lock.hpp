@@ -0,0 +1,70 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include "logger.hpp"
+
+/**
+ * An exclusive flock(2) on a file, held for as long as the object lives
+ *
+ * Keeps two instances from writing the same file at once, as when a new one takes the sockets
+ * over from a running one: the newcomer waits here until the old one has written its last and
+ * exited. The lock goes with the process, so a crash never leaves it behind
+ */
+class FileLock {
+private:
+
+  int mFile{-1};
+
+public:
+
+  /**
+   * Blocks until the lock is free. Left unlocked if the file cannot be opened, which is logged
+   *
+   * @param path the file to lock, created if needed. Empty locks nothing
+   * @param owner names what is locked in the logs
+   */
+  FileLock(const std::string & path, const char * owner) {
+    if (path.empty()) {
+      return;
+    }
+
+    mFile = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (mFile < 0) {
+      LOG(logger::WARN, "{:s}: could not open \"{:s}\" to lock it: {:s}", owner, path, std::strerror(errno));
+      return;
+    }
+
+    if (::flock(mFile, LOCK_EX | LOCK_NB) == 0) {
+      return;
+    }
+
+    LOG(logger::LOG, "{:s}: \"{:s}\" is held by another instance. Waiting for it to exit", owner, path);
+    while (::flock(mFile, LOCK_EX) != 0) {
+      if (errno != EINTR) {
+        LOG(logger::WARN, "{:s}: could not lock \"{:s}\": {:s}", owner, path, std::strerror(errno));
+        break;
+      }
+    }
+  }
+
+  ~FileLock() {
+    if (mFile >= 0) {
+      ::close(mFile);
+    }
+  }
+
+  FileLock(const FileLock &) = delete;
+  FileLock(FileLock &&) = delete;
+  void operator=(const FileLock &) = delete;
+};
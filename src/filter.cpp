@@ -4,14 +4,48 @@
 
 #include "filter.hpp"
 
-#include <fstream>
-#include <regex>
+#include <algorithm>
+#include <functional>
 #include <thread>
 
+#include "decimal.hpp"
 #include "logger.hpp"
+#include "mapped_file.hpp"
+#include "radix_sort.hpp"
+#include "reload_report.hpp"
 
 namespace {
-  const std::regex REGEX{("([[:digit:]]+)")};
+
+  /**
+   * Below this, a filter file is not worth another thread
+   */
+  constexpr std::size_t MIN_CHUNK = 1 << 20;
+
+  bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  /**
+   * Takes the first run of digits of each line, as the regex it replaces did
+   */
+  void parseChunk(std::string_view chunk, std::vector<std::uint64_t> & values) {
+    MappedFile::forEachLine(chunk, [&values](std::string_view line) {
+      auto begin = std::find_if(line.data(), line.data() + line.size(), isDigit);
+      auto end = std::find_if_not(begin, line.data() + line.size(), isDigit);
+      if (begin == end) {
+        return;
+      }
+
+      auto value = decimal::parse(reinterpret_cast<const std::uint8_t *>(begin),
+                                  reinterpret_cast<const std::uint8_t *>(end));
+      if (value) {
+        values.push_back(*value);
+      } else {
+        LOG(logger::WARN, "Filter::reload: failed to parse value {:s}: out of range",
+            std::string_view{begin, static_cast<std::size_t>(end - begin)});
+      }
+    });
+  }
 }
 
 Filter::Filter(std::string path, std::chrono::seconds refreshSeconds)
@@ -48,40 +82,65 @@ void Filter::reloadLoop() {
 
 void Filter::reload() {
   LOG(logger::INFO, "Filter::reload: reloading");
+  ReloadReport report;
 
-  std::ifstream stream(mFilePath);
+  MappedFile file{mFilePath};
 
-  if (!stream.is_open()) {
+  if (!file.isOpen()) {
     LOG(logger::ERROR, "Filter::reload: could not load filter file \"{:s}\"", mFilePath);
     return;
   }
 
-  auto index = 1 - mCurrent;
-  mFilters[index].clear();
-
-  std::string buffer;
-  try {
-    while (std::getline(stream, buffer)) {
-      std::smatch match;
-      if (std::regex_search(buffer, match, REGEX)) {
-        try {
-          mFilters[index].emplace_back(std::stoull(match[1]));
-        } catch (const std::exception & ex) {
-          LOG(logger::WARN, "Filter::reload: failed to parse value {:s}: {}", match[1], ex.what());
-        }
-      }
-    }
-  } catch (const std::exception & ex) {
-    LOG(logger::WARN, "Filter::reload: exception while reloading filter: {}", ex.what());
+  // The filter before last is not read anymore, and would only add to the peak
+  std::vector<std::uint64_t>{}.swap(mFilters[1 - mCurrent]);
+
+  // Each chunk of whole lines is parsed on a thread of its own, straight off the mapping
+  auto threads = std::max(1u, std::thread::hardware_concurrency());
+  auto chunks = MappedFile::split(file.view(), threads, MIN_CHUNK);
+  std::vector<std::vector<std::uint64_t>> parsed(chunks.size());
+  std::vector<std::thread> parsers;
+  parsers.reserve(chunks.size() - 1);
+  for (std::size_t i = 1; i < chunks.size(); ++i) {
+    parsers.emplace_back(parseChunk, chunks[i], std::ref(parsed[i]));
+  }
+  parseChunk(chunks[0], parsed[0]);
+  for (auto & parser : parsers) {
+    parser.join();
   }
 
-  std::sort(mFilters[index].begin(), mFilters[index].end());
+  std::size_t total{0};
+  std::size_t parsedBytes{0};
+  for (const auto & values : parsed) {
+    total += values.size();
+    parsedBytes += values.capacity() * sizeof(std::uint64_t);
+  }
+  std::vector<std::uint64_t> filter;
+  filter.reserve(total);
+  for (auto & values : parsed) {
+    filter.insert(filter.end(), values.begin(), values.end());
+    std::vector<std::uint64_t>{}.swap(values);
+  }
+  report.lap("parse");
+
+  {
+    std::vector<std::uint64_t> scratch;
+    radix::sort(filter, scratch, threads);
+    filter.erase(std::unique(filter.begin(), filter.end()), filter.end());
+    report.memory(filter.capacity() * sizeof(std::uint64_t),
+                  std::max(parsedBytes, scratch.capacity() * sizeof(std::uint64_t))
+                  + filter.capacity() * sizeof(std::uint64_t));
+  }
+  report.duplicates(total - filter.size());
+  report.lap("sort");
 
+  report.diff(mFilters[mCurrent], filter);
+  report.lap("diff");
+
+  auto index = 1 - mCurrent;
+  mFilters[index] = std::move(filter);
   mCurrent = index;
 
-  LOG(logger::LOG, "Filter::reload: Enabled new filter with {:d} entries", mFilters[index].size());
-  for (const auto value : mFilters[index]) {
-    LOG(logger::INFO, "Filter::reload: Filtering {:d}", value);
-  }
+  LOG(logger::LOG, "Filter::reload: Enabled new filter with {:d} entries: {:s}",
+      mFilters[index].size(),
+      report.record());
 }
-
@@ -0,0 +1,123 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "handover.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "logger.hpp"
+
+namespace {
+  // A stream message needs at least one byte of payload to carry the descriptors
+  constexpr char TAG{'H'};
+}
+
+std::vector<int> Handover::take(const std::string & path) {
+  if (path.empty()) {
+    return {};
+  }
+
+  auto address = UnixListener::toAddress(path, "Handover::take");
+  auto client = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (client < 0) {
+    throw std::runtime_error(fmt::format("Handover::take: could not open socket: {:s}", std::strerror(errno)));
+  }
+
+  if (::connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+    LOG(logger::INFO, "Handover::take: no process to take over from on \"{:s}\": {:s}", path, std::strerror(errno));
+    ::close(client);
+    return {};
+  }
+
+  // The old process answers straight away, unless it is stuck
+  timeval timeout{5, 0};
+  ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  char tag{};
+  iovec payload{&tag, sizeof(tag)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_SOCKETS)];
+  msghdr message{};
+  message.msg_iov = &payload;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  auto bytes = ::recvmsg(client, &message, MSG_CMSG_CLOEXEC);
+  auto error = errno;
+  ::close(client);
+  if (bytes != sizeof(tag) || tag != TAG) {
+    LOG(logger::WARN, "Handover::take: no sockets received from \"{:s}\": {:s}",
+        path,
+        bytes < 0 ? std::strerror(error) : "unexpected message");
+    return {};
+  }
+
+  std::vector<int> sockets;
+  for (auto header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+    if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) {
+      continue;
+    }
+    auto count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    auto data = reinterpret_cast<const int *>(CMSG_DATA(header));
+    sockets.insert(sockets.end(), data, data + count);
+  }
+
+  LOG(logger::LOG, "Handover::take: took over {:d} sockets from \"{:s}\"", sockets.size(), path);
+  return sockets;
+}
+
+Handover::Handover(std::string path, std::vector<int> sockets, std::function<void()> handedOver)
+    : mPath{std::move(path)},
+      mSockets{std::move(sockets)},
+      mHandedOver{std::move(handedOver)} {
+  if (mPath.empty()) {
+    return;
+  }
+
+  if (mSockets.size() > MAX_SOCKETS) {
+    throw std::runtime_error(fmt::format("Handover: at most {:d} sockets can be handed over", MAX_SOCKETS));
+  }
+
+  mListener.emplace(mPath, "Handover", 1, [this](int client) {
+    if (!send(client)) {
+      return true;
+    }
+    LOG(logger::LOG, "Handover: sockets handed over to a new process");
+    mHandedOver();
+    return false;
+  });
+  LOG(logger::LOG, "Handover: handing {:d} sockets over on {:s}", mSockets.size(), mPath);
+}
+
+bool Handover::send(int client) const {
+  char tag{TAG};
+  iovec payload{&tag, sizeof(tag)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_SOCKETS)]{};
+  msghdr message{};
+  message.msg_iov = &payload;
+  message.msg_iovlen = 1;
+  if (!mSockets.empty()) {
+    message.msg_control = control;
+    message.msg_controllen = CMSG_SPACE(sizeof(int) * mSockets.size());
+
+    auto header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int) * mSockets.size());
+    std::memcpy(CMSG_DATA(header), mSockets.data(), sizeof(int) * mSockets.size());
+  }
+
+  if (::sendmsg(client, &message, MSG_NOSIGNAL) != sizeof(tag)) {
+    LOG(logger::WARN, "Handover::send: could not hand the sockets over: {:s}", std::strerror(errno));
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,57 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "unix_listener.hpp"
+
+/**
+ * Hands the bound UDP sockets over to a new process, so that an upgrade loses no datagram
+ *
+ * The running process listens on a Unix socket. A new one started with the same path connects
+ * to it before binding anything, and gets the sockets passed with SCM_RIGHTS. The kernel keeps
+ * queueing datagrams on them all along, and the new process reads from where the old one stopped.
+ * Having handed them over, the old process stops receiving, flushes and exits
+ *
+ * An empty path disables it
+ */
+class Handover {
+private:
+
+  const std::string mPath;
+  const std::vector<int> mSockets;
+  const std::function<void()> mHandedOver;
+  std::optional<UnixListener> mListener;
+
+  bool send(int client) const;
+
+public:
+
+  static constexpr std::size_t MAX_SOCKETS = 64;
+
+  /**
+   * Takes the sockets of the process listening on a path
+   *
+   * @return the sockets, or none if no process is listening
+   */
+  static std::vector<int> take(const std::string & path);
+
+  /**
+   * @param path the Unix socket to listen on
+   * @param sockets the sockets to hand over
+   * @param handedOver called once a new process has taken them
+   * @throws runtime_error if the path cannot be listened on
+   */
+  Handover(std::string path, std::vector<int> sockets, std::function<void()> handedOver);
+  ~Handover() = default;
+
+  Handover(const Handover &) = delete;
+  Handover(Handover &&) = delete;
+  void operator=(const Handover &) = delete;
+};
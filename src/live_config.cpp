@@ -0,0 +1,16 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "live_config.hpp"
+
+#include "logger.hpp"
+
+std::shared_ptr<const Config> LiveConfig::load() const {
+  try {
+    return std::make_shared<const Config>(mServerPath, mCachePath);
+  } catch (const std::exception & ex) {
+    LOG(logger::ERROR, "LiveConfig::load: keeping the current configuration: {:s}", ex.what());
+    return nullptr;
+  }
+}
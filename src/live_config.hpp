@@ -0,0 +1,71 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "config.hpp"
+
+/**
+ * The configuration in effect, as an immutable snapshot that a reload swaps for a new one
+ *
+ * Readers keep the snapshot they hold for as long as they need it, and only go back for the
+ * current one when the generation has moved. Checking it is a single atomic load, so the workers
+ * can do it on every packet without taking a lock
+ */
+class LiveConfig {
+private:
+
+  const std::string mServerPath;
+  const std::string mCachePath;
+  std::shared_ptr<const Config> mConfig;
+  std::atomic<std::uint64_t> mGeneration{0};
+
+public:
+
+  /**
+   * @throws runtime_error invalid configuration
+   */
+  LiveConfig(std::string serverPath, std::string cachePath)
+      : mServerPath{std::move(serverPath)},
+        mCachePath{std::move(cachePath)},
+        mConfig{std::make_shared<const Config>(mServerPath, mCachePath)} {}
+
+  /**
+   * The current snapshot
+   */
+  std::shared_ptr<const Config> get() const {
+    return std::atomic_load(&mConfig);
+  }
+
+  /**
+   * Bumped by every publish
+   */
+  std::uint64_t generation() const {
+    return mGeneration.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Reads the configuration files again, without publishing them
+   *
+   * @return the new snapshot, or nullptr if invalid, in which case the current one stays
+   */
+  std::shared_ptr<const Config> load() const;
+
+  /**
+   * Makes a snapshot the current one
+   */
+  void publish(std::shared_ptr<const Config> config) {
+    std::atomic_store(&mConfig, std::move(config));
+    mGeneration.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  LiveConfig(const LiveConfig &) = delete;
+  LiveConfig(LiveConfig &&) = delete;
+  void operator=(const LiveConfig &) = delete;
+};
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <optional>
 #include <string>
 
 #include <fmt/ostream.h>
@@ -26,34 +28,39 @@ namespace logger {
     DEBUG = 6
   };
 
-  extern Level verboseLevel;
+  /**
+   * Atomic so that a configuration reload can change it under the workers
+   */
+  extern std::atomic<Level> verboseLevel;
 
-  bool inline setVerboseLevel(const char * level) {
+  inline bool enabled(Level level) {
+    return level <= verboseLevel.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @return the level named, or nothing if unknown
+   */
+  inline std::optional<Level> toLevel(const char * level) {
     using namespace mfl::string::hash32;
     switch (hash(level)) {
-      case "NONE"_h:
-        logger::verboseLevel = logger::NONE;
-        return true;
-      case "FATAL"_h:
-        logger::verboseLevel = logger::FATAL;
-        return true;
-      case "ERROR"_h:
-        logger::verboseLevel = logger::ERROR;
-        return true;
-      case "WARN"_h:
-        logger::verboseLevel = logger::WARN;
-        return true;
-      case "LOG"_h:
-        logger::verboseLevel = logger::LOG;
-        return true;
-      case "INFO"_h:
-        logger::verboseLevel = logger::INFO;
-        return true;
-      case "DEBUG"_h:
-        logger::verboseLevel = logger::DEBUG;
-        return true;
-      default: return false;
+      case "NONE"_h: return logger::NONE;
+      case "FATAL"_h: return logger::FATAL;
+      case "ERROR"_h: return logger::ERROR;
+      case "WARN"_h: return logger::WARN;
+      case "LOG"_h: return logger::LOG;
+      case "INFO"_h: return logger::INFO;
+      case "DEBUG"_h: return logger::DEBUG;
+      default: return std::nullopt;
+    }
+  }
+
+  bool inline setVerboseLevel(const char * level) {
+    auto parsed = toLevel(level);
+    if (!parsed) {
+      return false;
     }
+    logger::verboseLevel = *parsed;
+    return true;
   }
 
   constexpr auto FORMAT = "[{:%F %T}] {:s}{:s}\n";
@@ -98,7 +105,7 @@ namespace logger {
 
   template <Level level, typename ... Args>
   inline void println(std::FILE * file, const char * const format, const Args & ... args) {
-    if (level <= verboseLevel) {
+    if (enabled(level)) {
       auto time = std::time(nullptr);
       fmt::print(file, FORMAT, *std::localtime(&time), LogPrepend<level>::PREPEND, fmt::format(format, args...));
     }
@@ -116,7 +123,7 @@ namespace logger {
 
   template <Level level>
   inline void println(std::FILE * file, const std::string & string) {
-    if (level <= verboseLevel) {
+    if (enabled(level)) {
       auto time = std::time(nullptr);
       fmt::print(file, FORMAT, *std::localtime(&time), LogPrepend<level>::PREPEND, string);
     }
@@ -134,7 +141,7 @@ namespace logger {
 
   template <Level level>
   inline void println(std::FILE * file) {
-    if (level <= verboseLevel) {
+    if (enabled(level)) {
       auto time = std::time(nullptr);
       fmt::print(file, FORMAT, *std::localtime(&time), LogPrepend<level>::PREPEND, "");
     }
@@ -150,7 +157,7 @@ namespace logger {
     println<level>(stderr);
   }
 
-#define LOG(level, ...) if (level <= logger::verboseLevel) { \
+#define LOG(level, ...) if (logger::enabled(level)) { \
     if constexpr (level <= logger::WARN && level > 0) { \
       logger::errPrintln<level>(__VA_ARGS__); \
     } else { \
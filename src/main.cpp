@@ -13,7 +13,7 @@
 #include "radius_parser.hpp"
 
 namespace logger {
-  Level verboseLevel = logger::LOG;
+  std::atomic<Level> verboseLevel{logger::LOG};
 }
 
 /**
@@ -41,11 +41,15 @@ void printUsage(std::FILE * file = stdout) {
 }
 
 int main(int argc, char * argv[]) {
+  // Before any thread is started, so that only the signal threads ever take them
+  SignalThread::block({SIGHUP, SIGTERM, SIGINT});
+
   if (mfl::args::findOption(argv, argv + argc, "-h")) {
     printUsage();
     return 0;
   }
 
+  auto levelGiven = false;
   {
     auto aVerboseLevel = mfl::args::extractOption(argv, argv + argc, "-v");
     if (!aVerboseLevel) {
@@ -57,13 +61,10 @@ int main(int argc, char * argv[]) {
         LOG(logger::FATAL, "main: Invalid verbose level set: {:s}", aVerboseLevel);
         return -1;
       }
-    } else {
-      LOG(logger::WARN, "main: No valid verbose level set in parameters or environment variables. Using default: LOG");
+      levelGiven = true;
     }
   }
 
-  LOG(logger::NONE, "main: Usind verbose level {:d}" , logger::verboseLevel);
-
   auto serverConfig = std::string{"/etc/radius-cacher/server.conf"};
   auto cacheConfig = std::string{"/etc/radius-cacher/cache.conf"};
 
@@ -85,11 +86,24 @@ int main(int argc, char * argv[]) {
   }
 
   try {
-    Config config{serverConfig, cacheConfig};
+    LiveConfig live{serverConfig, cacheConfig};
+    auto startup = live.get();
+    const auto & config = *startup;
     LOG(logger::INFO, "main: configuration built");
 
-    RadiusParser parser{config.server.filterFile, config.server.filterRefreshMinutes};
-    Server::run(config, parser);
+    if (!levelGiven && !config.server.verboseLevel.empty()) {
+      logger::setVerboseLevel(config.server.verboseLevel.c_str());
+    } else if (!levelGiven) {
+      LOG(logger::WARN, "main: No valid verbose level set in parameters, environment variables or configuration. Using default: LOG");
+    }
+    LOG(logger::NONE, "main: Usind verbose level {:d}" , static_cast<int>(logger::verboseLevel.load()));
+
+    RadiusParser parser{config.server.filterFile,
+                        config.server.filterRefreshMinutes,
+                        config.server.key,
+                        config.server.value,
+                        config.server.rangeFilterFile};
+    Server::run(live, parser);
 
   } catch (const std::exception & ex) {
     LOG(logger::FATAL, "main: terminating due to exception: {}", ex.what());
@@ -0,0 +1,72 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "mapped_file.hpp"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string & path) {
+  auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0) {
+    return;
+  }
+
+  struct stat status{};
+  if (::fstat(file, &status) != 0) {
+    ::close(file);
+    return;
+  }
+
+  // An empty file cannot be mapped, but reads as an empty text all the same
+  mSize = static_cast<std::size_t>(status.st_size);
+  if (mSize > 0) {
+    auto data = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED) {
+      ::close(file);
+      mSize = 0;
+      return;
+    }
+    ::madvise(data, mSize, MADV_SEQUENTIAL);
+    ::madvise(data, mSize, MADV_WILLNEED);
+    mData = static_cast<const char *>(data);
+  }
+
+  // The mapping holds on to the file by itself
+  ::close(file);
+  mOpen = true;
+}
+
+MappedFile::~MappedFile() {
+  if (mData) {
+    ::munmap(const_cast<char *>(mData), mSize);
+  }
+}
+
+std::vector<std::string_view> MappedFile::split(std::string_view text, std::size_t count, std::size_t minimum) {
+  count = std::max<std::size_t>(1, std::min(count, text.size() / std::max<std::size_t>(1, minimum)));
+
+  std::vector<std::string_view> chunks;
+  chunks.reserve(count);
+
+  std::size_t begin{0};
+  for (std::size_t i = 1; i < count && begin < text.size(); ++i) {
+    // Each cut is moved past the end of the line it falls in
+    auto cut = std::max(begin, text.size() * i / count);
+    auto feed = text.find('\n', cut);
+    if (feed == std::string_view::npos) {
+      break;
+    }
+    chunks.push_back(text.substr(begin, feed + 1 - begin));
+    begin = feed + 1;
+  }
+  if (begin < text.size() || chunks.empty()) {
+    chunks.push_back(text.substr(begin));
+  }
+  return chunks;
+}
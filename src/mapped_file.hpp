@@ -0,0 +1,67 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * A file mapped read-only into memory, to be parsed in place
+ *
+ * Lines are walked with memchr straight over the mapping, so reading a file allocates nothing
+ * however large it is. Files should be replaced by a rename rather than rewritten in place while
+ * mapped, as is already the case for the filter files
+ */
+class MappedFile {
+private:
+
+  const char * mData{nullptr};
+  std::size_t mSize{0};
+  bool mOpen{false};
+
+public:
+
+  explicit MappedFile(const std::string & path);
+  ~MappedFile();
+
+  bool isOpen() const {
+    return mOpen;
+  }
+
+  std::string_view view() const {
+    return {mData, mSize};
+  }
+
+  /**
+   * Calls back with each line of a text, without its line feed
+   *
+   * @tparam F callable taking a std::string_view
+   */
+  template <typename F>
+  static void forEachLine(std::string_view text, F && callback) {
+    auto begin = text.data();
+    auto end = begin + text.size();
+    while (begin < end) {
+      auto feed = static_cast<const char *>(std::memchr(begin, '\n', static_cast<std::size_t>(end - begin)));
+      auto lineEnd = feed ? feed : end;
+      callback(std::string_view{begin, static_cast<std::size_t>(lineEnd - begin)});
+      begin = lineEnd + 1;
+    }
+  }
+
+  /**
+   * Splits a text into chunks of whole lines, for each to be parsed on its own
+   *
+   * @param count how many chunks at most
+   * @param minimum the smallest chunk worth splitting off, in bytes
+   */
+  static std::vector<std::string_view> split(std::string_view text, std::size_t count, std::size_t minimum);
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile(MappedFile &&) = delete;
+  void operator=(const MappedFile &) = delete;
+};
@@ -0,0 +1,81 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <libmemcached/memcached.hpp>
+#include <fmt/format.h>
+
+#include "config.hpp"
+#include "logger.hpp"
+#include "cache_backend.hpp"
+
+class MemcachedBackend : public CacheBackend {
+public:
+
+  bool set(const std::string & key, const std::string & value, std::time_t ttl) override {
+    return mMemcache.set(key, std::vector<char>{value.cbegin(), value.cend()}, ttl, 0);
+  }
+
+  bool remove(const std::string & key) override {
+    auto result = memcached_delete(impl(), key.c_str(), key.size(), 0);
+    return !memcached_failed(result) || result == MEMCACHED_NOTFOUND;
+  }
+
+  /**
+   * libmemcached connects on the first request, so a version round trip opens the connection
+   */
+  bool connect() override {
+    auto result = memcached_version(impl());
+    if (memcached_failed(result)) {
+      LOG(logger::INFO, "MemcachedBackend::connect: {:s}", memcached_strerror(nullptr, result));
+      return false;
+    }
+    return true;
+  }
+
+  bool flush() override {
+    auto result = memcached_flush_buffers(impl());
+    if (memcached_failed(result)) {
+      LOG(logger::INFO, "MemcachedBackend::flush: {:s}", memcached_strerror(nullptr, result));
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Closing the connection is the only way libmemcached has to drop its write buffer
+   */
+  void discard() override {
+    memcached_quit(impl());
+  }
+
+  /**
+   * @param config the cache configuration
+   * @param pipelined if set, requests are buffered and only sent when the buffer fills up or on `flush`
+   */
+  MemcachedBackend(const Config::Cache & config, bool pipelined)
+      : mMemcache{fmt::format("--SERVER={:s}:{:d} --CONNECT-TIMEOUT={:d} --POLL-TIMEOUT={:d} {:s} {:s} {:s} {:s}",
+                              config.host,
+                              config.port,
+                              config.timeoutMillis.count(),
+                              config.timeoutMillis.count(),
+                              config.noReply ? "--NOREPLY" : "",
+                              config.useBinary ? "--BINARY-PROTOCOL" : "",
+                              config.tcpKeepAlive ? "--TCP-KEEPALIVE" : "",
+                              pipelined ? "--BUFFER-REQUESTS" : "")} {}
+
+private:
+  memcache::Memcache mMemcache;
+
+  /**
+   * The C++ wrapper only exposes a const handle, but does not cover every call
+   */
+  memcached_st * impl() {
+    return const_cast<memcached_st *>(mMemcache.getImpl());
+  }
+};
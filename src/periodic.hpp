@@ -0,0 +1,55 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+/**
+ * Runs a task on its own thread at a fixed interval until destroyed
+ *
+ * Destruction wakes the thread up immediately instead of waiting for the next tick
+ */
+class Periodic {
+private:
+
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  bool mStop{false};
+  std::thread mThread;
+
+public:
+
+  /**
+   * @tparam F callable taking no arguments
+   * @param interval time between the end of one run and the start of the next
+   * @param task the task to run
+   */
+  template <typename F>
+  Periodic(std::chrono::milliseconds interval, F task)
+      : mThread{[this, interval, task]() mutable {
+    std::unique_lock<std::mutex> lock{mMutex};
+    while (!mCondition.wait_for(lock, interval, [this]() { return mStop; })) {
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }} {}
+
+  ~Periodic() {
+    {
+      std::unique_lock<std::mutex> lock{mMutex};
+      mStop = true;
+    }
+    mCondition.notify_all();
+    mThread.join();
+  }
+
+  Periodic(const Periodic &) = delete;
+  Periodic(Periodic &&) = delete;
+  void operator=(const Periodic &) = delete;
+};
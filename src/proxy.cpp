@@ -0,0 +1,309 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "proxy.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "logger.hpp"
+#include "radius.hpp"
+
+namespace {
+
+  // Largest RADIUS packet
+  constexpr std::size_t MAX_PACKET = 4096;
+
+  std::string trim(const std::string & string) {
+    auto begin = string.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+      return {};
+    }
+    return string.substr(begin, string.find_last_not_of(" \t") - begin + 1);
+  }
+
+  /**
+   * Resolves `host:port` to an IPv4 address
+   *
+   * @throws runtime_error malformed or unresolvable
+   */
+  sockaddr_in resolve(const std::string & upstream) {
+    auto colon = upstream.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == upstream.size()) {
+      throw std::runtime_error(fmt::format("Proxy: invalid upstream \"{:s}\", expected host:port", upstream));
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo * result{nullptr};
+    auto host = upstream.substr(0, colon);
+    auto port = upstream.substr(colon + 1);
+    auto error = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &result);
+    if (error != 0 || result == nullptr) {
+      throw std::runtime_error(fmt::format("Proxy: could not resolve upstream \"{:s}\": {:s}",
+                                           upstream,
+                                           ::gai_strerror(error)));
+    }
+
+    auto address = *reinterpret_cast<const sockaddr_in *>(result->ai_addr);
+    ::freeaddrinfo(result);
+    return address;
+  }
+
+  bool same(const sockaddr_in & left, const sockaddr_storage & right) {
+    auto & address = reinterpret_cast<const sockaddr_in &>(right);
+    return right.ss_family == AF_INET
+           && address.sin_port == left.sin_port
+           && address.sin_addr.s_addr == left.sin_addr.s_addr;
+  }
+}
+
+Proxy::Proxy(const std::string & upstreams, unsigned short sockets, std::chrono::milliseconds timeout)
+    : mLanes(upstreams.empty() ? 0 : sockets),
+      mTimeout{timeout} {
+  if (upstreams.empty()) {
+    return;
+  }
+
+  std::size_t begin{0};
+  for (;;) {
+    auto end = upstreams.find(',', begin);
+    auto upstream = trim(upstreams.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+    if (upstream.empty()) {
+      throw std::runtime_error(fmt::format("Proxy: empty entry in upstream list \"{:s}\"", upstreams));
+    }
+    if (mUpstreams.size() == MAX_UPSTREAMS) {
+      throw std::runtime_error(fmt::format("Proxy: more than {:d} upstreams", MAX_UPSTREAMS));
+    }
+    mUpstreams.push_back(resolve(upstream));
+    if (end == std::string::npos) {
+      break;
+    }
+    begin = end + 1;
+  }
+
+  auto close = [this]() {
+    for (auto & lane : mLanes) {
+      if (lane.socket >= 0) ::close(lane.socket);
+    }
+    if (mWakeUp >= 0) ::close(mWakeUp);
+  };
+
+  for (auto & lane : mLanes) {
+    lane.socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    sockaddr_in any{};
+    any.sin_family = AF_INET;
+    any.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (lane.socket < 0 || ::bind(lane.socket, reinterpret_cast<sockaddr *>(&any), sizeof(any)) != 0) {
+      close();
+      throw std::runtime_error(fmt::format("Proxy: could not open upstream socket: {:s}", std::strerror(errno)));
+    }
+  }
+
+  mWakeUp = ::eventfd(0, EFD_NONBLOCK);
+  if (mWakeUp < 0) {
+    close();
+    throw std::runtime_error(fmt::format("Proxy: could not open eventfd: {:s}", std::strerror(errno)));
+  }
+
+  LOG(logger::LOG, "Proxy: forwarding to {:d} upstreams through {:d} sockets", mUpstreams.size(), mLanes.size());
+  mRelay = std::thread{&Proxy::relayLoop, this};
+}
+
+Proxy::~Proxy() {
+  if (!enabled()) {
+    return;
+  }
+
+  std::uint64_t one{1};
+  if (::write(mWakeUp, &one, sizeof(one)) < 0) {
+    LOG(logger::WARN, "Proxy::~Proxy: could not wake up the relay: {:s}", std::strerror(errno));
+  }
+  mRelay.join();
+
+  for (auto & lane : mLanes) {
+    ::close(lane.socket);
+  }
+  ::close(mWakeUp);
+}
+
+bool Proxy::take(Lane & lane, std::uint8_t id, int reply, const sockaddr * nas, socklen_t nasSize) {
+  auto now = Clock::now();
+  std::lock_guard<std::mutex> lock{lane.mutex};
+  auto & pending = lane.pending[id];
+
+  // A retransmission keeps its entry, anything else needs a free one
+  if (pending.expiry > now
+      && !(pending.nasSize == nasSize && std::memcmp(&pending.nas, nas, nasSize) == 0)) {
+    return false;
+  }
+
+  std::memcpy(&pending.nas, nas, nasSize);
+  pending.nasSize = nasSize;
+  pending.reply = reply;
+  pending.expiry = now + mTimeout;
+  return true;
+}
+
+bool Proxy::forward(const std::uint8_t * packet,
+                    std::size_t size,
+                    int reply,
+                    const sockaddr * nas,
+                    socklen_t nasSize) {
+  if (size < radius::Header::SIZE || size > MAX_PACKET || nasSize > sizeof(sockaddr_storage)) {
+    mDropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Threads start at different sockets so that they rarely contend for the same table
+  static thread_local const auto first = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  auto id = packet[1];
+  Lane * lane{nullptr};
+  for (std::size_t i = 0; i < mLanes.size() && !lane; ++i) {
+    auto & candidate = mLanes[(first + i) % mLanes.size()];
+    if (take(candidate, id, reply, nas, nasSize)) {
+      lane = &candidate;
+    }
+  }
+
+  if (!lane) {
+    LOG(logger::DEBUG, "Proxy::forward: identifier {:d} in flight on every socket. Dropping", id);
+    mDropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // One message per upstream, all pointing at the same buffer
+  iovec payload{const_cast<std::uint8_t *>(packet), size};
+  std::array<mmsghdr, MAX_UPSTREAMS> messages{};
+  for (std::size_t i = 0; i < mUpstreams.size(); ++i) {
+    messages[i].msg_hdr.msg_name = &mUpstreams[i];
+    messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    messages[i].msg_hdr.msg_iov = &payload;
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  auto sent = ::sendmmsg(lane->socket, messages.data(), static_cast<unsigned>(mUpstreams.size()), 0);
+  if (sent < 1) {
+    LOG(logger::WARN, "Proxy::forward: could not send to the primary upstream: {:s}", std::strerror(errno));
+    std::lock_guard<std::mutex> lock{lane->mutex};
+    lane->pending[id].expiry = {};
+    mDropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // sendmmsg stops at the first mirror that fails, so the ones after it are sent on their own
+  for (auto next = static_cast<std::size_t>(sent); next < mUpstreams.size();) {
+    sent = ::sendmmsg(lane->socket, messages.data() + next, static_cast<unsigned>(mUpstreams.size() - next), 0);
+    if (sent < 1) {
+      LOG(logger::DEBUG, "Proxy::forward: could not send to mirror {:d}: {:s}", next, std::strerror(errno));
+      mMirrorDropped.fetch_add(1, std::memory_order_relaxed);
+      ++next;
+    } else {
+      next += static_cast<std::size_t>(sent);
+    }
+  }
+
+  mForwarded.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void Proxy::relay(Lane & lane) {
+  std::array<std::uint8_t, MAX_PACKET> buffer;
+  for (;;) {
+    sockaddr_storage source{};
+    socklen_t sourceSize{sizeof(source)};
+    auto bytes = ::recvfrom(lane.socket,
+                            buffer.data(),
+                            buffer.size(),
+                            0,
+                            reinterpret_cast<sockaddr *>(&source),
+                            &sourceSize);
+    if (bytes < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        LOG(logger::WARN, "Proxy::relay: error returned when executing receive: ({:d}) {:s}",
+            errno,
+            std::strerror(errno));
+      }
+      return;
+    }
+
+    // Only the primary answers for the upstreams
+    if (static_cast<std::size_t>(bytes) < radius::Header::SIZE
+        || buffer[0] != radius::Header::RESPONSE
+        || !same(mUpstreams.front(), source)) {
+      continue;
+    }
+
+    Pending pending;
+    {
+      std::lock_guard<std::mutex> lock{lane.mutex};
+      auto & entry = lane.pending[buffer[1]];
+      if (entry.expiry <= Clock::now()) {
+        LOG(logger::DEBUG, "Proxy::relay: late response for identifier {:d}. Discarding", buffer[1]);
+        continue;
+      }
+      pending = entry;
+      entry.expiry = {};
+    }
+
+    if (::sendto(pending.reply,
+                 buffer.data(),
+                 static_cast<std::size_t>(bytes),
+                 0,
+                 reinterpret_cast<const sockaddr *>(&pending.nas),
+                 pending.nasSize) < 0) {
+      LOG(logger::WARN, "Proxy::relay: could not relay response: {:s}", std::strerror(errno));
+      continue;
+    }
+    mRelayed.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Proxy::relayLoop() {
+  std::vector<pollfd> ready;
+  ready.reserve(mLanes.size() + 1);
+  for (const auto & lane : mLanes) {
+    ready.push_back({lane.socket, POLLIN, 0});
+  }
+  ready.push_back({mWakeUp, POLLIN, 0});
+
+  for (;;) {
+    if (::poll(ready.data(), ready.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(logger::ERROR, "Proxy::relayLoop: poll failed: {:s}", std::strerror(errno));
+      return;
+    }
+
+    if (ready.back().revents) {
+      return;
+    }
+
+    for (std::size_t i = 0; i < mLanes.size(); ++i) {
+      if (ready[i].revents) {
+        relay(mLanes[i]);
+      }
+    }
+  }
+}
+
+std::string Proxy::report() const {
+  return fmt::format("proxy.forwarded {:d}\nproxy.relayed {:d}\nproxy.dropped {:d}\nproxy.mirror_dropped {:d}\n",
+                     mForwarded.load(std::memory_order_relaxed),
+                     mRelayed.load(std::memory_order_relaxed),
+                     mDropped.load(std::memory_order_relaxed),
+                     mMirrorDropped.load(std::memory_order_relaxed));
+}
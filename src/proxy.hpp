@@ -0,0 +1,115 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/**
+ * Forwards accounting requests to upstream RADIUS servers and relays their responses to the NAS
+ *
+ * Every datagram is sent unchanged, straight from the receive buffer, to all upstreams with a
+ * single sendmmsg. The first upstream is the primary: its Accounting-Responses are relayed back
+ * to the NAS. The others are mirrors, whose responses are read and discarded.
+ *
+ * Since the packet is not altered, its identifier cannot be rewritten without the shared secret.
+ * Instead, requests go out through a small set of sockets, each with a table of the identifiers
+ * it has in flight. A request takes the first socket with its identifier free, so that NASes using
+ * the same identifier at the same time are told apart by the socket the response comes back on.
+ * Entries are freed by the response or once PROXY_TIMEOUT_MILLIS have passed, after which the
+ * NAS will have retransmitted anyway. The upstreams see the cacher as the client, and must share
+ * the secret of the NASes with it
+ */
+class Proxy {
+private:
+
+  // For testing
+  friend class ProxyTester;
+
+  using Clock = std::chrono::steady_clock;
+
+  // RADIUS identifiers are a single octet
+  static constexpr std::size_t IDS = 256;
+  static constexpr std::size_t MAX_UPSTREAMS = 8;
+
+  /**
+   * A request awaiting the response of the primary upstream
+   */
+  struct Pending {
+    sockaddr_storage nas{};
+    socklen_t nasSize{0};
+    int reply{-1};
+    Clock::time_point expiry{};
+  };
+
+  /**
+   * An outbound socket and the identifiers it has in flight
+   */
+  struct Lane {
+    int socket{-1};
+    std::mutex mutex;
+    std::array<Pending, IDS> pending{};
+  };
+
+  std::vector<sockaddr_in> mUpstreams;
+  std::vector<Lane> mLanes;
+  const std::chrono::milliseconds mTimeout;
+  int mWakeUp{-1};
+  std::atomic<std::uint64_t> mForwarded{0};
+  std::atomic<std::uint64_t> mRelayed{0};
+  std::atomic<std::uint64_t> mDropped{0};
+  std::atomic<std::uint64_t> mMirrorDropped{0};
+  std::thread mRelay;
+
+  bool take(Lane & lane, std::uint8_t id, int reply, const sockaddr * nas, socklen_t nasSize);
+  void relay(Lane & lane);
+  void relayLoop();
+
+public:
+
+  /**
+   * @param upstreams comma-separated `host:port` list, the primary first. Empty disables the proxy
+   * @param sockets outbound sockets, each allowing one request in flight per identifier
+   * @param timeout time a request waits for its response before its identifier is reused
+   * @throws runtime_error malformed or unresolvable upstream, or sockets that could not be opened
+   */
+  Proxy(const std::string & upstreams, unsigned short sockets, std::chrono::milliseconds timeout);
+
+  bool enabled() const {
+    return !mUpstreams.empty();
+  }
+
+  /**
+   * Sends a request to every upstream
+   *
+   * @param packet the datagram as received
+   * @param size its size
+   * @param reply the socket it was received on, which the response is sent back from
+   * @param nas the address it came from
+   * @param nasSize the size of the address
+   * @return false if every socket has the identifier in flight, or the send to the primary failed.
+   * Mirrors that could not be sent to are only counted
+   */
+  bool forward(const std::uint8_t * packet, std::size_t size, int reply, const sockaddr * nas, socklen_t nasSize);
+
+  /**
+   * One line per counter, as `<name> <value>`
+   */
+  std::string report() const;
+
+  ~Proxy();
+  Proxy(const Proxy &) = delete;
+  Proxy(Proxy &&) = delete;
+  void operator=(const Proxy &) = delete;
+};
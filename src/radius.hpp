@@ -5,10 +5,11 @@
 #pragma once
 
 #include <array>
+#include <algorithm>
+#include <optional>
 #include <ctime>
 
 #include <fmt/format.h>
-#include <mfl/string.hpp>
 
 /**
  * File based on Radius Accounting specification RFC-2866
@@ -28,13 +29,41 @@ namespace radius {
   };
 
   /**
-   * The four possible value types for AVP as defined in the spec
+   * The four possible value types for AVP as defined in the spec,
+   * plus the opaque and IPv6 ones of later RFCs
    */
   enum ValueType {
     STRING,
     ADDRESS,
     UNSIGNED_INT,
     TIME,
+    OCTETS,
+    IPV6_ADDRESS,
+    IPV6_PREFIX
+  };
+
+  /**
+   * Identifies an attribute, standard or nested in a Vendor-Specific one
+   *
+   * Vendor: the IANA enterprise number, or 0 for the standard attributes
+   * Type: the attribute number within the vendor
+   */
+  struct AttributeId {
+    std::uint32_t vendor;
+    std::uint8_t type;
+
+    constexpr bool operator==(const AttributeId & other) const {
+      return vendor == other.vendor && type == other.type;
+    }
+  };
+
+  /**
+   * An attribute as described by the dictionary
+   */
+  struct AttributeDefinition {
+    const char * name;
+    AttributeId id;
+    ValueType valueType;
   };
 
   /**
@@ -55,7 +84,7 @@ namespace radius {
       std::array<std::uint8_t, 2> length;
       std::array<std::uint8_t, 16> authenticator;
     };
-#pragma pop()
+#pragma pack(pop)
 
     explicit Header(const HeaderRaw * raw)
         : code{raw->code},
@@ -122,7 +151,7 @@ namespace radius {
       std::uint8_t type;
       std::uint8_t length;
     };
-#pragma pop()
+#pragma pack(pop)
 
     explicit Attribute(const AttributeRaw * raw)
         : type{raw->type},
@@ -135,7 +164,10 @@ namespace radius {
       INVALID = -1,
       ACCT_STATUS_TYPE = 40,
       USER_NAME = 1,
-      FRAMED_IP_ADDRESS = 8
+      FRAMED_IP_ADDRESS = 8,
+      VENDOR_SPECIFIC = 26,
+      FRAMED_IPV6_PREFIX = 97,
+      DELEGATED_IPV6_PREFIX = 123
     };
 
     const std::uint8_t type;
@@ -209,6 +241,45 @@ namespace radius {
     }
   };
 
+  /**
+   * An IPv6 prefix as defined in RFC-3162
+   *
+   * Reserved: one octet, ignored
+   * Prefix-Length: the length of the prefix in bits, up to 128
+   * Prefix: only the octets that hold the prefix, up to 16
+   *
+   * The prefix is widened to the full 16 octets with the bits past its length cleared,
+   * so that every announcement of the same prefix reads the same
+   */
+  struct IPv6Prefix {
+    static constexpr std::size_t SIZE = 16;
+    static constexpr std::size_t PREAMBLE_SIZE = 2;
+
+    std::array<std::uint8_t, SIZE> octets;
+    std::uint8_t length;
+
+    /**
+     * @param begin the start of the value
+     * @param end the end of the value
+     * @return the prefix, or nothing if malformed
+     */
+    static std::optional<IPv6Prefix> extract(const std::uint8_t * begin, const std::uint8_t * end) {
+      auto size = end - begin;
+      if (size < static_cast<std::ptrdiff_t>(PREAMBLE_SIZE)
+          || size > static_cast<std::ptrdiff_t>(PREAMBLE_SIZE + SIZE)
+          || begin[1] > SIZE * 8) {
+        return std::nullopt;
+      }
+
+      IPv6Prefix prefix{{}, begin[1]};
+      std::copy(begin + PREAMBLE_SIZE, end, prefix.octets.begin());
+      for (std::size_t bit = prefix.length; bit < SIZE * 8; bit += 8 - bit % 8) {
+        prefix.octets[bit / 8] &= static_cast<std::uint8_t>(0xFF00u >> (bit % 8));
+      }
+      return prefix;
+    }
+  };
+
   /**
    * A reader for all attributes types allowed in the spec
    */
@@ -299,16 +370,5 @@ namespace radius {
     }
   };
 
-  constexpr Attribute::Type mapType(const char * name) {
-    using namespace mfl::string::hash32;
-
-    switch (hash(name)) {
-      case "ACCT_STATUS_TYPE"_h: return Attribute::ACCT_STATUS_TYPE;
-      case "USER_NAME"_h: return Attribute::USER_NAME;
-      case "FRAMED_IP_ADDRESS"_h: return Attribute::FRAMED_IP_ADDRESS;
-      default: return Attribute::INVALID;
-    }
-  }
-
 }
 
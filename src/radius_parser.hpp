@@ -4,12 +4,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <optional>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
 
 #include "action.hpp"
 #include "radius.hpp"
+#include "attribute_scanner.hpp"
+#include "codec.hpp"
+#include "decimal.hpp"
+#include "dictionary.hpp"
 #include "logger.hpp"
 #include "filter.hpp"
+#include "range_filter.hpp"
 
 class RadiusParser {
 private:
@@ -17,15 +28,11 @@ private:
   /**
    * Interpret what kind of Account-Request this packet is to decide the action to be taken
    *
-   * @tparam I the itarator for the buffer
-   * @param begin the start of the buffer
-   * @param end the end of the buffer
+   * @param status the Acct-Status-Type of the packet
    * @return the action to be taken
    */
-  template <typename I>
-  static inline auto extractAction(I begin, I end) {
-    auto type = radius::ValueReader::getUnsignedInt(begin, end);
-    switch (type) {
+  static inline auto extractAction(std::uint32_t status) {
+    switch (status) {
       case radius::START:
       case radius::UPDATE:
         return Action::STORE;
@@ -36,7 +43,166 @@ private:
     }
   }
 
+  /**
+   * Looks up a configured attribute in the dictionary
+   *
+   * @throws runtime_error unknown attribute
+   */
+  static const radius::AttributeDefinition & resolve(const char * option, const std::string & name) {
+    auto definition = radius::dictionary::find(name);
+    if (!definition) {
+      throw std::runtime_error(fmt::format("RadiusParser: {:s} {:s} is not in the dictionary", option, name));
+    }
+    return *definition;
+  }
+
+  /**
+   * Looks up a comma-separated list of attributes, such as "USER_NAME, NAS_IP_ADDRESS"
+   *
+   * @throws runtime_error empty list or unknown attribute
+   */
+  static std::vector<const radius::AttributeDefinition *> resolveAll(const char * option, const std::string & names) {
+    std::vector<const radius::AttributeDefinition *> definitions;
+    std::size_t begin{0};
+    while (begin <= names.size()) {
+      auto end = std::min(names.find(',', begin), names.size());
+      auto first = names.find_first_not_of(" \t", begin);
+      auto last = names.find_last_not_of(" \t", end - 1);
+      if (first >= end || last == std::string::npos || last < first) {
+        throw std::runtime_error(fmt::format("RadiusParser: {:s} has an empty attribute name", option));
+      }
+      definitions.push_back(&resolve(option, names.substr(first, last - first + 1)));
+      begin = end + 1;
+    }
+    return definitions;
+  }
+
+  /**
+   * The key attribute that is not an IPv6 prefix, if any
+   *
+   * @throws runtime_error more than one
+   */
+  static const radius::AttributeDefinition * textKey(const std::vector<const radius::AttributeDefinition *> & keys) {
+    const radius::AttributeDefinition * key{nullptr};
+    for (auto definition : keys) {
+      if (definition->valueType != radius::IPV6_PREFIX) {
+        if (key) {
+          throw std::runtime_error("RadiusParser: KEY takes a single attribute besides the IPv6 prefixes");
+        }
+        key = definition;
+      }
+    }
+    return key;
+  }
+
+  static std::vector<const radius::AttributeDefinition *> prefixKeys(
+      const std::vector<const radius::AttributeDefinition *> & keys) {
+    std::vector<const radius::AttributeDefinition *> prefixes;
+    std::copy_if(keys.begin(), keys.end(), std::back_inserter(prefixes), [](auto definition) {
+      return definition->valueType == radius::IPV6_PREFIX;
+    });
+    return prefixes;
+  }
+
+  static radius::AttributeScanner::Selection select(const std::vector<const radius::AttributeDefinition *> & keys,
+                                                    const std::vector<const radius::AttributeDefinition *> & projection,
+                                                    bool rangeFiltered) {
+    radius::AttributeScanner::Selection selection{radius::AttributeId{0, radius::Attribute::ACCT_STATUS_TYPE}};
+    if (rangeFiltered) {
+      selection.add(radius::AttributeId{0, radius::Attribute::FRAMED_IP_ADDRESS});
+    }
+    for (auto definition : keys) {
+      selection.add(definition->id);
+    }
+    for (auto definition : projection) {
+      selection.add(definition->id);
+    }
+    return selection;
+  }
+
+  /**
+   * Renders an attribute value as text, as sent to the cache
+   *
+   * @return the text, or nothing if the value is malformed for its type
+   */
+  static std::optional<std::string> render(radius::ValueType type, radius::AttributeScanner::Span span) {
+    switch (type) {
+      case radius::STRING:
+        if (span.length == 0) return std::nullopt; // Spec does not allow empty strings
+        return std::string{span.begin, span.end()};
+
+      case radius::ADDRESS:
+        if (span.length != radius::IPv4::SIZE) return std::nullopt;
+        return radius::ValueReader::getAddress(span.begin, span.end()).ip;
+
+      case radius::UNSIGNED_INT:
+      case radius::TIME:
+        if (span.length != sizeof(std::uint32_t)) return std::nullopt;
+        return std::to_string(radius::ValueReader::getUnsignedInt(span.begin, span.end()));
+
+      case radius::IPV6_ADDRESS: {
+        if (span.length != radius::IPv6Prefix::SIZE) return std::nullopt;
+        std::array<char, INET6_ADDRSTRLEN> text{};
+        ::inet_ntop(AF_INET6, span.begin, text.data(), text.size());
+        return std::string{text.data()};
+      }
+
+      case radius::IPV6_PREFIX: {
+        auto prefix = radius::IPv6Prefix::extract(span.begin, span.end());
+        if (!prefix) return std::nullopt;
+        std::array<char, INET6_ADDRSTRLEN> text{};
+        ::inet_ntop(AF_INET6, prefix->octets.data(), text.data(), text.size());
+        return fmt::format("{:s}/{:d}", text.data(), prefix->length);
+      }
+
+      case radius::OCTETS:
+      default: {
+        static constexpr char DIGITS[] = "0123456789abcdef";
+        std::string hex(span.length * 2u, '0');
+        for (std::size_t i = 0; i < span.length; ++i) {
+          hex[2 * i] = DIGITS[span.begin[i] >> 4u];
+          hex[2 * i + 1] = DIGITS[span.begin[i] & 0x0Fu];
+        }
+        return hex;
+      }
+    }
+  }
+
   const Filter mFilter;
+  const RangeFilter mRangeFilter;
+  const radius::AttributeDefinition * const mKey;
+  const std::vector<const radius::AttributeDefinition *> mPrefixKeys;
+  const std::vector<const radius::AttributeDefinition *> mProjection;
+  const radius::AttributeDefinition & mValue;
+  const radius::AttributeScanner::Selection mSelection;
+
+  /**
+   * Packs the raw values of every projected attribute, in order, absent ones included
+   */
+  std::string project(const radius::AttributeScanner & attributes) const {
+    auto record = codec::beginRecord(mProjection.size(), mProjection.size() * 16);
+    for (auto definition : mProjection) {
+      auto span = attributes[definition->id];
+      codec::appendField(record, span
+                                 ? std::make_optional(std::string_view{reinterpret_cast<const char *>(span.begin),
+                                                                       span.length})
+                                 : std::nullopt);
+    }
+    return record;
+  }
+
+  RadiusParser(std::string filterFilePath,
+               std::chrono::minutes refreshMinutes,
+               const std::vector<const radius::AttributeDefinition *> & keys,
+               std::vector<const radius::AttributeDefinition *> && projection,
+               std::string rangeFilterFilePath)
+      : mFilter{std::move(filterFilePath), refreshMinutes},
+        mRangeFilter{std::move(rangeFilterFilePath), refreshMinutes},
+        mKey{textKey(keys)},
+        mPrefixKeys{prefixKeys(keys)},
+        mProjection{std::move(projection)},
+        mValue{*mProjection.front()},
+        mSelection{select(keys, mProjection, mRangeFilter.enabled())} {}
 
 public:
 
@@ -45,9 +211,25 @@ public:
    *
    * The parser must be built with the filter to avoid processing of packets before
    * the filter is ready
+   *
+   * @param key the dictionary names of the attributes used as cache keys, comma-separated: at most
+   * one of any type, plus IPv6 prefixes, which are written as keys of their own
+   * @param value the dictionary names of the attributes projected into the cache value, comma-separated.
+   * The first one is the value proper, which is filtered on and logged. With more than one, the cache
+   * gets a record of all of them instead (see codec)
+   * @param rangeFilterFilePath the IPv4 ranges to filter on the Framed-IP-Address, or empty for none
+   * @throws runtime_error key or value not in the dictionary, or too many attributes
    */
-  RadiusParser(std::string filterFilePath, std::chrono::minutes refreshMinutes)
-      : mFilter{std::move(filterFilePath), refreshMinutes} {}
+  RadiusParser(std::string filterFilePath,
+               std::chrono::minutes refreshMinutes,
+               const std::string & key = "FRAMED_IP_ADDRESS",
+               const std::string & value = "USER_NAME",
+               std::string rangeFilterFilePath = "")
+      : RadiusParser{std::move(filterFilePath),
+                     refreshMinutes,
+                     resolveAll("KEY", key),
+                     resolveAll("VALUE", value),
+                     std::move(rangeFilterFilePath)} {}
 
   ~RadiusParser() = default;
   RadiusParser(const RadiusParser &) = delete;
@@ -73,7 +255,6 @@ public:
     if (header.code != radius::Header::REQUEST) return {}; // Type is not a request
     if (header.length < 20 || header.length > bytesReceived || header.length > 4095) return {}; // Invalid as per spec
 
-    auto packetEnd = begin + header.length;
     LOG(logger::DEBUG,
         "\n"
         "Header--\n"
@@ -83,86 +264,110 @@ public:
         header.code,
         header.id,
         header.length);
-    begin += radius::Header::SIZE;
+
+    if (header.length > std::distance(begin, end)) {
+      LOG(logger::INFO, "Packet truncated by the buffer. Discarding packet");
+      return {};
+    }
+
+    // Validate the chain and locate the attributes of interest in one pass, up to the last of them
+    auto packet = &*begin;
+    radius::AttributeScanner attributes{mSelection, packet + radius::Header::SIZE, packet + header.length};
+
+    if (!attributes.valid()) {
+      LOG(logger::INFO, "Invalid attribute chain found. Discarding packet");
+      return {};
+    }
 
     // Prepare the cache action and data
     auto action = Action::DO_NOTHING;
+    std::uint32_t status{0};
     std::optional<std::string> key;
     std::optional<std::string> value;
+    std::optional<std::array<std::uint8_t, 4>> address;
+    std::optional<std::uint64_t> subscriberId;
 
-    // Slide through the attributes
-    LOG(logger::DEBUG, "Start attribute iteration");
-    while (begin < end && begin < packetEnd) {
-      auto attribute = radius::Attribute::extract(begin, end);
-
-      if (attribute.length < 2) {
-        LOG(logger::INFO, "Invalid attribute size found. Discarding packet");
+    if (auto span = attributes[radius::Attribute::ACCT_STATUS_TYPE]) {
+      if (span.length != sizeof(std::uint32_t)) {
+        LOG(logger::INFO, "Invalid Acct-Status-Type size found. Discarding packet");
         return {};
       }
 
-      auto valueBegin = begin + radius::Attribute::SIZE;
-
-      if (attribute.length > radius::Attribute::SIZE) {
-        LOG(logger::DEBUG,
-            "\n"
-            "Attribute--\n"
-            ":: Type:   {:d}\n"
-            ":: Length: {:d}\n"
-            ":: Value:  {:s}",
-            attribute.type,
-            attribute.length,
-            radius::ValueReader::getString(valueBegin, end, begin + attribute.length));
-      } else {
-        LOG(logger::DEBUG,
-            "\n"
-            "Attribute--\n"
-            ":: Type:   {:d}\n"
-            ":: Length: {:d}",
-            attribute.type,
-            attribute.length);
+      status = radius::ValueReader::getUnsignedInt(span.begin, span.end());
+      if ((action = extractAction(status)) == Action::DO_NOTHING) {
+        LOG(logger::INFO, "Got action DO_NOTHING. Breaking away");
+        return {}; // Free the buffer stack and callback ASAP
       }
 
-      switch (attribute.type) {
-
-        case radius::Attribute::ACCT_STATUS_TYPE:
-          if ((action = extractAction(valueBegin, end)) == Action::DO_NOTHING) {
-            LOG(logger::INFO, "Got action DO_NOTHING. Breaking away");
-            return {}; // Free the buffer stack and callback ASAP
-          }
+      LOG(logger::DEBUG, "Got action {:s}", action == Action::STORE ? "STORE" : "REMOVE");
+    }
 
-          LOG(logger::DEBUG, "Got action {:s}", action == Action::STORE ? "STORE" : "REMOVE");
-          break;
+    if (auto span = attributes[mValue.id]) {
+      value = render(mValue.valueType, span);
+      if (!value) {
+        LOG(logger::INFO, "Invalid {:s} found. Discarding packet", mValue.name);
+        return {};
+      }
 
-        case radius::Attribute::FRAMED_IP_ADDRESS:
-          key = std::make_optional(radius::ValueReader::getAddress(valueBegin, end).ip);
+      // Non-numeric values are kept as they are, and cannot be filtered
+      subscriberId = mValue.valueType == radius::UNSIGNED_INT
+                     ? std::make_optional<std::uint64_t>(radius::ValueReader::getUnsignedInt(span.begin, span.end()))
+                     : decimal::parse(span.begin, span.end());
 
-          LOG(logger::DEBUG, "Key = {:s}", *key);
-          break;
+      if (subscriberId && mFilter.contains(*subscriberId)) {
+        // User opted-out; Free the buffer stack and callback ASAP
+        return {Action::FILTER, std::move(key), std::move(value), status, address, subscriberId};
+      }
 
-        case radius::Attribute::USER_NAME:
-          value = std::make_optional(radius::ValueReader::getString(valueBegin, end, begin + attribute.length));
+      LOG(logger::DEBUG, "Value = {:s}", *value);
+    }
 
-          if (mFilter.contains(std::stoull(*value))) {
-            // User opted-out; Free the buffer stack and callback ASAP
-            return {Action::FILTER, std::move(key), std::move(value)};
-          }
+    if (auto span = mKey ? attributes[mKey->id] : radius::AttributeScanner::Span{}) {
+      key = render(mKey->valueType, span);
+      if (!key) {
+        LOG(logger::INFO, "Invalid {:s} found. Discarding packet", mKey->name);
+        return {};
+      }
 
-          LOG(logger::DEBUG, "Value = {:s}", *value);
-          break;
+      // Keeps the raw address for the compact encoding
+      if (mKey->valueType == radius::ADDRESS) {
+        address.emplace();
+        std::copy(span.begin, span.end(), address->begin());
       }
 
-      if (key && value && action != Action::DO_NOTHING) {
-        LOG(logger::DEBUG, "Got all fields. Breaking loop");
-        break; // Break the loop ASAP
+      LOG(logger::DEBUG, "Key = {:s}", *key);
+    }
+
+    // IPv6 prefixes stay binary, so they are never rendered
+    std::vector<std::array<std::uint8_t, radius::IPv6Prefix::SIZE>> prefixes;
+    for (auto definition : mPrefixKeys) {
+      if (auto span = attributes[definition->id]) {
+        auto prefix = radius::IPv6Prefix::extract(span.begin, span.end());
+        if (!prefix) {
+          LOG(logger::INFO, "Invalid {:s} found. Discarding packet", definition->name);
+          return {};
+        }
+        prefixes.push_back(prefix->octets);
       }
-      begin += attribute.length;
     }
 
-    if (!key || !value) {
+    if ((!key && prefixes.empty()) || !value) {
       LOG(logger::INFO, "Missing fields. Breaking away");
       return {}; // Free the buffer stack and callback ASAP
     }
 
-    return {action, std::move(key), std::move(value)};
+    // Ranges are on the Framed-IP-Address whatever the key, and a malformed one matches none
+    auto framed = attributes[radius::Attribute::FRAMED_IP_ADDRESS];
+    if (mRangeFilter.enabled() && framed.length == radius::IPv4::SIZE
+        && mRangeFilter.contains({framed.begin[0], framed.begin[1], framed.begin[2], framed.begin[3]})) {
+      // Address in a filtered range; Free the buffer stack and callback ASAP
+      return {Action::FILTER, std::move(key), std::move(value), status, address, subscriberId};
+    }
+
+    std::optional<std::string> record;
+    if (mProjection.size() > 1) {
+      record = project(attributes);
+    }
+    return {action, std::move(key), std::move(value), status, address, subscriberId, std::move(record), std::move(prefixes)};
   }
 };
@@ -0,0 +1,117 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace radix {
+
+  namespace detail {
+    /**
+     * Six passes over 64 bits rather than eight with bytes, the last one nine bits wide
+     */
+    constexpr unsigned int BITS = 11;
+    constexpr std::size_t BUCKETS = 1u << BITS;
+
+    /**
+     * Below this, std::sort wins over six passes through memory
+     */
+    constexpr std::size_t MIN_SIZE = 1 << 16;
+
+    /**
+     * Below this per thread, a thread costs more than it saves
+     */
+    constexpr std::size_t MIN_SLICE = 1 << 18;
+
+    /**
+     * Runs `task(slice)` for every slice, the first on the calling thread
+     */
+    template <typename F>
+    void parallel(std::size_t slices, F && task) {
+      std::vector<std::thread> threads;
+      threads.reserve(slices - 1);
+      for (std::size_t slice = 1; slice < slices; ++slice) {
+        threads.emplace_back(task, slice);
+      }
+      task(0);
+      for (auto & thread : threads) {
+        thread.join();
+      }
+    }
+  }
+
+  /**
+   * Sorts 64-bit values least significant digit first, BITS at a time, each pass split across threads
+   *
+   * Each thread counts the digits of its slice, then scatters the slice to where the counts of
+   * all the slices before it say, which keeps every pass stable. A digit that all values share is
+   * skipped, which for identifiers of one magnitude is usually the top one or two
+   *
+   * @param scratch the other buffer of each pass, resized to match
+   * @param threads how many threads at most
+   */
+  inline void sort(std::vector<std::uint64_t> & values, std::vector<std::uint64_t> & scratch, std::size_t threads) {
+    using namespace detail;
+
+    const auto size = values.size();
+    if (size < MIN_SIZE) {
+      std::sort(values.begin(), values.end());
+      return;
+    }
+
+    threads = std::max<std::size_t>(1, std::min(threads, size / MIN_SLICE));
+    scratch.resize(size);
+
+    auto from = values.data();
+    auto to = scratch.data();
+    auto first = [size, threads](std::size_t slice) {
+      return size * slice / threads;
+    };
+    std::vector<std::array<std::size_t, BUCKETS>> counts(threads);
+
+    for (unsigned int shift = 0; shift < 64; shift += BITS) {
+      parallel(threads, [&, shift](std::size_t slice) {
+        auto & count = counts[slice];
+        count.fill(0);
+        for (auto i = first(slice), last = first(slice + 1); i < last; ++i) {
+          ++count[(from[i] >> shift) & (BUCKETS - 1)];
+        }
+      });
+
+      // Buckets in order, and slices in order within each, turning counts into offsets
+      bool shared{false};
+      std::size_t offset{0};
+      for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+        auto begin = offset;
+        for (auto & count : counts) {
+          auto n = count[bucket];
+          count[bucket] = offset;
+          offset += n;
+        }
+        shared |= offset - begin == size;
+      }
+      if (shared) {
+        continue;
+      }
+
+      parallel(threads, [&, shift](std::size_t slice) {
+        auto & next = counts[slice];
+        for (auto i = first(slice), last = first(slice + 1); i < last; ++i) {
+          auto value = from[i];
+          to[next[(value >> shift) & (BUCKETS - 1)]++] = value;
+        }
+      });
+      std::swap(from, to);
+    }
+
+    if (from != values.data()) {
+      values.swap(scratch);
+    }
+  }
+}
@@ -0,0 +1,199 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "range_filter.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <thread>
+
+#include <arpa/inet.h>
+
+#include "logger.hpp"
+
+namespace {
+
+  constexpr std::size_t BLOCKS = 1u << 24u;
+
+  struct Prefix {
+    std::uint32_t address;
+    std::uint8_t length;
+    bool filtered;
+  };
+
+  /**
+   * Parses `[!]a.b.c.d[/length]`, ignoring surrounding blanks
+   *
+   * @return the prefix, or nothing if the line is empty, a comment or malformed
+   */
+  std::optional<Prefix> parse(const std::string & line, bool & malformed) {
+    malformed = false;
+    auto begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string::npos || line[begin] == '#') {
+      return std::nullopt;
+    }
+    auto end = line.find_last_not_of(" \t\r") + 1;
+
+    Prefix prefix{0, 32, true};
+    if (line[begin] == '!') {
+      prefix.filtered = false;
+      ++begin;
+    }
+
+    auto slash = line.find('/', begin);
+    auto addressEnd = std::min(slash, end);
+    if (slash != std::string::npos && slash < end) {
+      auto digits = end - slash - 1;
+      if (digits == 0 || digits > 2) {
+        malformed = true;
+        return std::nullopt;
+      }
+      unsigned length{0};
+      for (auto i = slash + 1; i < end; ++i) {
+        unsigned digit = line[i] - '0';
+        if (digit > 9) {
+          malformed = true;
+          return std::nullopt;
+        }
+        length = length * 10 + digit;
+      }
+      if (length > 32) {
+        malformed = true;
+        return std::nullopt;
+      }
+      prefix.length = static_cast<std::uint8_t>(length);
+    }
+
+    in_addr address{};
+    if (::inet_pton(AF_INET, line.substr(begin, addressEnd - begin).c_str(), &address) != 1) {
+      malformed = true;
+      return std::nullopt;
+    }
+
+    // Host bits are not part of the prefix
+    auto mask = prefix.length == 0 ? 0u : ~0u << (32u - prefix.length);
+    prefix.address = ntohl(address.s_addr) & mask;
+    return prefix;
+  }
+}
+
+RangeFilter::RangeFilter(std::string path, std::chrono::seconds refreshSeconds)
+    : mFilePath{std::move(path)},
+      mRefreshSeconds{refreshSeconds} {
+  if (mFilePath.empty()) {
+    return;
+  }
+
+  reload();
+  if (mRefreshSeconds.count() > 0) {
+    reloadLoop();
+  }
+}
+
+bool RangeFilter::contains(std::uint32_t address) const {
+  const auto & table = mTables[mCurrent];
+  if (table.blocks.empty()) {
+    return false;
+  }
+
+  auto entry = table.blocks[address >> 8u];
+  if (entry < Table::CHUNKS) {
+    return entry != 0;
+  }
+  const auto & chunk = table.chunks[entry - Table::CHUNKS];
+  return (chunk[(address & 0xFFu) >> 6u] >> (address & 0x3Fu)) & 1u;
+}
+
+void RangeFilter::reloadLoop() {
+  std::thread t{[this]() {
+    {
+      auto nextTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() + mRefreshSeconds);
+      LOG(logger::LOG,
+          "RangeFilter::reloadLoop: Scheduling new range filter reload at {:%F %T}",
+          *std::localtime(&nextTime));
+      std::this_thread::sleep_for(mRefreshSeconds);
+    }
+
+    reload();
+    reloadLoop();
+  }};
+  t.detach();
+}
+
+void RangeFilter::reload() {
+  LOG(logger::INFO, "RangeFilter::reload: reloading");
+
+  std::ifstream stream(mFilePath);
+
+  if (!stream.is_open()) {
+    LOG(logger::WARN, "RangeFilter::reload: could not load range filter file \"{:s}\"", mFilePath);
+    return;
+  }
+
+  std::vector<Prefix> prefixes;
+  std::string buffer;
+  try {
+    while (std::getline(stream, buffer)) {
+      bool malformed;
+      if (auto prefix = parse(buffer, malformed)) {
+        prefixes.push_back(*prefix);
+      } else if (malformed) {
+        LOG(logger::WARN, "RangeFilter::reload: failed to parse prefix {:s}", buffer);
+      }
+    }
+  } catch (const std::exception & ex) {
+    LOG(logger::WARN, "RangeFilter::reload: exception while reloading range filter: {}", ex.what());
+  }
+
+  // Shorter prefixes first, so that longer ones overwrite them
+  std::stable_sort(prefixes.begin(), prefixes.end(), [](const Prefix & left, const Prefix & right) {
+    return left.length < right.length;
+  });
+
+  auto index = 1 - mCurrent;
+  auto & table = mTables[index];
+  table.chunks.clear();
+  table.size = 0;
+  if (prefixes.empty()) {
+    table.blocks.clear();
+    table.blocks.shrink_to_fit();
+  } else {
+    table.blocks.assign(BLOCKS, 0);
+  }
+
+  for (const auto & prefix : prefixes) {
+    if (prefix.length <= 24) {
+      // No chunk exists yet, as they only come from the longer prefixes
+      auto first = prefix.address >> 8u;
+      std::fill_n(table.blocks.begin() + first, std::size_t{1} << (24u - prefix.length), prefix.filtered ? 1 : 0);
+    } else {
+      auto & entry = table.blocks[prefix.address >> 8u];
+      if (entry < Table::CHUNKS) {
+        if (table.chunks.size() == Table::MAX_CHUNKS) {
+          LOG(logger::WARN, "RangeFilter::reload: too many split /24 blocks, ignoring the rest");
+          break;
+        }
+        std::uint64_t fill = entry != 0 ? ~std::uint64_t{0} : 0;
+        table.chunks.push_back({fill, fill, fill, fill});
+        entry = static_cast<std::uint16_t>(Table::CHUNKS + table.chunks.size() - 1);
+      }
+
+      auto & chunk = table.chunks[entry - Table::CHUNKS];
+      auto last = (prefix.address & 0xFFu) + (1u << (32u - prefix.length));
+      for (auto host = prefix.address & 0xFFu; host < last; ++host) {
+        auto bit = std::uint64_t{1} << (host & 0x3Fu);
+        chunk[host >> 6u] = prefix.filtered ? (chunk[host >> 6u] | bit) : (chunk[host >> 6u] & ~bit);
+      }
+    }
+    ++table.size;
+  }
+
+  mCurrent = index;
+
+  LOG(logger::LOG,
+      "RangeFilter::reload: Enabled new range filter with {:d} prefixes and {:d} split blocks",
+      table.size,
+      table.chunks.size());
+}
@@ -0,0 +1,87 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+#include <array>
+#include <string>
+#include <cstdint>
+
+#include <chrono>
+
+/**
+ * Filters whole IPv4 ranges, matched against the Framed-IP-Address of a packet
+ *
+ * The file holds one prefix per line, such as `10.64.0.0/10`, with a bare address meaning /32.
+ * A prefix starting with `!` is let through, so holes can be carved in wider ranges: the longest
+ * matching prefix decides. Empty lines and lines starting with `#` are ignored.
+ *
+ * The prefixes are compiled at reload time into a DIR-24-8 table: one entry per /24, which either
+ * holds the answer or points to a bitmap of the 256 addresses of a /24 that is split by longer
+ * prefixes. A lookup is then one or two memory accesses. The /24 entries take 32 MiB, so they are
+ * only allocated while the file has prefixes.
+ *
+ * Reloads build the inactive table and then swap, the same way as `Filter`. An empty path
+ * disables the filter
+ */
+class RangeFilter {
+private:
+
+  // For testing
+  friend class RangeFilterTester;
+
+  /**
+   * A compiled set of prefixes
+   *
+   * An entry below CHUNKS is the answer for its whole /24; any other points to chunk `entry - CHUNKS`
+   */
+  struct Table {
+    static constexpr std::uint16_t CHUNKS = 2;
+    static constexpr std::size_t MAX_CHUNKS = 0xFFFF - CHUNKS + 1;
+
+    std::vector<std::uint16_t> blocks{};
+    std::vector<std::array<std::uint64_t, 4>> chunks{};
+    std::size_t size{0};
+  };
+
+  std::size_t mCurrent{0};
+  std::array<Table, 2> mTables{};
+  const std::string mFilePath;
+  const std::chrono::seconds mRefreshSeconds;
+
+  void reload();
+  void reloadLoop();
+
+public:
+
+  RangeFilter(std::string filePath, std::chrono::seconds refreshSeconds);
+  RangeFilter(std::string filePath, std::chrono::minutes refreshMinutes)
+      : RangeFilter{std::move(filePath), std::chrono::duration_cast<std::chrono::seconds>(refreshMinutes)} {};
+
+  /**
+   * Whether a file is configured, even one not loaded yet
+   */
+  bool enabled() const {
+    return !mFilePath.empty();
+  }
+
+  /**
+   * @param address the IPv4 address, in host order
+   */
+  bool contains(std::uint32_t address) const;
+
+  bool contains(const std::array<std::uint8_t, 4> & octets) const {
+    return contains(static_cast<std::uint32_t>(octets[0]) << 24u
+                    | static_cast<std::uint32_t>(octets[1]) << 16u
+                    | static_cast<std::uint32_t>(octets[2]) << 8u
+                    | octets[3]);
+  }
+
+  ~RangeFilter() = default;
+  RangeFilter(const RangeFilter &) = delete;
+  RangeFilter(RangeFilter &&) = delete;
+  void operator=(const RangeFilter &) = delete;
+
+};
@@ -0,0 +1,160 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "rate_limiter.hpp"
+
+#include <algorithm>
+#include <optional>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <fmt/format.h>
+
+#include "attribute_scanner.hpp"
+#include "logger.hpp"
+#include "radius.hpp"
+
+namespace {
+
+  // Bucket sizes must fit the low half of the state
+  constexpr std::uint64_t MAX_BURST = 4'000'000;
+
+  /**
+   * Scans for the Acct-Status-Type only, stopping as soon as it is found
+   */
+  bool isUpdate(const std::uint8_t * packet, std::size_t size) {
+    static const radius::AttributeScanner::Selection SELECTION{
+        radius::AttributeId{0, radius::Attribute::ACCT_STATUS_TYPE}};
+
+    if (size < radius::Header::SIZE) {
+      return false;
+    }
+
+    auto length = std::min<std::size_t>(size, static_cast<std::size_t>(packet[2] << 8u | packet[3]));
+    radius::AttributeScanner attributes{SELECTION, packet + radius::Header::SIZE, packet + std::max(length, radius::Header::SIZE)};
+    auto span = attributes[radius::Attribute::ACCT_STATUS_TYPE];
+    return attributes.valid()
+           && span.length == sizeof(std::uint32_t)
+           && radius::ValueReader::getUnsignedInt(span.begin, span.end()) == radius::UPDATE;
+  }
+
+  /**
+   * Fibonacci hashing, so that neighbouring addresses spread over the table
+   */
+  std::size_t hash(std::uint32_t address) {
+    return static_cast<std::size_t>((std::uint64_t{address} * 0x9E3779B97F4A7C15u) >> 32u);
+  }
+}
+
+RateLimiter::RateLimiter(std::uint32_t rate, std::uint32_t burst, std::uint32_t globalRate)
+    : mRate{rate},
+      mBurst{std::min<std::uint64_t>(burst ? burst : rate, MAX_BURST) * ONE},
+      mGlobalRate{globalRate},
+      mGlobalBurst{std::min<std::uint64_t>(globalRate, MAX_BURST) * ONE},
+      mStart{Clock::now()},
+      mSlots{rate ? std::make_unique<std::array<Slot, SLOTS>>() : nullptr} {
+  mGlobal.fill(0, mGlobalBurst);
+
+  if (enabled()) {
+    LOG(logger::LOG, "RateLimiter: {:d} packets/s per NAS in bursts of {:d}, {:d} packets/s overall",
+        mRate,
+        mBurst / ONE,
+        mGlobalRate);
+  }
+}
+
+RateLimiter::Slot * RateLimiter::find(std::uint32_t address, std::uint32_t now) {
+  auto & slots = *mSlots;
+  auto start = hash(address);
+  for (std::size_t probe = 0; probe < PROBES; ++probe) {
+    auto & slot = slots[(start + probe) & (SLOTS - 1)];
+    auto owner = slot.address.load(std::memory_order_acquire);
+    if (owner == address) {
+      return &slot;
+    }
+
+    if (owner == 0) {
+      if (slot.address.compare_exchange_strong(owner, address, std::memory_order_acq_rel)) {
+        slot.bucket.fill(now, mBurst);
+        return &slot;
+      }
+      if (owner == address) {
+        return &slot;
+      }
+    }
+  }
+
+  if (!mFull.exchange(true, std::memory_order_relaxed)) {
+    LOG(logger::WARN, "RateLimiter::find: no room for more NASes. Those left out only count towards the global budget");
+  }
+  return nullptr;
+}
+
+bool RateLimiter::admit(const sockaddr * source, const std::uint8_t * packet, std::size_t size, Clock::time_point now) {
+  if (!enabled()) {
+    return true;
+  }
+
+  std::uint32_t address{0};
+  if (source && source->sa_family == AF_INET) {
+    address = ntohl(reinterpret_cast<const sockaddr_in *>(source)->sin_addr.s_addr);
+  }
+  return admit(address, packet, size, now);
+}
+
+bool RateLimiter::admit(std::uint32_t address, const std::uint8_t * packet, std::size_t size, Clock::time_point now) {
+  if (!enabled()) {
+    return true;
+  }
+
+  auto elapsed = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - mStart).count());
+
+  // Only looked at when a bucket is running low, and at most once
+  std::optional<bool> update;
+  auto checkUpdate = [&]() {
+    if (!update) {
+      update = isUpdate(packet, size);
+    }
+    return *update;
+  };
+
+  auto slot = mRate && address ? find(address, elapsed) : nullptr;
+  if (slot && !slot->bucket.take(elapsed, mRate, mBurst, checkUpdate)) {
+    slot->shed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  if (mGlobalRate && !mGlobal.take(elapsed, mGlobalRate, mGlobalBurst, checkUpdate)) {
+    mShedGlobal.fetch_add(1, std::memory_order_relaxed);
+    if (slot) {
+      // The NAS is not charged for a packet it was not let through for
+      slot->bucket.refund(mBurst);
+      slot->shed.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+  }
+
+  return true;
+}
+
+std::string RateLimiter::report() const {
+  auto report = fmt::format("limiter.shed.global {:d}\n", mShedGlobal.load(std::memory_order_relaxed));
+  if (!mSlots) {
+    return report;
+  }
+
+  for (const auto & slot : *mSlots) {
+    auto shed = slot.shed.load(std::memory_order_relaxed);
+    if (shed == 0) {
+      continue;
+    }
+
+    in_addr address{htonl(slot.address.load(std::memory_order_relaxed))};
+    char text[INET_ADDRSTRLEN];
+    ::inet_ntop(AF_INET, &address, text, sizeof(text));
+    report += fmt::format("limiter.shed.nas.{:s} {:d}\n", text, shed);
+  }
+  return report;
+}
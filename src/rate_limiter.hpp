@@ -0,0 +1,153 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <sys/socket.h>
+
+/**
+ * Per-NAS and global token buckets, consulted on every packet before it is parsed
+ *
+ * Each NAS gets a bucket of NAS_BURST packets refilled at NAS_RATE packets per second, and all
+ * packets share one more of GLOBAL_RATE. Once a bucket falls below half its size, only starts and
+ * stops are let through, so a NAS replaying its backlog loses its Interim-Updates first.
+ *
+ * Buckets live in a fixed-size open-addressed table keyed by the source address. A bucket is a
+ * single atomic word holding its last refill time and its tokens, updated with compare-and-swap,
+ * so no lock is taken on the receive path. Slots are claimed for good by the first packet of a
+ * NAS; sources that find no free slot within a few probes are only held to the global budget
+ */
+class RateLimiter {
+public:
+
+  using Clock = std::chrono::steady_clock;
+
+private:
+
+  static constexpr std::size_t SLOTS = 4096;
+  static constexpr std::size_t PROBES = 16;
+
+  // Tokens are counted in thousandths, so that a refill of rate x milliseconds is exact
+  static constexpr std::uint64_t ONE = 1000;
+
+  /**
+   * Refill time in milliseconds since the limiter started in the high half, tokens in the low half
+   */
+  class Bucket {
+    std::atomic<std::uint64_t> mState{0};
+
+  public:
+
+    void fill(std::uint32_t now, std::uint64_t burst) {
+      mState.store(std::uint64_t{now} << 32u | burst, std::memory_order_relaxed);
+    }
+
+    /**
+     * Refills the bucket and takes a token from it
+     *
+     * @tparam F callable telling whether the packet is an Interim-Update, only called below the reserve
+     * @return whether there was a token for the packet
+     */
+    template <typename F>
+    bool take(std::uint32_t now, std::uint64_t rate, std::uint64_t burst, F && isUpdate) {
+      auto state = mState.load(std::memory_order_relaxed);
+      for (;;) {
+        auto elapsed = static_cast<std::uint32_t>(now - static_cast<std::uint32_t>(state >> 32u));
+        auto tokens = std::min(burst, (state & 0xFFFFFFFFu) + elapsed * rate);
+
+        // A bucket of a single packet keeps no reserve, or updates would never get through
+        auto reserve = std::min(burst, burst / 2 + ONE);
+        auto needed = tokens < reserve && isUpdate() ? reserve : ONE;
+        if (tokens < needed) {
+          return false;
+        }
+
+        if (mState.compare_exchange_weak(state,
+                                         std::uint64_t{now} << 32u | (tokens - ONE),
+                                         std::memory_order_relaxed)) {
+          return true;
+        }
+      }
+    }
+
+    /**
+     * Puts back a token taken for a packet that was shed after all
+     */
+    void refund(std::uint64_t burst) {
+      auto state = mState.load(std::memory_order_relaxed);
+      for (;;) {
+        auto tokens = std::min(burst, (state & 0xFFFFFFFFu) + ONE);
+        if (mState.compare_exchange_weak(state,
+                                         (state & ~std::uint64_t{0xFFFFFFFFu}) | tokens,
+                                         std::memory_order_relaxed)) {
+          return;
+        }
+      }
+    }
+  };
+
+  struct Slot {
+    std::atomic<std::uint32_t> address{0};
+    Bucket bucket;
+    std::atomic<std::uint64_t> shed{0};
+  };
+
+  const std::uint64_t mRate;
+  const std::uint64_t mBurst;
+  const std::uint64_t mGlobalRate;
+  const std::uint64_t mGlobalBurst;
+  const Clock::time_point mStart;
+  const std::unique_ptr<std::array<Slot, SLOTS>> mSlots;
+  Bucket mGlobal;
+  std::atomic<std::uint64_t> mShedGlobal{0};
+  std::atomic<bool> mFull{false};
+
+  /**
+   * The slot of a NAS, claimed if it has none yet
+   *
+   * @return the slot, or nullptr if the table has no room for it
+   */
+  Slot * find(std::uint32_t address, std::uint32_t now);
+
+public:
+
+  /**
+   * @param rate packets per second per NAS, 0 for no limit
+   * @param burst packets a NAS may send at once, 0 for one second's worth
+   * @param globalRate packets per second across all NASes, 0 for no limit
+   */
+  RateLimiter(std::uint32_t rate, std::uint32_t burst, std::uint32_t globalRate);
+
+  bool enabled() const {
+    return mRate != 0 || mGlobalRate != 0;
+  }
+
+  /**
+   * Whether a packet may be processed
+   *
+   * @param source the address it came from. Anything but IPv4 is only held to the global budget
+   * @param packet the datagram, only read for its Acct-Status-Type when a bucket runs low
+   * @param size its size
+   */
+  bool admit(const sockaddr * source, const std::uint8_t * packet, std::size_t size, Clock::time_point now = Clock::now());
+
+  bool admit(std::uint32_t address, const std::uint8_t * packet, std::size_t size, Clock::time_point now = Clock::now());
+
+  /**
+   * One line per counter, as `<name> <value>`, with the NASes that had packets shed
+   */
+  std::string report() const;
+
+  RateLimiter(const RateLimiter &) = delete;
+  RateLimiter(RateLimiter &&) = delete;
+  void operator=(const RateLimiter &) = delete;
+};
@@ -0,0 +1,231 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "redis_backend.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "logger.hpp"
+
+namespace {
+
+  void setTimeout(int socket, int option, std::chrono::milliseconds timeout) {
+    timeval value{static_cast<time_t>(timeout.count() / 1000),
+                  static_cast<suseconds_t>((timeout.count() % 1000) * 1000)};
+    ::setsockopt(socket, SOL_SOCKET, option, &value, sizeof(value));
+  }
+}
+
+RedisBackend::RedisBackend(const Config::Cache & config, bool pipelined)
+    : mHost{config.host},
+      mPort{config.port},
+      mTimeout{config.timeoutMillis},
+      mPipelined{pipelined},
+      mWaitReply{!pipelined && !config.noReply},
+      mKeepAlive{config.tcpKeepAlive} {}
+
+RedisBackend::~RedisBackend() {
+  if (mSocket >= 0) {
+    flush();
+  }
+  disconnect();
+}
+
+bool RedisBackend::set(const std::string & key, const std::string & value, std::time_t ttl) {
+  if (mSocket < 0 && !open()) return false;
+
+  if (ttl > 0) {
+    append({"SET", key, value, "EX", std::to_string(ttl)});
+  } else {
+    append({"SET", key, value});
+  }
+  return submit();
+}
+
+bool RedisBackend::remove(const std::string & key) {
+  if (mSocket < 0 && !open()) return false;
+
+  append({"DEL", key});
+  return submit();
+}
+
+bool RedisBackend::flush() {
+  if (mSocket < 0 && !open()) return false;
+
+  return send() && receive(true);
+}
+
+bool RedisBackend::connect() {
+  return mSocket >= 0 || open();
+}
+
+void RedisBackend::discard() {
+  disconnect();
+}
+
+bool RedisBackend::open() {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  addrinfo * addresses;
+  if (::getaddrinfo(mHost.c_str(), std::to_string(mPort).c_str(), &hints, &addresses) != 0) {
+    LOG(logger::INFO, "RedisBackend::open: could not resolve {:s}", mHost);
+    return false;
+  }
+
+  for (auto address = addresses; address; address = address->ai_next) {
+    mSocket = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (mSocket < 0) continue;
+
+    // The send timeout also bounds connect
+    setTimeout(mSocket, SO_SNDTIMEO, mTimeout);
+    setTimeout(mSocket, SO_RCVTIMEO, mTimeout);
+    int enable{1};
+    ::setsockopt(mSocket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    if (mKeepAlive) {
+      ::setsockopt(mSocket, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    }
+
+    if (::connect(mSocket, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+    ::close(mSocket);
+    mSocket = -1;
+  }
+  ::freeaddrinfo(addresses);
+
+  if (mSocket < 0) {
+    LOG(logger::INFO, "RedisBackend::open: could not connect to {:s}:{:d}", mHost, mPort);
+    return false;
+  }
+  return true;
+}
+
+void RedisBackend::disconnect() {
+  if (mSocket >= 0) {
+    ::close(mSocket);
+    mSocket = -1;
+  }
+  mOutput.clear();
+  mInput.clear();
+  mPending = 0;
+}
+
+void RedisBackend::append(std::initializer_list<std::string_view> arguments) {
+  mOutput += '*';
+  mOutput += std::to_string(arguments.size());
+  mOutput += "\r\n";
+  for (auto argument : arguments) {
+    mOutput += '$';
+    mOutput += std::to_string(argument.size());
+    mOutput += "\r\n";
+    mOutput += argument;
+    mOutput += "\r\n";
+  }
+  ++mPending;
+}
+
+bool RedisBackend::submit() {
+  if (mPipelined && mOutput.size() < PIPELINE_BYTES) {
+    return true;
+  }
+  return send() && receive(mWaitReply || mPending > MAX_PENDING);
+}
+
+bool RedisBackend::send() {
+  std::size_t sent{0};
+  while (sent < mOutput.size()) {
+    auto result = ::send(mSocket, mOutput.data() + sent, mOutput.size() - sent, MSG_NOSIGNAL);
+    if (result < 0 && errno == EINTR) continue;
+    if (result <= 0) {
+      LOG(logger::INFO, "RedisBackend::send: {:s}", std::strerror(errno));
+      disconnect();
+      return false;
+    }
+    sent += static_cast<std::size_t>(result);
+  }
+  mOutput.clear();
+  return true;
+}
+
+bool RedisBackend::receive(bool wait) {
+  auto ok = parse();
+
+  while (mSocket >= 0 && mPending > 0) {
+    char buffer[4096];
+    auto result = ::recv(mSocket, buffer, sizeof(buffer), wait ? 0 : MSG_DONTWAIT);
+    if (result > 0) {
+      mInput.append(buffer, static_cast<std::size_t>(result));
+      ok = parse() && ok;
+      continue;
+    }
+
+    if (result < 0 && errno == EINTR) continue;
+    if (result < 0 && !wait && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+    LOG(logger::INFO, "RedisBackend::receive: {:s}", result == 0 ? "connection closed" : std::strerror(errno));
+    disconnect();
+    return false;
+  }
+
+  return ok && mSocket >= 0;
+}
+
+bool RedisBackend::parse() {
+  auto ok = true;
+  std::size_t offset{0};
+
+  while (mPending > 0) {
+    auto lineEnd = mInput.find("\r\n", offset);
+    if (lineEnd == std::string::npos) break;
+
+    auto next = lineEnd + 2;
+    auto line = std::string_view{mInput}.substr(offset + 1, lineEnd - offset - 1);
+
+    switch (mInput[offset]) {
+      case '+':
+      case ':':
+        break;
+      case '-':
+        LOG(logger::INFO, "RedisBackend::parse: {:s}", line);
+        ok = false;
+        break;
+      case '$': {
+        // -1 is a null reply, with no data following
+        long long length;
+        auto [end, error] = std::from_chars(line.data(), line.data() + line.size(), length);
+        if (error != std::errc{} || end != line.data() + line.size() || length < -1) {
+          LOG(logger::WARN, "RedisBackend::parse: malformed bulk length '{:s}'", line);
+          disconnect();
+          return false;
+        }
+        if (length >= 0) {
+          next += static_cast<std::size_t>(length) + 2;
+        }
+        break;
+      }
+      default:
+        LOG(logger::WARN, "RedisBackend::parse: unexpected reply type '{:c}'", mInput[offset]);
+        disconnect();
+        return false;
+    }
+
+    if (next > mInput.size()) break; // Bulk string not fully read yet
+
+    offset = next;
+    --mPending;
+  }
+
+  mInput.erase(0, offset);
+  return ok;
+}
@@ -0,0 +1,96 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <initializer_list>
+#include <chrono>
+
+#include "config.hpp"
+#include "cache_backend.hpp"
+
+/**
+ * Native RESP client for Redis
+ *
+ * Commands are written without waiting for their replies, which are drained whenever the
+ * socket has them. A pipelined backend also holds commands back until PIPELINE_BYTES are
+ * buffered or `flush` is called, so bulk writes go out in a few large sends instead of
+ * one round trip each, without wrapping them in MULTI.
+ *
+ * Since replies arrive late, an error reply fails whichever call happens to read it.
+ * Unless NO_REPLY is set, a non-pipelined backend waits for each reply, so failures line up.
+ *
+ * The connection is opened lazily and dropped on any socket or protocol error, to be
+ * reopened by the next call
+ */
+class RedisBackend : public CacheBackend {
+private:
+
+  static constexpr std::size_t PIPELINE_BYTES = 64 * 1024;
+  static constexpr std::size_t MAX_PENDING = 4096;
+
+  const std::string mHost;
+  const unsigned short mPort;
+  const std::chrono::milliseconds mTimeout;
+  const bool mPipelined;
+  const bool mWaitReply;
+  const bool mKeepAlive;
+
+  int mSocket{-1};
+  std::string mOutput{};
+  std::string mInput{};
+  std::size_t mPending{0};
+
+  bool open();
+  void disconnect();
+
+  void append(std::initializer_list<std::string_view> arguments);
+
+  /**
+   * Sends the buffered commands if due and collects the replies that are ready
+   */
+  bool submit();
+
+  bool send();
+
+  /**
+   * @param wait block until every pending reply is read
+   */
+  bool receive(bool wait);
+
+  /**
+   * Consumes the complete replies already read
+   *
+   * @return false if any of them was an error
+   */
+  bool parse();
+
+public:
+
+  bool set(const std::string & key, const std::string & value, std::time_t ttl) override;
+
+  bool remove(const std::string & key) override;
+
+  bool flush() override;
+
+  bool connect() override;
+
+  /**
+   * Drops the connection along with the buffered commands, since replies to the ones already
+   * sent could no longer be told apart
+   */
+  void discard() override;
+
+  /**
+   * @param config the cache configuration
+   * @param pipelined if set, requests are buffered and only sent when the buffer fills up or on `flush`
+   */
+  RedisBackend(const Config::Cache & config, bool pipelined);
+
+  ~RedisBackend() override;
+  RedisBackend(const RedisBackend &) = delete;
+  void operator=(const RedisBackend &) = delete;
+};
@@ -0,0 +1,81 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "reload_report.hpp"
+
+#include <fmt/format.h>
+
+namespace {
+  std::string toString(const std::vector<std::uint64_t> & sample) {
+    std::string string;
+    for (auto value : sample) {
+      string += (string.empty() ? "" : ",") + std::to_string(value);
+    }
+    return string.empty() ? "-" : string;
+  }
+
+  auto toMillis(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+  }
+}
+
+ReloadReport::ReloadReport()
+    : mStart{clock::now()},
+      mLap{mStart} {
+}
+
+void ReloadReport::lap(const char * phase) {
+  auto now = clock::now();
+  mPhases.emplace_back(phase, now - mLap);
+  mLap = now;
+}
+
+void ReloadReport::diff(const std::vector<std::uint64_t> & before, const std::vector<std::uint64_t> & after) {
+  mEntries = after.size();
+  mAdded = 0;
+  mRemoved = 0;
+  mAddedSample.clear();
+  mRemovedSample.clear();
+
+  auto added = [this](std::uint64_t value) {
+    if (mAdded++ < SAMPLE) mAddedSample.push_back(value);
+  };
+  auto removed = [this](std::uint64_t value) {
+    if (mRemoved++ < SAMPLE) mRemovedSample.push_back(value);
+  };
+
+  // Both are sorted, so one walk through each finds every change
+  auto old = before.begin();
+  auto current = after.begin();
+  while (old != before.end() && current != after.end()) {
+    if (*old < *current) {
+      removed(*old++);
+    } else if (*current < *old) {
+      added(*current++);
+    } else {
+      ++old;
+      ++current;
+    }
+  }
+  for (; old != before.end(); ++old) removed(*old);
+  for (; current != after.end(); ++current) added(*current);
+}
+
+std::string ReloadReport::record() const {
+  auto record = fmt::format("entries={:d} added={:d} removed={:d} added.sample={:s} removed.sample={:s} duplicates={:d}",
+                            mEntries,
+                            mAdded,
+                            mRemoved,
+                            toString(mAddedSample),
+                            toString(mRemovedSample),
+                            mDuplicates);
+  for (const auto & [phase, duration] : mPhases) {
+    record += fmt::format(" time.{:s}_ms={:d}", phase, toMillis(duration));
+  }
+  record += fmt::format(" time.total_ms={:d} memory.footprint_kib={:d} memory.peak_kib={:d}",
+                        toMillis(mLap - mStart),
+                        mFootprintBytes / 1024,
+                        mPeakBytes / 1024);
+  return record;
+}
@@ -0,0 +1,101 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * What a filter reload changed and what it cost, logged as one record rather than a line per entry
+ *
+ * Holds the counts of IDs added and removed against the previous filter with the first few of
+ * each, the time of every phase and the memory taken. The record is a single line of
+ * `key=value` fields, so that it can be grepped and parsed without holding up the log
+ */
+class ReloadReport {
+public:
+
+  /**
+   * How many added and removed IDs are listed at most
+   */
+  static constexpr std::size_t SAMPLE = 8;
+
+private:
+
+  using clock = std::chrono::steady_clock;
+
+  clock::time_point mStart;
+  clock::time_point mLap;
+  std::vector<std::pair<const char *, clock::duration>> mPhases;
+  std::size_t mEntries{0};
+  std::size_t mAdded{0};
+  std::size_t mRemoved{0};
+  std::size_t mDuplicates{0};
+  std::vector<std::uint64_t> mAddedSample;
+  std::vector<std::uint64_t> mRemovedSample;
+  std::size_t mFootprintBytes{0};
+  std::size_t mPeakBytes{0};
+
+public:
+
+  /**
+   * Starts timing the first phase
+   */
+  ReloadReport();
+
+  /**
+   * Ends a phase, timed from the end of the one before
+   *
+   * @param phase a name with static storage
+   */
+  void lap(const char * phase);
+
+  /**
+   * Compares the previous filter with the new one, both sorted and without duplicates
+   */
+  void diff(const std::vector<std::uint64_t> & before, const std::vector<std::uint64_t> & after);
+
+  void duplicates(std::size_t duplicates) {
+    mDuplicates = duplicates;
+  }
+
+  /**
+   * @param footprint the bytes the new filter keeps
+   * @param peak the most bytes the reload held at once
+   */
+  void memory(std::size_t footprint, std::size_t peak) {
+    mFootprintBytes = footprint;
+    mPeakBytes = peak;
+  }
+
+  std::size_t entries() const {
+    return mEntries;
+  }
+
+  std::size_t added() const {
+    return mAdded;
+  }
+
+  std::size_t removed() const {
+    return mRemoved;
+  }
+
+  const std::vector<std::uint64_t> & addedSample() const {
+    return mAddedSample;
+  }
+
+  const std::vector<std::uint64_t> & removedSample() const {
+    return mRemovedSample;
+  }
+
+  /**
+   * The report as one line, like
+   * `entries=4 added=1 removed=1 added.sample=9 removed.sample=3 duplicates=0 time.parse_ms=1 ...`
+   */
+  std::string record() const;
+};
@@ -4,77 +4,387 @@
 
 #pragma once
 
-#include <array>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #include <boost/asio.hpp>
 
 #include "config.hpp"
 #include "logger.hpp"
-#include "cache.hpp"
+#include "connection_pool.hpp"
 #include "action.hpp"
+#include "radius.hpp"
+#include "stats.hpp"
+#include "buffer_slab.hpp"
+#include "encoder.hpp"
+#include "periodic.hpp"
+#include "proxy.hpp"
+#include "rate_limiter.hpp"
+#include "stats_socket.hpp"
+#include "top_k.hpp"
+#include "handover.hpp"
+#include "live_config.hpp"
+#include "session_store.hpp"
+#include "shutdown.hpp"
+#include "signal_thread.hpp"
+#include "snapshot.hpp"
+#include "spill_journal.hpp"
+#include "uring.hpp"
 
 /**
  * Main server to handle UDP connections
  *
- * Works with rolling callback handlers shared across all threads.
- * Each callback handler has 8KB buffer for the packet by default.
- *
- * This is currently customizable at compile-time to harness std::array stack allocation
- * Use:
- * cmake -DRC_BUFFER_SIZE=<value> (...)
+ * Works with rolling receive slots shared across all threads.
+ * Packet buffers come from a single slab sized at runtime by BUFFER_COUNT and BUFFER_SIZE.
+ * Cache connections are not tied to the executor either: every worker thread talks to the
+ * cache through a pool of its own, opened before it takes its first packet.
+ * With UPSTREAMS set, each packet is forwarded before it is parsed, so the cache work never
+ * delays the upstream accounting servers.
+ * On SIGTERM or SIGINT the workers stop receiving, execute what is still queued on their sockets
+ * for up to DRAIN_TIMEOUT_MILLIS and flush their pipelines. A new instance started with the same
+ * HANDOVER_SOCKET takes the sockets over instead, leaving nothing queued behind
  */
 class Server {
 private:
 
-#ifndef RC_BUFFER_SIZE
-  #define RC_BUFFER_SIZE 1024 * 8
-#endif
+  // io_uring engine sizing, per ring
+  static constexpr unsigned URING_ENTRIES = 256;
+  static constexpr unsigned URING_BUFFERS = 256;
 
-  static constexpr unsigned int BUFFER_SIZE = RC_BUFFER_SIZE;
+  enum UringTag : std::uint64_t {
+    RECEIVE = 1,
+    TICK = 2,
+    STOP = 3,
+    CANCEL = 4
+  };
 
   using boostUdp = boost::asio::ip::udp;
-  using Buffer = std::array<std::uint8_t, BUFFER_SIZE>;
+
+  /**
+   * Cache connections opened by a reload ahead of publishing it, for the workers to take over
+   * when they first see the new snapshot. Each comes with the snapshot it was opened from
+   */
+  class PoolHandoff {
+  private:
+
+    struct Warm {
+      std::shared_ptr<const Config> config;
+      std::unique_ptr<ConnectionPool> pool;
+    };
+
+    std::mutex mMutex;
+    std::uint64_t mGeneration{0};
+    std::vector<Warm> mPools;
+
+  public:
+
+    /**
+     * Opens the pools for a snapshot about to be published, replacing any left over
+     *
+     * @param count how many workers will take one
+     * @param journal where the pools spill failed pipelined requests
+     */
+    void prepare(std::uint64_t generation,
+                 const std::shared_ptr<const Config> & config,
+                 std::size_t count,
+                 SpillJournal & journal) {
+      std::vector<Warm> pools;
+      pools.reserve(count);
+      for (std::size_t i = 0; i < count; ++i) {
+        pools.push_back({config, std::make_unique<ConnectionPool>(config->cache, &journal)});
+        pools.back().pool->warmup();
+      }
+
+      std::lock_guard<std::mutex> lock{mMutex};
+      mGeneration = generation;
+      mPools.swap(pools);
+    }
+
+    /**
+     * One of the pools opened for a generation, if any is left
+     */
+    bool take(std::uint64_t generation, std::shared_ptr<const Config> & config, std::unique_ptr<ConnectionPool> & pool) {
+      std::lock_guard<std::mutex> lock{mMutex};
+      if (mGeneration != generation || mPools.empty()) {
+        return false;
+      }
+      config = std::move(mPools.back().config);
+      pool = std::move(mPools.back().pool);
+      mPools.pop_back();
+      return true;
+    }
+  };
+
+  /**
+   * State shared by all executors
+   */
+  struct Context {
+    LiveConfig & live;
+    PoolHandoff & pools;
+    Shutdown & shutdown;
+    SessionStore & store;
+    SpillJournal & journal;
+    Stats & stats;
+    Proxy & proxy;
+    RateLimiter & limiter;
+    TopK & nases;
+    TopK & keys;
+  };
 
   /**
    * Executor for once the buffer is ready
    * Will offload to the parser to know how to take action
+   *
+   * Holds no connection of its own, so a single executor can serve every thread
    */
   struct Executor {
-    boostUdp::endpoint mEndpoint;
-    Buffer mBuffer;
-    Cache mCache;
 
-    explicit Executor(const Config::Cache & config)
-        : mCache{config} {}
+    /**
+     * What a worker thread holds of the configuration: the snapshot it works with,
+     * and the encoder and cache connections built from it
+     */
+    struct Local {
+      std::uint64_t generation;
+      std::shared_ptr<const Config> config;
+      Encoder encoder;
+      // Last, so that it is flushed and closed while the snapshot it refers to is still held
+      std::unique_ptr<ConnectionPool> pool;
+
+      Local(std::uint64_t generation, std::shared_ptr<const Config> config, std::unique_ptr<ConnectionPool> pool)
+          : generation{generation},
+            config{std::move(config)},
+            encoder{this->config->cache},
+            pool{std::move(pool)} {}
+    };
+
+    Context & mContext;
+
+    explicit Executor(Context & context)
+        : mContext{context} {}
+
+    /**
+     * The state of the calling thread, caught up with the current snapshot
+     *
+     * Costs a single atomic load while the configuration stays the same
+     */
+    Local & local() const {
+      thread_local std::unique_ptr<Local> local;
+
+      auto generation = mContext.live.generation();
+      if (!local || local->generation != generation) {
+        std::shared_ptr<const Config> config;
+        std::unique_ptr<ConnectionPool> pool;
+        if (!local || !mContext.pools.take(generation, config, pool)) {
+          config = mContext.live.get();
+          pool = std::make_unique<ConnectionPool>(config->cache, &mContext.journal);
+        }
+
+        if (local) {
+          LOG(logger::INFO, "Server::Executor: switching to configuration generation {:d}", generation);
+        }
+        local.reset();
+        local = std::make_unique<Local>(generation, std::move(config), std::move(pool));
+      }
+      return *local;
+    }
+
+    /**
+     * The cache connections of the calling thread
+     */
+    ConnectionPool & pool() const {
+      return *local().pool;
+    }
+
+    /**
+     * The cache is under pressure while its circuit is open or while spilled mutations are pending
+     *
+     * Interim-Updates only refresh sessions that are already cached, so they are shed first.
+     * Starts and stops are always kept
+     */
+    bool shouldShed(const Action & action, const ConnectionPool & pool) const {
+      return action.action == Action::STORE
+             && action.status == radius::UPDATE
+             && (!pool.healthy() || mContext.journal.active());
+    }
+
+    /**
+     * Whether to write to the journal instead of the pool
+     *
+     * Spilling goes on until the journal is drained, so that a replay never overwrites newer values.
+     * What the pool still has pipelined is flushed first, and spilled ahead of the new write if
+     * that fails, so the journal keeps the order of the writes
+     */
+    bool spilling(ConnectionPool & pool) const {
+      if (!mContext.journal.active()) {
+        return false;
+      }
+      pool.flush();
+      return true;
+    }
+
+    /**
+     * Writes a key through the pool, or to the journal while spilling
+     */
+    void set(ConnectionPool & pool, const std::string & key, const std::string & value) const {
+      if (spilling(pool) || !pool.set(key, value)) {
+        mContext.journal.set(key, value);
+      }
+      mContext.store.store(key, value);
+    }
+
+    void remove(ConnectionPool & pool, const std::string & key) const {
+      if (spilling(pool) || !pool.remove(key)) {
+        mContext.journal.remove(key);
+      }
+      mContext.store.remove(key);
+    }
+
+    /**
+     * Counts a write to the cache towards the heaviest keys
+     */
+    void count(const std::string & key) const {
+      mContext.keys.add(key, [&key]() { return key; });
+    }
+
+    void count(const std::array<std::uint8_t, 16> & prefix) const {
+      mContext.keys.add({reinterpret_cast<const char *>(prefix.data()), prefix.size()}, [&prefix]() {
+        char text[INET6_ADDRSTRLEN];
+        return std::string{::inet_ntop(AF_INET6, prefix.data(), text, sizeof(text))};
+      });
+    }
+
+    /**
+     * How an action is named in the logs: its key, or the IPv6 prefixes when it has none
+     */
+    static std::string describe(const Action & action) {
+      return action.key ? *action.key : fmt::format("{:d} IPv6 prefixes", action.prefixes.size());
+    }
+
+    /**
+     * Handles a packet as received: hands it to the upstreams when proxying, admits it against the
+     * NAS and global budgets, and only then does the local work on it
+     *
+     * The budgets only shed the parsing and the cache writes, so the upstreams see every packet
+     * when proxying. Truncated packets are not forwarded, since the upstreams would reject them anyway
+     *
+     * @param reply the socket the packet was received on
+     * @param source the address of the NAS
+     */
+    template <typename P>
+    void receive(std::size_t byteCount,
+                 const std::uint8_t * buffer,
+                 std::size_t capacity,
+                 int reply,
+                 const sockaddr * source,
+                 socklen_t sourceSize,
+                 const P & parser) const {
+      if (source && source->sa_family == AF_INET) {
+        auto & address = reinterpret_cast<const sockaddr_in *>(source)->sin_addr;
+        mContext.nases.add({reinterpret_cast<const char *>(&address), sizeof(address)}, [&address]() {
+          char text[INET_ADDRSTRLEN];
+          return std::string{::inet_ntop(AF_INET, &address, text, sizeof(text))};
+        });
+      }
+
+      if (mContext.proxy.enabled() && byteCount <= capacity) {
+        mContext.proxy.forward(buffer, byteCount, reply, source, sourceSize);
+      }
+
+      if (!mContext.limiter.admit(source, buffer, std::min(byteCount, capacity))) {
+        LOG(logger::DEBUG, "Server::Executor: NAS over its budget. Shedding packet");
+        return;
+      }
+
+      (*this)(byteCount, buffer, capacity, parser);
+    }
 
+    /**
+     * Handles a packet received into a buffer of `capacity` bytes
+     *
+     * Every key of the packet is queued on the pool in turn, so they all go out in the same
+     * pipelined batch
+     *
+     * @param byteCount the size of the packet as reported by the receive, which may exceed the buffer
+     */
     template <typename P>
     auto operator()(std::size_t byteCount,
-                    const P & parser) {
-      auto bufferBegin = std::cbegin(mBuffer);
-      auto bufferEnd = std::cend(mBuffer);
-      auto action = parser(
-          byteCount,
-          bufferBegin,
-          bufferBegin +
-          std::min(byteCount, static_cast<std::size_t>(std::max(0L, std::distance(bufferBegin, bufferEnd))))
-      );
+                    const std::uint8_t * buffer,
+                    std::size_t capacity,
+                    const P & parser) const {
+      auto action = parser(byteCount, buffer, buffer + std::min(byteCount, capacity));
+
+      // Caught up once per packet, so a reload never lands halfway through one
+      auto & state = local();
+      auto & pool = *state.pool;
+
+      if (shouldShed(action, pool)) {
+        LOG(logger::INFO, "Server::Executor: Shedding update of {:s} with {:s}", describe(action), *action.value);
+        mContext.stats.shed(action.action);
+        mContext.store.expire();
+        return;
+      }
+      mContext.stats.kept(action.action);
 
       switch (action.action) {
-        case Action::STORE:
-          LOG(logger::INFO, "Server::Executor: Storing {:s} with {:s}", *action.key, *action.value);
-          mCache.set(*action.key, *action.value);
+        case Action::STORE: {
+          LOG(logger::INFO, "Server::Executor: Storing {:s} with {:s}", describe(action), *action.value);
+          auto value = state.encoder.value(action);
+          if (action.key) {
+            count(*action.key);
+            set(pool, state.encoder.key(action), value);
+          }
+          for (const auto & prefix : action.prefixes) {
+            count(prefix);
+            set(pool, state.encoder.key(prefix), value);
+          }
           break;
-        case Action::REMOVE:
-          LOG(logger::INFO, "Server::Executor: Removing {:s} with {:s}", *action.key, *action.value);
-          mCache.remove(*action.key);
+        }
+        case Action::REMOVE: {
+          LOG(logger::INFO, "Server::Executor: Removing {:s} with {:s}", describe(action), *action.value);
+          if (action.key) {
+            count(*action.key);
+            remove(pool, state.encoder.key(action));
+          }
+          for (const auto & prefix : action.prefixes) {
+            count(prefix);
+            remove(pool, state.encoder.key(prefix));
+          }
           break;
+        }
         case Action::FILTER:
           LOG(logger::INFO, "Server::Executor: Filtering {:s}", *action.value);
           break;
       }
+
+      // Bounded slice of expiries, paid for by the packet that just arrived
+      mContext.store.expire();
+    }
+  };
+
+  /**
+   * A receive slot in the rolling list: a packet buffer and the executor that handles it
+   */
+  struct Slot {
+    boostUdp::endpoint mEndpoint;
+    std::uint8_t * mBuffer;
+    std::size_t mCapacity;
+    const Executor & mExecutor;
+
+    template <typename P>
+    void operator()(std::size_t byteCount, int reply, const P & parser) {
+      mExecutor.receive(byteCount, mBuffer, mCapacity, reply, mEndpoint.data(), mEndpoint.size(), parser);
     }
   };
 
@@ -98,11 +408,17 @@ private:
     LOG(logger::DEBUG, "Server::receive: ready to receive");
     try {
       socket.async_receive_from(
-          boost::asio::buffer(callbackCurrent->mBuffer, Server::BUFFER_SIZE),
+          boost::asio::buffer(callbackCurrent->mBuffer, callbackCurrent->mCapacity),
           callbackCurrent->mEndpoint,
           [&socket, callbackCurrent, callbackBegin, callbackEnd, &parser]
               (const boost::system::error_code & error, std::size_t bytesReceived) {
 
+            // Cancelled on shutdown: what is left on the socket is drained by runMultiCore
+            if (error == boost::asio::error::operation_aborted) {
+              return;
+            }
+            auto & executor = callbackCurrent->mExecutor;
+
             if (error && error != boost::asio::error::message_size) {
               LOG(logger::WARN, "Server::receive::lambda: error returned when executing receive: ({:d}) {:s}",
                   error.value(),
@@ -112,16 +428,25 @@ private:
             LOG(logger::DEBUG, "Server::receive::lambda: packet received");
             auto callbackNext = callbackCurrent + 1;
 
-            // Infinite loop for listening
-            receive(socket,
-                    (callbackNext != callbackEnd)
-                    ? callbackNext
-                    : callbackBegin,
-                    callbackBegin,
-                    callbackEnd,
-                    parser);
+            // Infinite loop for listening, until stopping. Checked here as well as cancelled, since
+            // the cancel misses a receive armed after it ran
+            if (!executor.mContext.shutdown.stopping()) {
+              receive(socket,
+                      (callbackNext != callbackEnd)
+                      ? callbackNext
+                      : callbackBegin,
+                      callbackBegin,
+                      callbackEnd,
+                      parser);
+            }
+
+            (*callbackCurrent)(bytesReceived, socket.native_handle(), parser);
 
-            (*callbackCurrent)(bytesReceived, parser);
+            // Nothing else waiting: push out whatever this thread has pipelined
+            boost::system::error_code availableError;
+            if (socket.available(availableError) == 0) {
+              executor.pool().flush();
+            }
           }
       );
     } catch (const std::exception & e) {
@@ -129,6 +454,25 @@ private:
     }
   }
 
+  /**
+   * Keeps expiring sessions while no packets arrive, until stopping
+   *
+   * @param timer the timer driving the expiry
+   * @param store the session store to expire
+   * @param shutdown tells when to stop re-arming
+   */
+  static void expireLoop(boost::asio::steady_timer & timer, SessionStore & store, const Shutdown & shutdown) {
+    timer.expires_after(std::chrono::seconds{1});
+    timer.async_wait([&timer, &store, &shutdown](const boost::system::error_code & error) {
+      if (error || shutdown.stopping()) {
+        return;
+      }
+
+      store.expire();
+      expireLoop(timer, store, shutdown);
+    });
+  }
+
   struct Listener {
 
     /**
@@ -137,46 +481,136 @@ private:
      * @tparam P the packet parser type
      * @param config configuration for inbound and outbound connections
      * @param ioService the listening service
+     * @param socket the bound UDP socket
+     * @param context the state shared by all executors
      * @param parser the packet parser
      */
     template <typename P>
     Listener(const Config & config,
              boost::asio::io_service & ioService,
+             int socket,
+             Context & context,
              const P & parser)
-        : mSocket{ioService, boostUdp::endpoint{boostUdp::v4(), config.server.port}} {
+        : mSocket{ioService, boostUdp::v4(), ::dup(socket)},
+          mExpiryTimer{ioService},
+          mBuffers{config.server.bufferCount, config.server.bufferSize},
+          mExecutor{context} {
 
-      mCallbackList.reserve(config.server.threadPoolSize);
-      for (unsigned short i = 0; i < config.server.threadPoolSize; ++i) {
-        mCallbackList.emplace_back(config.cache);
+      mCallbackList.reserve(mBuffers.count());
+      for (std::size_t i = 0; i < mBuffers.count(); ++i) {
+        mCallbackList.push_back({{}, mBuffers[i], mBuffers.size(), mExecutor});
       }
 
       receive(mSocket, mCallbackList.begin(), mCallbackList.begin(), mCallbackList.end(), parser);
+
+      if (context.store.enabled()) {
+        expireLoop(mExpiryTimer, context.store, context.shutdown);
+      }
     }
 
     boostUdp::socket mSocket;
-    std::vector<Executor> mCallbackList;
+    boost::asio::steady_timer mExpiryTimer;
+    BufferSlab mBuffers;
+    Executor mExecutor;
+    std::vector<Slot> mCallbackList;
   };
 
   /**
-   * Starts listening and offloading packets to P. This method will block
+   * Executes what is still queued on a socket once stopping, until it runs dry or the drain
+   * runs out of time, then pushes out whatever the calling thread pipelined
+   *
+   * If the sockets were handed over, what is queued is left for the new process instead
    *
    * @tparam P the packet parser type
+   * @param socket the socket to drain
+   * @param buffer the packet buffer to drain into
+   * @param capacity the size of the buffer
+   * @param executor the executor of the calling thread
+   * @param context the state shared by all executors
    * @param parser the packet parser
    */
   template <typename P>
-  static void runSingleCore(const Config & config, const P & parser) {
+  static void drain(int socket,
+                    std::uint8_t * buffer,
+                    std::size_t capacity,
+                    const Executor & executor,
+                    Context & context,
+                    const P & parser) {
+    std::size_t drained{0};
+    while (!context.shutdown.handedOver() && !context.shutdown.expired()) {
+      sockaddr_storage source{};
+      socklen_t sourceSize{sizeof(source)};
+      auto bytes = ::recvfrom(socket,
+                              buffer,
+                              capacity,
+                              MSG_DONTWAIT,
+                              reinterpret_cast<sockaddr *>(&source),
+                              &sourceSize);
+      if (bytes < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        break;
+      }
+
+      ++drained;
+      try {
+        executor.receive(static_cast<std::size_t>(bytes),
+                         buffer,
+                         capacity,
+                         socket,
+                         reinterpret_cast<const sockaddr *>(&source),
+                         sourceSize,
+                         parser);
+      } catch (const std::exception & e) {
+        LOG(logger::WARN, "Server::drain: exception caught when executing packet: {:s}", e.what());
+      }
+    }
+
+    if (!executor.pool().flush()) {
+      LOG(logger::WARN, "Server::drain: could not flush every pipelined request");
+    }
+    LOG(logger::INFO, "Server::drain: {:d} packets drained", drained);
+  }
+
+  /**
+   * Starts listening and offloading packets to P. This method will block until shutdown
+   *
+   * The socket is non-blocking, and the loop only waits in poll(2) once it runs dry, so that a
+   * stop is noticed while idle
+   *
+   * @tparam P the packet parser type
+   * @param socket the bound UDP socket
+   * @param context the state shared by all executors
+   * @param parser the packet parser
+   */
+  template <typename P>
+  static void runSingleCore(const Config & config, int socket, Context & context, const P & parser) {
 
     LOG(logger::LOG, "Server::runSingleCore: launching listener on UDP {:d} on a single core", config.server.port);
     boost::asio::io_context ioContext;
-    boostUdp::socket socket{ioContext, boostUdp::endpoint{boostUdp::v4(), config.server.port}};
+    // Closes a duplicate only, so that the socket stays open for a handover until run is done
+    boostUdp::socket listener{ioContext, boostUdp::v4(), ::dup(socket)};
+    listener.non_blocking(true);
 
-    Executor executor(config.cache);
+    BufferSlab buffers{1, config.server.bufferSize};
+    boostUdp::endpoint endpoint;
+    Executor executor{context};
+    executor.pool().warmup();
     LOG(logger::INFO, "Server::runSingleCore: executor built");
 
-    for (;;) {
+    while (!context.shutdown.stopping()) {
       try {
         boost::system::error_code error;
-        auto bytes = socket.receive_from(boost::asio::buffer(executor.mBuffer), executor.mEndpoint, 0, error);
+        auto bytes = listener.receive_from(boost::asio::buffer(buffers[0], buffers.size()), endpoint, 0, error);
+
+        if (error == boost::asio::error::would_block) {
+          // Nothing else waiting: push out whatever was pipelined
+          executor.pool().flush();
+          pollfd ready[]{{socket, POLLIN, 0}, {context.shutdown.fd(), POLLIN, 0}};
+          ::poll(ready, 2, -1);
+          continue;
+        }
         LOG(logger::DEBUG, "Server::runSingleCore: {:d} bytes received", bytes);
 
         if (error && error != boost::asio::error::message_size) {
@@ -185,64 +619,663 @@ private:
               error.message());
         }
 
-        executor(bytes, parser);
+        executor.receive(bytes, buffers[0], buffers.size(), socket, endpoint.data(), endpoint.size(), parser);
       } catch (const std::exception & e) {
         LOG(logger::WARN, "Server::runSingleCore: exception caught when executing receive: {:s}", e.what());
       }
     }
 
+    drain(socket, buffers[0], buffers.size(), executor, context, parser);
     LOG(logger::LOG, "Server::runSingleCore: server stopped");
   }
 
   /**
-   * Starts listening and offloading packets to P. This method will block
+   * Starts listening and offloading packets to P. This method will block until shutdown
+   *
+   * The calling thread supervises the workers: it resizes them on reload, and on shutdown
+   * cancels the receives, waits for the workers to run out of work and drains the socket
    *
    * @tparam P the packet parser type
+   * @param socket the bound UDP socket
+   * @param context the state shared by all executors
    * @param parser the packet parser
    */
   template <typename P>
-  static void runMultiCore(const Config & config, const P & parser) {
+  static void runMultiCore(const Config & config, int socket, Context & context, const P & parser) {
     boost::asio::io_service ioService;
 
-    Listener listener{config, ioService, parser};
+    Listener listener{config, ioService, socket, context, parser};
     LOG(logger::DEBUG, "Server::runMultiCore: listener built");
 
-    if (config.server.threadPoolSize == 1) {
-      LOG(logger::LOG, "Server::runMultiCore: launching listener on UDP {:d} on a single thread", config.server.port);
-      ioService.run();
-    } else {
-      std::vector<std::thread> threadPool;
-      threadPool.reserve(config.server.threadPoolSize);
+    LOG(logger::LOG,
+        "Server::runMultiCore: launching listeners on UDP {:d} on {:d} threads",
+        config.server.port,
+        config.server.threadPoolSize);
 
-      LOG(logger::LOG,
-          "Server::runMultiCore: launching listeners on UDP {:d} on {:d} threads",
-          config.server.port,
-          config.server.threadPoolSize);
+    // Threads at or above the target leave after the handler they are running, while the others
+    // keep the receives going, so resizing on reload never stops the listener
+    std::atomic<std::size_t> target{0};
+    std::vector<std::thread> threadPool;
+    auto generation = context.live.generation();
+    std::size_t size = config.server.threadPoolSize;
 
-      for (unsigned short i = 0; i < config.server.threadPoolSize; ++i) {
-        threadPool.emplace_back([&ioService]() { ioService.run(); });
+    while (!context.shutdown.stopping()) {
+      target.store(size, std::memory_order_relaxed);
+      while (threadPool.size() < size) {
+        threadPool.emplace_back([&ioService, &listener, &target, index = threadPool.size()]() {
+          listener.mExecutor.pool().warmup();
+          while (index < target.load(std::memory_order_relaxed) && !ioService.stopped()) {
+            ioService.run_one_for(std::chrono::seconds{1});
+          }
+        });
+      }
+      while (threadPool.size() > size) {
+        threadPool.back().join();
+        threadPool.pop_back();
       }
 
-      for (auto & t : threadPool) {
-        t.join();
+      pollfd stop{context.shutdown.fd(), POLLIN, 0};
+      while (context.live.generation() == generation && !context.shutdown.stopping()) {
+        ::poll(&stop, 1, 1000);
+      }
+      generation = context.live.generation();
+      if (context.shutdown.stopping()) {
+        break;
+      }
+
+      // BUFFER_COUNT only changes on a restart, so the ring has to keep outnumbering the threads
+      std::size_t next = context.live.get()->server.threadPoolSize;
+      if (next >= listener.mBuffers.count()) {
+        LOG(logger::WARN,
+            "Server::runMultiCore: {:d} threads need more than the {:d} buffers. Keeping {:d} until restart",
+            next,
+            listener.mBuffers.count(),
+            listener.mBuffers.count() - 1);
+        next = listener.mBuffers.count() - 1;
+      }
+      if (next != size) {
+        LOG(logger::LOG, "Server::runMultiCore: resizing from {:d} to {:d} threads", size, next);
+        size = next;
       }
     }
+
+    // With no receive nor expiry pending, the workers run out of work and leave, flushing their
+    // pools on the way out. Should a handler still be busy when the drain runs out of time, the
+    // service is stopped under it
+    ioService.post([&listener]() {
+      boost::system::error_code ignored;
+      listener.mSocket.cancel(ignored);
+      listener.mExpiryTimer.cancel(ignored);
+    });
+    while (!ioService.stopped() && !context.shutdown.expired()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    ioService.stop();
+    for (auto & t : threadPool) {
+      t.join();
+    }
+
+    drain(socket, listener.mBuffers[0], listener.mBuffers.size(), listener.mExecutor, context, parser);
     LOG(logger::LOG, "Server::runMultiCore: server stopped");
   }
 
+  /**
+   * Opens a UDP socket on the server port
+   *
+   * With reusePort, other workers can bind the port as well. The kernel spreads datagrams across
+   * the sockets by source, so each NAS sticks to one worker
+   */
+  static int openSocket(unsigned short port, bool reusePort) {
+    auto socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (socket < 0) {
+      throw std::runtime_error("Server::openSocket: could not open socket");
+    }
+
+    if (reusePort) {
+      int enable{1};
+      ::setsockopt(socket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (::bind(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+      ::close(socket);
+      throw std::runtime_error(fmt::format("Server::openSocket: could not bind UDP {:d}", port));
+    }
+    return socket;
+  }
+
+  /**
+   * The sockets the workers receive on: taken over from the running instance if there is one
+   * listening on HANDOVER_SOCKET, opened otherwise
+   *
+   * @param count how many the mode needs
+   * @param reusePort whether the mode has each worker on a socket of its own
+   */
+  static std::vector<int> openSockets(const Config & config, std::size_t count, bool reusePort) {
+    auto sockets = Handover::take(config.server.handoverSocket);
+
+    if (sockets.size() > count) {
+      LOG(logger::WARN,
+          "Server::openSockets: took over {:d} sockets but only {:d} are needed. "
+          "Closing the rest, along with whatever is queued on them",
+          sockets.size(),
+          count);
+      for (auto i = count; i < sockets.size(); ++i) {
+        ::close(sockets[i]);
+      }
+      sockets.resize(count);
+    }
+
+    while (sockets.size() < count) {
+      sockets.push_back(openSocket(config.server.port, reusePort));
+    }
+    return sockets;
+  }
+
+  /**
+   * Pins the calling thread to its share of CPU_LIST, if any
+   *
+   * Workers take the listed CPUs in turn, wrapping around if there are more workers than CPUs
+   *
+   * @param index the worker index
+   */
+  static void pinThread(const Config & config, unsigned short index) {
+    if (config.server.cpuList.empty()) {
+      return;
+    }
+
+    auto cpu = config.server.cpuList[index % config.server.cpuList.size()];
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    auto error = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+    if (error != 0) {
+      LOG(logger::WARN, "Server::pinThread: could not pin worker {:d} to CPU {:d}: {:s}",
+          index,
+          cpu,
+          std::strerror(error));
+      return;
+    }
+    LOG(logger::INFO, "Server::pinThread: worker {:d} pinned to CPU {:d}", index, cpu);
+  }
+
+  /**
+   * Spins on a non-blocking receive and offloads packets to P. This method will block
+   *
+   * SO_BUSY_POLL lets each empty receive poll the device queue for a while instead of returning
+   * straight away. Once no packet has arrived for BUSY_POLL_IDLE_MICROS, the worker stops spinning
+   * and sleeps in poll(2) until the next packet, expiring sessions once a second while idle
+   *
+   * @tparam P the packet parser type
+   * @param context the state shared by all executors
+   * @param parser the packet parser
+   * @param buffer the worker's packet buffer
+   * @param socket the worker's bound UDP socket
+   * @param index the worker index
+   */
+  template <typename P>
+  static void runPoller(const Config & config,
+                        Context & context,
+                        const P & parser,
+                        std::uint8_t * buffer,
+                        int socket,
+                        unsigned short index) {
+    pinThread(config, index);
+
+    int budget = static_cast<int>(config.server.busyPollMicros.count());
+    if (::setsockopt(socket, SOL_SOCKET, SO_BUSY_POLL, &budget, sizeof(budget)) != 0) {
+      LOG(logger::WARN, "Server::runPoller: could not set SO_BUSY_POLL: {:s}", std::strerror(errno));
+    }
+
+    Executor executor{context};
+    executor.pool().warmup();
+    auto lastPacket = std::chrono::steady_clock::now();
+    auto spinning = true;
+
+    while (!context.shutdown.stopping()) {
+      if (!spinning) {
+        pollfd ready[]{{socket, POLLIN, 0}, {context.shutdown.fd(), POLLIN, 0}};
+        if (::poll(ready, 2, 1000) == 0) {
+          context.store.expire();
+          continue;
+        }
+      }
+
+      sockaddr_storage source{};
+      socklen_t sourceSize{sizeof(source)};
+      auto bytes = ::recvfrom(socket,
+                              buffer,
+                              config.server.bufferSize,
+                              MSG_DONTWAIT,
+                              reinterpret_cast<sockaddr *>(&source),
+                              &sourceSize);
+
+      if (bytes < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          executor.pool().flush();
+          if (spinning && std::chrono::steady_clock::now() - lastPacket > config.server.busyPollIdleMicros) {
+            LOG(logger::DEBUG, "Server::runPoller: worker {:d} idle. Blocking", index);
+            spinning = false;
+          }
+        } else if (errno != EINTR) {
+          LOG(logger::WARN, "Server::runPoller: error returned when executing receive: ({:d}) {:s}",
+              errno,
+              std::strerror(errno));
+        }
+        continue;
+      }
+
+      if (!spinning) {
+        LOG(logger::DEBUG, "Server::runPoller: worker {:d} woken up. Spinning", index);
+        spinning = true;
+      }
+      lastPacket = std::chrono::steady_clock::now();
+
+      try {
+        executor.receive(static_cast<std::size_t>(bytes),
+                         buffer,
+                         config.server.bufferSize,
+                         socket,
+                         reinterpret_cast<const sockaddr *>(&source),
+                         sourceSize,
+                         parser);
+      } catch (const std::exception & e) {
+        LOG(logger::WARN, "Server::runPoller: exception caught when executing packet: {:s}", e.what());
+      }
+    }
+
+    drain(socket, buffer, config.server.bufferSize, executor, context, parser);
+  }
+
+  /**
+   * Starts one busy-polling worker per thread and offloads packets to P. This method will block
+   * until shutdown
+   *
+   * @tparam P the packet parser type
+   * @param sockets the bound UDP sockets, one per worker
+   * @param context the state shared by all executors
+   * @param parser the packet parser
+   */
+  template <typename P>
+  static void runBusyPoll(const Config & config, const std::vector<int> & sockets, Context & context, const P & parser) {
+    LOG(logger::LOG,
+        "Server::runBusyPoll: launching busy-polling listeners on UDP {:d} on {:d} threads",
+        config.server.port,
+        config.server.threadPoolSize);
+
+    BufferSlab buffers{config.server.threadPoolSize, config.server.bufferSize};
+
+    std::vector<std::thread> threadPool;
+    threadPool.reserve(config.server.threadPoolSize);
+    for (unsigned short i = 0; i < config.server.threadPoolSize; ++i) {
+      threadPool.emplace_back([&config, &sockets, &context, &parser, &buffers, i]() {
+        try {
+          runPoller(config, context, parser, buffers[i], sockets[i], i);
+        } catch (const std::exception & e) {
+          LOG(logger::ERROR, "Server::runBusyPoll: worker {:d} stopped: {:s}", i, e.what());
+        }
+      });
+    }
+
+    for (auto & t : threadPool) {
+      t.join();
+    }
+    LOG(logger::LOG, "Server::runBusyPoll: server stopped");
+  }
+
+  /**
+   * Receives and executes packets on a ring of its own. This method will block until shutdown
+   *
+   * A single multishot recvmsg stays armed on the socket, and the kernel writes each datagram
+   * straight into a buffer picked from the provided-buffer ring. The executor parses it in place
+   * and the buffer is handed back right after, so a steady stream of packets costs one
+   * io_uring_enter per batch of completions instead of a readiness notification plus a receive each.
+   * A poll on the shutdown eventfd stays armed alongside: once it fires, the receive is cancelled
+   * and the socket is drained with plain receives
+   *
+   * @tparam P the packet parser type
+   * @param socket the ring's bound UDP socket
+   * @param context the state shared by all executors
+   * @param parser the packet parser
+   * @param ticking whether this ring drives the idle expiry of the session store
+   */
+  template <typename P>
+  static void runRing(const Config & config, int socket, Context & context, const P & parser, bool ticking) {
+    Uring ring{URING_ENTRIES};
+    UringBufferRing buffers{ring,
+                            0,
+                            URING_BUFFERS,
+                            sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_storage) + config.server.bufferSize};
+    Executor executor{context};
+    executor.pool().warmup();
+
+    // Only the sizes matter for a multishot recvmsg: they lay out each provided buffer
+    msghdr header{};
+    header.msg_namelen = sizeof(sockaddr_storage);
+
+    auto armReceive = [&]() {
+      auto & sqe = ring.prepare();
+      sqe.opcode = IORING_OP_RECVMSG;
+      sqe.fd = socket;
+      sqe.addr = reinterpret_cast<std::uint64_t>(&header);
+      sqe.len = 1;
+      sqe.ioprio = IORING_RECV_MULTISHOT;
+      sqe.flags = IOSQE_BUFFER_SELECT;
+      sqe.buf_group = buffers.group();
+      sqe.user_data = RECEIVE;
+    };
+
+    __kernel_timespec interval{1, 0};
+    auto armTick = [&]() {
+      auto & sqe = ring.prepare();
+      sqe.opcode = IORING_OP_TIMEOUT;
+      sqe.addr = reinterpret_cast<std::uint64_t>(&interval);
+      sqe.len = 1;
+      sqe.user_data = TICK;
+    };
+
+    auto & stop = ring.prepare();
+    stop.opcode = IORING_OP_POLL_ADD;
+    stop.fd = context.shutdown.fd();
+    stop.poll32_events = POLLIN;
+    stop.user_data = STOP;
+
+    armReceive();
+    if (ticking) {
+      armTick();
+    }
+
+    auto stopping = false;
+    auto receiving = true;
+    while (receiving) {
+      ring.submit(1);
+      ring.forEach([&](const io_uring_cqe & cqe) {
+        if (cqe.user_data == TICK) {
+          context.store.expire();
+          armTick();
+          return;
+        }
+
+        if (cqe.user_data == CANCEL) {
+          return;
+        }
+
+        if (cqe.user_data == STOP) {
+          stopping = true;
+          auto & cancel = ring.prepare();
+          cancel.opcode = IORING_OP_ASYNC_CANCEL;
+          cancel.addr = RECEIVE;
+          cancel.user_data = CANCEL;
+          return;
+        }
+
+        if (cqe.res >= 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+          auto id = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+          auto out = reinterpret_cast<const io_uring_recvmsg_out *>(buffers.buffer(id));
+          auto payload = buffers.buffer(id) + sizeof(io_uring_recvmsg_out) + header.msg_namelen;
+          auto bytes = static_cast<std::size_t>(out->payloadlen);
+          LOG(logger::DEBUG, "Server::runRing: {:d} bytes received", bytes);
+
+          try {
+            executor.receive(bytes,
+                             payload,
+                             config.server.bufferSize,
+                             socket,
+                             reinterpret_cast<const sockaddr *>(buffers.buffer(id) + sizeof(io_uring_recvmsg_out)),
+                             out->namelen,
+                             parser);
+          } catch (const std::exception & e) {
+            LOG(logger::WARN, "Server::runRing: exception caught when executing packet: {:s}", e.what());
+          }
+          buffers.recycle(id);
+        } else if (cqe.res < 0 && cqe.res != -ENOBUFS && cqe.res != -ECANCELED) {
+          LOG(logger::WARN, "Server::runRing: error returned when executing receive: ({:d}) {:s}",
+              -cqe.res,
+              std::strerror(-cqe.res));
+        }
+
+        // The kernel ends a multishot receive on errors, when it runs out of buffers or once cancelled.
+        // Only a transient error is worth arming again: any other would come straight back
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+          if (stopping) {
+            receiving = false;
+          } else if (cqe.res >= 0 || cqe.res == -ENOBUFS || cqe.res == -EINTR || cqe.res == -EAGAIN) {
+            armReceive();
+          } else {
+            throw std::runtime_error(fmt::format("receive ended: {:s}", std::strerror(-cqe.res)));
+          }
+        }
+      });
+
+      // The batch is done: push out whatever it pipelined before waiting again
+      executor.pool().flush();
+    }
+
+    // The provided buffers may still be the kernel's, so the drain gets one of its own
+    std::vector<std::uint8_t> buffer(config.server.bufferSize);
+    drain(socket, buffer.data(), buffer.size(), executor, context, parser);
+  }
+
+  /**
+   * Whether the kernel supports what runRing needs of io_uring
+   */
+  static bool uringSupported() {
+    try {
+      Uring::probe();
+      return true;
+    } catch (const std::exception & e) {
+      LOG(logger::WARN, "Server::uringSupported: {:s}. Falling back to runMultiCore", e.what());
+      return false;
+    }
+  }
+
+  /**
+   * Starts one io_uring listener per thread and offloads packets to P. This method will block
+   * until shutdown
+   *
+   * A ring that fails hands its socket over to runPoller on the same thread, so no socket is
+   * left unread
+   *
+   * @tparam P the packet parser type
+   * @param sockets the bound UDP sockets, one per ring
+   * @param context the state shared by all executors
+   * @param parser the packet parser
+   */
+  template <typename P>
+  static void runUring(const Config & config, const std::vector<int> & sockets, Context & context, const P & parser) {
+    LOG(logger::LOG,
+        "Server::runUring: launching io_uring listeners on UDP {:d} on {:d} threads",
+        config.server.port,
+        config.server.threadPoolSize);
+
+    std::vector<std::thread> threadPool;
+    threadPool.reserve(config.server.threadPoolSize);
+    for (unsigned short i = 0; i < config.server.threadPoolSize; ++i) {
+      threadPool.emplace_back([&config, &sockets, &context, &parser, i]() {
+        try {
+          pinThread(config, i);
+          runRing(config, sockets[i], context, parser, i == 0 && context.store.enabled());
+          return;
+        } catch (const std::exception & e) {
+          LOG(logger::ERROR, "Server::runUring: ring {:d} stopped: {:s}. Polling its socket instead", i, e.what());
+        }
+
+        // The socket is bound to this thread alone, so it is served without the ring until shutdown
+        try {
+          std::vector<std::uint8_t> buffer(config.server.bufferSize);
+          runPoller(config, context, parser, buffer.data(), sockets[i], i);
+        } catch (const std::exception & e) {
+          LOG(logger::ERROR, "Server::runUring: poller {:d} stopped: {:s}", i, e.what());
+        }
+      });
+    }
+
+    for (auto & t : threadPool) {
+      t.join();
+    }
+    LOG(logger::LOG, "Server::runUring: server stopped");
+  }
+
+  /**
+   * Reads the configuration again and publishes it, keeping the current one if invalid
+   *
+   * The workers pick the new snapshot up on their next packet, along with cache connections
+   * opened here beforehand, so none of them waits on a connect. The TTL and the verbosity apply
+   * at once, the thread count on the next second in the multi-core mode.
+   * Anything bound at startup is left as it is, with a warning
+   */
+  static void reload(LiveConfig & live, PoolHandoff & pools, SessionStore & store, SpillJournal & journal) {
+    LOG(logger::LOG, "Server::reload: reloading the configuration");
+    auto next = live.load();
+    if (!next) {
+      return;
+    }
+    auto current = live.get();
+
+    auto restart = [](const char * name, bool changed) {
+      if (changed) {
+        LOG(logger::WARN, "Server::reload: {:s} changed. It only takes effect on restart", name);
+      }
+    };
+    const auto & before = current->server;
+    const auto & after = next->server;
+    restart("PORT", before.port != after.port);
+    restart("SINGLE_CORE", before.singleCore != after.singleCore);
+    restart("BUSY_POLL", before.busyPoll != after.busyPoll);
+    restart("IO_URING", before.ioUring != after.ioUring);
+    restart("THREAD_POOL_SIZE",
+            before.threadPoolSize != after.threadPoolSize && (after.singleCore || after.busyPoll || after.ioUring));
+    restart("CPU_LIST", before.cpuList != after.cpuList);
+    restart("BUSY_POLL_MICROS", before.busyPollMicros != after.busyPollMicros);
+    restart("BUSY_POLL_IDLE_MICROS", before.busyPollIdleMicros != after.busyPollIdleMicros);
+    restart("BUFFER_COUNT", before.bufferCount != after.bufferCount);
+    restart("BUFFER_SIZE", before.bufferSize != after.bufferSize);
+    restart("KEY", before.key != after.key);
+    restart("VALUE", before.value != after.value);
+    restart("FILTER_FILE", before.filterFile != after.filterFile);
+    restart("FILTER_REFRESH_MINUTES", before.filterRefreshMinutes != after.filterRefreshMinutes);
+    restart("RANGE_FILTER_FILE", before.rangeFilterFile != after.rangeFilterFile);
+    restart("UPSTREAMS", before.upstreams != after.upstreams);
+    restart("PROXY_SOCKETS", before.proxySockets != after.proxySockets);
+    restart("PROXY_TIMEOUT_MILLIS", before.proxyTimeoutMillis != after.proxyTimeoutMillis);
+    restart("NAS_RATE", before.nasRate != after.nasRate);
+    restart("NAS_BURST", before.nasBurst != after.nasBurst);
+    restart("GLOBAL_RATE", before.globalRate != after.globalRate);
+    restart("TOP_K", before.topK != after.topK);
+    restart("STATS_INTERVAL_SECONDS", before.statsIntervalSeconds != after.statsIntervalSeconds);
+    restart("STATS_SOCKET", before.statsSocket != after.statsSocket);
+    restart("HANDOVER_SOCKET", before.handoverSocket != after.handoverSocket);
+    restart("DRAIN_TIMEOUT_MILLIS", before.drainTimeoutMillis != after.drainTimeoutMillis);
+    restart("LOCAL_STORE", current->cache.localStore != next->cache.localStore);
+    restart("EXPIRY_BUDGET", current->cache.expiryBudget != next->cache.expiryBudget);
+    restart("SNAPSHOT_FILE", current->cache.snapshotFile != next->cache.snapshotFile);
+    restart("SNAPSHOT_INTERVAL_SECONDS",
+            current->cache.snapshotIntervalSeconds != next->cache.snapshotIntervalSeconds);
+    restart("SPILL_FILE", current->cache.spillFile != next->cache.spillFile);
+    restart("SPILL_SIZE_MEGABYTES", current->cache.spillSizeMegabytes != next->cache.spillSizeMegabytes);
+
+    std::size_t workers = after.singleCore ? 1 : after.threadPoolSize;
+    pools.prepare(live.generation() + 1, next, workers, journal);
+
+    store.setTtl(next->cache.ttl);
+    journal.setTtl(next->cache.ttl);
+    if (!after.verboseLevel.empty()) {
+      logger::setVerboseLevel(after.verboseLevel.c_str());
+    }
+
+    live.publish(std::move(next));
+    LOG(logger::LOG, "Server::reload: configuration generation {:d} published", live.generation());
+  }
+
 public:
 
   template <typename P>
-  static void run(const Config & config, const P & parser) {
-    if (config.server.singleCore) {
-      if (config.server.threadPoolSize > 1) {
-        LOG(logger::WARN,
-            "Server::run: SINGLE_CORE option set. Ignoring THREAD_POOL_SIZE={:d}",
-            config.server.threadPoolSize);
+  static void run(LiveConfig & live, const P & parser) {
+    // What cannot change without a restart is set up once, from the configuration at startup
+    auto startup = live.get();
+    const auto & config = *startup;
+
+    // Taken over first, since that is what tells a running instance to stop: the journal and the
+    // snapshot below then wait for it to write its last to them and exit. Meanwhile datagrams
+    // queue up on the sockets
+    auto uring = config.server.ioUring && uringSupported();
+    auto perWorker = uring || config.server.busyPoll;
+    auto sockets = openSockets(config, perWorker ? config.server.threadPoolSize : 1, perWorker);
+
+    SessionStore store{config.cache};
+
+    // Warm up the store and the cache before the first packet is received
+    Snapshot snapshot{config.cache, store};
+
+    SpillJournal journal{config.cache};
+    SpillReplayer replayer{config.cache, journal};
+
+    // Opened before any packet is received, so that the upstreams never miss one
+    Proxy proxy{config.server.upstreams, config.server.proxySockets, config.server.proxyTimeoutMillis};
+
+    RateLimiter limiter{config.server.nasRate, config.server.nasBurst, config.server.globalRate};
+
+    Stats stats;
+    TopK nases{config.server.topK};
+    TopK keys{config.server.topK};
+    auto report = [&stats, &journal, &proxy, &limiter, &nases, &keys]() {
+      return fmt::format("{:s}{:s}{:s}{:s}{:s}journal.bytes {:d}\njournal.dropped {:d}",
+                         stats.report(),
+                         proxy.enabled() ? proxy.report() : "",
+                         limiter.enabled() ? limiter.report() : "",
+                         nases.report("nas"),
+                         keys.report("key"),
+                         journal.size(),
+                         journal.dropped());
+    };
+
+    // The heaviest NASes and keys are counted over each stats interval
+    Periodic reporter{config.server.statsIntervalSeconds, [&nases, &keys, &report]() {
+      nases.rotate();
+      keys.rotate();
+      LOG(logger::LOG, "Server::run: stats\n{:s}", report());
+    }};
+    StatsSocket query{config.server.statsSocket, report};
+
+    PoolHandoff pools;
+    Shutdown shutdown{config.server.drainTimeoutMillis};
+    Context context{live, pools, shutdown, store, journal, stats, proxy, limiter, nases, keys};
+
+    SignalThread hangUp{{SIGHUP}, [&live, &pools, &store, &journal](int) {
+      reload(live, pools, store, journal);
+    }};
+
+    SignalThread terminate{{SIGTERM, SIGINT}, [&shutdown](int signal) {
+      LOG(logger::LOG, "Server::run: signal {:d} received. Draining", signal);
+      shutdown.stop();
+    }};
+
+    {
+      Handover handover{config.server.handoverSocket, sockets, [&shutdown]() {
+        shutdown.stop(true);
+      }};
+
+      if (uring) {
+        runUring(config, sockets, context, parser);
+      } else if (config.server.busyPoll) {
+        runBusyPoll(config, sockets, context, parser);
+      } else if (config.server.singleCore) {
+        if (config.server.threadPoolSize > 1) {
+          LOG(logger::WARN,
+              "Server::run: SINGLE_CORE option set. Ignoring THREAD_POOL_SIZE={:d}",
+              config.server.threadPoolSize);
+        }
+        runSingleCore(config, sockets[0], context, parser);
+      } else {
+        runMultiCore(config, sockets[0], context, parser);
       }
-      runSingleCore(config, parser);
-    } else {
-      runMultiCore(config, parser);
+    }
+
+    for (auto socket : sockets) {
+      ::close(socket);
     }
   }
 };
@@ -0,0 +1,76 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "session_store.hpp"
+
+#include "logger.hpp"
+
+SessionStore::SessionStore(const Config::Cache & config, std::time_t now)
+    : mEnabled{config.localStore},
+      mTTL{config.ttl},
+      mExpiryBudget{config.expiryBudget} {
+  for (auto & shard : mShards) {
+    shard = std::make_unique<Shard>(now);
+  }
+}
+
+void SessionStore::store(const std::string & key, const std::string & value, std::time_t now) {
+  restore(key, value, now + mTTL.load(std::memory_order_relaxed));
+}
+
+void SessionStore::restore(const std::string & key, const std::string & value, std::time_t expiry) {
+  if (!mEnabled) return;
+
+  auto & shard = shardFor(key);
+  std::unique_lock<std::mutex> lock{shard.mutex};
+
+  auto [it, inserted] = shard.sessions.try_emplace(key);
+  it->second.value = value;
+  if (inserted) {
+    it->second.handle = shard.wheel.insert(&it->first, expiry);
+  } else {
+    shard.wheel.refresh(it->second.handle, expiry);
+  }
+}
+
+void SessionStore::remove(const std::string & key) {
+  if (!mEnabled) return;
+
+  auto & shard = shardFor(key);
+  std::unique_lock<std::mutex> lock{shard.mutex};
+
+  auto it = shard.sessions.find(key);
+  if (it != shard.sessions.end()) {
+    shard.wheel.remove(it->second.handle);
+    shard.sessions.erase(it);
+  }
+}
+
+std::size_t SessionStore::expire(std::time_t now) {
+  if (!mEnabled) return 0;
+
+  auto & shard = *mShards[mNextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS];
+  std::unique_lock<std::mutex> lock{shard.mutex, std::try_to_lock};
+  if (!lock.owns_lock()) {
+    return 0;
+  }
+
+  auto expired = shard.wheel.advance(now, mExpiryBudget, [&shard](const std::string * key) {
+    shard.sessions.erase(shard.sessions.find(*key));
+  });
+
+  if (expired > 0) {
+    LOG(logger::DEBUG, "SessionStore::expire: expired {:d} sessions", expired);
+  }
+  return expired;
+}
+
+std::size_t SessionStore::size() const {
+  std::size_t size{0};
+  for (const auto & shard : mShards) {
+    std::unique_lock<std::mutex> lock{shard->mutex};
+    size += shard->sessions.size();
+  }
+  return size;
+}
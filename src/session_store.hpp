@@ -0,0 +1,121 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <ctime>
+
+#include "config.hpp"
+#include "timer_wheel.hpp"
+
+/**
+ * In-process mirror of the live sessions sent to the cache
+ *
+ * Sessions are spread over shards, each with its own lock and timing wheel.
+ * Expiry is driven by the workers themselves: every call to `expire` processes
+ * a bounded slice of a single shard, so an expiry burst is spread across many packets
+ * instead of stalling the receive loop
+ */
+class SessionStore {
+public:
+
+  static constexpr std::size_t SHARDS = 16;
+
+private:
+
+  // For testing
+  friend class SessionStoreTester;
+
+  struct Session {
+    std::string value;
+    TimerWheel<const std::string *>::Handle handle;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<std::string, Session> sessions;
+    TimerWheel<const std::string *> wheel;
+
+    explicit Shard(std::time_t now) : wheel{now} {}
+  };
+
+  const bool mEnabled;
+  std::atomic<std::time_t> mTTL;
+  const std::size_t mExpiryBudget;
+  std::array<std::unique_ptr<Shard>, SHARDS> mShards;
+  std::atomic<std::size_t> mNextShard{0};
+
+  Shard & shardFor(const std::string & key) {
+    return *mShards[std::hash<std::string>{}(key) % SHARDS];
+  }
+
+public:
+
+  explicit SessionStore(const Config::Cache & config, std::time_t now = std::time(nullptr));
+
+  /**
+   * Inserts a session or refreshes its value and expiry
+   */
+  void store(const std::string & key, const std::string & value, std::time_t now = std::time(nullptr));
+
+  /**
+   * Inserts a session with a known absolute expiry, as when warming up from a snapshot
+   */
+  void restore(const std::string & key, const std::string & value, std::time_t expiry);
+
+  /**
+   * Drops a session ahead of its expiry
+   */
+  void remove(const std::string & key);
+
+  /**
+   * Expires a bounded slice of the next shard in line
+   *
+   * If the shard is busy with another worker, it is skipped until the next call
+   *
+   * @return the number of expired sessions
+   */
+  std::size_t expire(std::time_t now = std::time(nullptr));
+
+  std::size_t size() const;
+
+  /**
+   * Visits every session of a single shard
+   *
+   * The shard is locked for the whole visit, so the callback should be quick
+   * (e.g. serializing into memory) to avoid stalling the workers
+   *
+   * @tparam C callable taking (const std::string & key, const std::string & value, std::time_t expiry)
+   * @param shard the shard index, up to SHARDS
+   */
+  template <typename C>
+  void forEach(std::size_t shard, C callback) {
+    std::unique_lock<std::mutex> lock{mShards[shard]->mutex};
+    for (const auto & [key, session] : mShards[shard]->sessions) {
+      callback(key, session.value, mShards[shard]->wheel.expiry(session.handle));
+    }
+  }
+
+  bool enabled() const {
+    return mEnabled;
+  }
+
+  /**
+   * Changes the TTL of the sessions stored from now on
+   */
+  void setTtl(std::time_t ttl) {
+    mTTL.store(ttl, std::memory_order_relaxed);
+  }
+
+  ~SessionStore() = default;
+  SessionStore(const SessionStore &) = delete;
+  SessionStore(SessionStore &&) = delete;
+  void operator=(const SessionStore &) = delete;
+};
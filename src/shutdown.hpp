@@ -0,0 +1,93 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+/**
+ * Tells the workers to stop receiving, and until when they may drain their sockets
+ *
+ * Workers check `stopping` once per packet. Those waiting for one also wait on `fd`,
+ * which turns readable on stop and stays so, waking every one of them
+ */
+class Shutdown {
+private:
+
+  using clock = std::chrono::steady_clock;
+
+  const std::chrono::milliseconds mGrace;
+  const int mWakeUp;
+  std::once_flag mOnce;
+  std::atomic<bool> mStopping{false};
+  std::atomic<bool> mHandedOver{false};
+  clock::time_point mDeadline{};
+
+public:
+
+  /**
+   * @param grace how long the drain may take once stopped
+   */
+  explicit Shutdown(std::chrono::milliseconds grace)
+      : mGrace{grace},
+        mWakeUp{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)} {
+    if (mWakeUp < 0) {
+      throw std::runtime_error("Shutdown: could not open eventfd");
+    }
+  }
+
+  ~Shutdown() {
+    ::close(mWakeUp);
+  }
+
+  /**
+   * Starts the drain. Only the first call counts
+   *
+   * @param handedOver whether another process took the sockets over, in which case whatever is
+   * still queued on them is left for it instead of drained
+   */
+  void stop(bool handedOver = false) {
+    std::call_once(mOnce, [this, handedOver]() {
+      mDeadline = clock::now() + mGrace;
+      mHandedOver.store(handedOver, std::memory_order_relaxed);
+      mStopping.store(true, std::memory_order_release);
+
+      std::uint64_t one{1};
+      [[maybe_unused]] auto written = ::write(mWakeUp, &one, sizeof(one));
+    });
+  }
+
+  bool stopping() const {
+    return mStopping.load(std::memory_order_acquire);
+  }
+
+  bool handedOver() const {
+    return stopping() && mHandedOver.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Whether the drain is out of time. Only meaningful once stopping
+   */
+  bool expired() const {
+    return stopping() && clock::now() >= mDeadline;
+  }
+
+  /**
+   * Readable once stopping
+   */
+  int fd() const {
+    return mWakeUp;
+  }
+
+  Shutdown(const Shutdown &) = delete;
+  Shutdown(Shutdown &&) = delete;
+  void operator=(const Shutdown &) = delete;
+};
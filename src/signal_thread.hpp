@@ -0,0 +1,77 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <initializer_list>
+#include <thread>
+
+#include <pthread.h>
+#include <signal.h>
+
+/**
+ * Runs a task on its own thread every time the process receives one of a set of signals
+ *
+ * The signals are taken with sigwait, so they must be blocked in every thread of the process:
+ * call `block` at the start of main, before any thread is started, so they all inherit the mask
+ */
+class SignalThread {
+private:
+
+  sigset_t mSet;
+  const int mWakeUp;
+  std::atomic<bool> mStop{false};
+  std::thread mThread;
+
+  static sigset_t toSet(std::initializer_list<int> signals) {
+    sigset_t set;
+    sigemptyset(&set);
+    for (auto signal : signals) {
+      sigaddset(&set, signal);
+    }
+    return set;
+  }
+
+public:
+
+  /**
+   * Blocks the signals in the calling thread and in the threads it starts from now on
+   */
+  static void block(std::initializer_list<int> signals) {
+    auto set = toSet(signals);
+    ::pthread_sigmask(SIG_BLOCK, &set, nullptr);
+  }
+
+  /**
+   * @tparam F callable taking the signal received
+   * @param signals the signals to wait for
+   * @param task the task to run on each
+   */
+  template <typename F>
+  SignalThread(std::initializer_list<int> signals, F task)
+      : mSet{toSet(signals)},
+        mWakeUp{*signals.begin()},
+        mThread{[this, task]() mutable {
+    int received;
+    while (::sigwait(&mSet, &received) == 0 && !mStop.load()) {
+      task(received);
+    }
+  }} {
+    ::pthread_sigmask(SIG_BLOCK, &mSet, nullptr);
+  }
+
+  /**
+   * Wakes the thread up with one of its own signals to stop it
+   */
+  ~SignalThread() {
+    mStop.store(true);
+    ::pthread_kill(mThread.native_handle(), mWakeUp);
+    mThread.join();
+  }
+
+  SignalThread(const SignalThread &) = delete;
+  SignalThread(SignalThread &&) = delete;
+  void operator=(const SignalThread &) = delete;
+};
@@ -0,0 +1,205 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "snapshot.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache.hpp"
+#include "logger.hpp"
+
+namespace {
+  constexpr std::array<char, 4> MAGIC{'R', 'C', 'S', 'S'};
+  constexpr std::uint32_t VERSION = 1;
+  constexpr std::size_t HEADER_SIZE = MAGIC.size() + sizeof(std::uint32_t) + sizeof(std::uint64_t);
+  constexpr std::size_t RECORD_SIZE = sizeof(std::int64_t) + 2 * sizeof(std::uint16_t);
+  constexpr std::size_t FLUSH_EVERY = 1024;
+
+  template <typename T>
+  void append(std::string & buffer, T value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  T load(const char * data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+}
+
+Snapshot::Snapshot(const Config::Cache & config, SessionStore & store)
+    : mPath{config.snapshotFile},
+      mInterval{config.snapshotIntervalSeconds},
+      mStore{store} {
+  if (!mStore.enabled()) {
+    return;
+  }
+  mLock.emplace(mPath + ".lock", "Snapshot");
+
+  try {
+    Cache cache{config, true};
+    auto now = std::time(nullptr);
+    std::size_t pending{0};
+
+    auto count = read(mPath, now, [&](std::string_view key, std::string_view value, std::time_t expiry) {
+      std::string keyString{key};
+      std::string valueString{value};
+      mStore.restore(keyString, valueString, expiry);
+      cache.set(keyString, valueString, expiry - now);
+      if (++pending == FLUSH_EVERY) {
+        cache.flush();
+        pending = 0;
+      }
+    });
+    cache.flush();
+
+    LOG(logger::LOG, "Snapshot::Snapshot: restored {:d} sessions from \"{:s}\"", count, mPath);
+  } catch (const std::exception & ex) {
+    LOG(logger::WARN, "Snapshot::Snapshot: could not restore snapshot \"{:s}\": {}", mPath, ex.what());
+  }
+
+  mWriter.emplace(mInterval, [this]() { writeOnce(); });
+}
+
+Snapshot::~Snapshot() {
+  if (!mWriter) {
+    return;
+  }
+
+  mWriter.reset();
+
+  try {
+    auto count = write(mPath, mStore);
+    LOG(logger::LOG, "Snapshot::~Snapshot: wrote final snapshot with {:d} sessions", count);
+  } catch (const std::exception & ex) {
+    LOG(logger::ERROR, "Snapshot::~Snapshot: could not write final snapshot: {}", ex.what());
+  }
+}
+
+void Snapshot::writeOnce() {
+  try {
+    auto start = std::chrono::steady_clock::now();
+    auto count = write(mPath, mStore);
+    LOG(logger::INFO,
+        "Snapshot::writeOnce: wrote {:d} sessions in {:d}ms",
+        count,
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+  } catch (const std::exception & ex) {
+    LOG(logger::ERROR, "Snapshot::writeOnce: could not write snapshot: {}", ex.what());
+  }
+}
+
+std::size_t Snapshot::write(const std::string & path, SessionStore & store) {
+  auto temporaryPath = path + ".tmp";
+  std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+  if (!stream.is_open()) {
+    throw std::runtime_error(fmt::format("could not open \"{:s}\" for writing", temporaryPath));
+  }
+
+  std::string buffer;
+  buffer.append(MAGIC.data(), MAGIC.size());
+  append(buffer, VERSION);
+  append(buffer, std::uint64_t{0});
+  stream.write(buffer.data(), buffer.size());
+
+  // Serialize each shard into memory under its lock, and only then touch the file
+  std::uint64_t count{0};
+  for (std::size_t shard = 0; shard < SessionStore::SHARDS; ++shard) {
+    buffer.clear();
+    store.forEach(shard, [&buffer, &count](const std::string & key, const std::string & value, std::time_t expiry) {
+      append(buffer, static_cast<std::int64_t>(expiry));
+      append(buffer, static_cast<std::uint16_t>(key.size()));
+      append(buffer, static_cast<std::uint16_t>(value.size()));
+      buffer.append(key);
+      buffer.append(value);
+      ++count;
+    });
+    stream.write(buffer.data(), buffer.size());
+  }
+
+  stream.seekp(MAGIC.size() + sizeof(VERSION));
+  stream.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  stream.close();
+
+  if (!stream) {
+    throw std::runtime_error(fmt::format("failed writing \"{:s}\"", temporaryPath));
+  }
+
+  if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+    throw std::runtime_error(fmt::format("could not move \"{:s}\" into \"{:s}\"", temporaryPath, path));
+  }
+
+  return count;
+}
+
+std::size_t Snapshot::read(const std::string & path, std::time_t now, const Callback & callback) {
+  auto file = ::open(path.c_str(), O_RDONLY);
+  if (file < 0) {
+    throw std::runtime_error(fmt::format("could not open \"{:s}\"", path));
+  }
+
+  struct stat status{};
+  if (::fstat(file, &status) != 0 || static_cast<std::size_t>(status.st_size) < HEADER_SIZE) {
+    ::close(file);
+    throw std::runtime_error("file too small to be a snapshot");
+  }
+
+  auto size = static_cast<std::size_t>(status.st_size);
+  auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+  ::close(file);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("could not map \"{:s}\"", path));
+  }
+  ::madvise(mapping, size, MADV_SEQUENTIAL);
+
+  auto begin = static_cast<const char *>(mapping);
+  auto end = begin + size;
+
+  if (std::memcmp(begin, MAGIC.data(), MAGIC.size()) != 0
+      || load<std::uint32_t>(begin + MAGIC.size()) != VERSION) {
+    ::munmap(mapping, size);
+    throw std::runtime_error("invalid snapshot header");
+  }
+
+  auto expected = load<std::uint64_t>(begin + MAGIC.size() + sizeof(VERSION));
+  auto cursor = begin + HEADER_SIZE;
+  std::uint64_t records{0};
+  std::size_t count{0};
+
+  while (records < expected) {
+    if (static_cast<std::size_t>(end - cursor) < RECORD_SIZE) break;
+
+    auto expiry = static_cast<std::time_t>(load<std::int64_t>(cursor));
+    auto keyLength = load<std::uint16_t>(cursor + sizeof(std::int64_t));
+    auto valueLength = load<std::uint16_t>(cursor + sizeof(std::int64_t) + sizeof(std::uint16_t));
+    cursor += RECORD_SIZE;
+
+    if (static_cast<std::size_t>(end - cursor) < static_cast<std::size_t>(keyLength) + valueLength) break;
+
+    if (expiry > now) {
+      callback({cursor, keyLength}, {cursor + keyLength, valueLength}, expiry);
+      ++count;
+    }
+
+    cursor += keyLength + valueLength;
+    ++records;
+  }
+
+  ::munmap(mapping, size);
+
+  if (records < expected) {
+    LOG(logger::WARN, "Snapshot::read: \"{:s}\" is truncated. Read {:d} out of {:d} records", path, records, expected);
+  }
+
+  return count;
+}
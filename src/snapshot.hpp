@@ -0,0 +1,81 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <chrono>
+#include <ctime>
+
+#include "config.hpp"
+#include "file_lock.hpp"
+#include "periodic.hpp"
+#include "session_store.hpp"
+
+/**
+ * Periodic binary snapshot of the session store, used to warm up after a restart
+ *
+ * File layout (host byte order):
+ * Header: magic (4 bytes) | version (uint32) | record count (uint64)
+ * Record: expiry (int64) | key length (uint16) | value length (uint16) | key | value
+ *
+ * The snapshot is written by a background thread into a temporary file, one store shard
+ * at a time, and then atomically renamed over the previous one. On startup the file is
+ * memory-mapped and bulk-loaded into the store and into the cache with pipelined writes.
+ * A lock file next to it keeps an instance taking over on upgrade from loading the snapshot
+ * before the old one has written its last, or writing it alongside
+ */
+class Snapshot {
+private:
+
+  const std::string mPath;
+  const std::chrono::seconds mInterval;
+  SessionStore & mStore;
+  std::optional<FileLock> mLock;
+  std::optional<Periodic> mWriter;
+
+  void writeOnce();
+
+public:
+
+  using Callback = std::function<void(std::string_view key, std::string_view value, std::time_t expiry)>;
+
+  /**
+   * Restores the last snapshot, if any, and starts the periodic writer
+   *
+   * Does nothing if the store is not enabled. Waits for any other instance holding the
+   * snapshot to exit
+   */
+  Snapshot(const Config::Cache & config, SessionStore & store);
+
+  /**
+   * Stops the writer and takes a final snapshot
+   */
+  ~Snapshot();
+
+  /**
+   * Writes the whole store into `path`
+   *
+   * @return the number of sessions written
+   * @throws runtime_error if the file cannot be written
+   */
+  static std::size_t write(const std::string & path, SessionStore & store);
+
+  /**
+   * Memory-maps `path` and hands every session not yet expired at `now` to `callback`
+   *
+   * A truncated or corrupted file is read up to the first bad record
+   *
+   * @return the number of sessions read
+   * @throws runtime_error if the file cannot be mapped or has an invalid header
+   */
+  static std::size_t read(const std::string & path, std::time_t now, const Callback & callback);
+
+  Snapshot(const Snapshot &) = delete;
+  Snapshot(Snapshot &&) = delete;
+  void operator=(const Snapshot &) = delete;
+};
@@ -0,0 +1,253 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "spill_journal.hpp"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "logger.hpp"
+
+namespace {
+  constexpr char MAGIC[4] = {'R', 'C', 'S', 'J'};
+  constexpr std::uint32_t VERSION = 1;
+  constexpr std::size_t END_OFFSET = sizeof(MAGIC) + sizeof(VERSION);
+  constexpr std::size_t REPLAY_BATCH = 1024;
+  constexpr std::chrono::seconds REPLAY_INTERVAL{1};
+  constexpr std::size_t CATCH_UP_ROUNDS = 4;
+}
+
+SpillJournal::SpillJournal(const Config::Cache & config)
+    : mPath{config.spillFile},
+      mTTL{config.ttl},
+      mCapacity{static_cast<std::size_t>(config.spillSizeMegabytes) * 1024 * 1024} {
+  if (mPath.empty()) {
+    LOG(logger::LOG, "SpillJournal: no SPILL_FILE. Running without spilling");
+    return;
+  }
+
+  auto disable = [this](const char * what) {
+    LOG(logger::WARN, "SpillJournal: could not {:s} \"{:s}\": {:s}. Running without spilling",
+        what, mPath, std::strerror(errno));
+  };
+
+  auto file = ::open(mPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (file < 0) {
+    disable("open");
+    return;
+  }
+  mLock.emplace(mPath, "SpillJournal");
+
+  struct stat status{};
+  if (::fstat(file, &status) != 0) {
+    disable("stat");
+    ::close(file);
+    return;
+  }
+
+  // Never shrink a journal that was left over with a larger capacity
+  mCapacity = std::max(mCapacity, static_cast<std::size_t>(status.st_size));
+  if (static_cast<std::size_t>(status.st_size) < mCapacity && ::ftruncate(file, mCapacity) != 0) {
+    disable("allocate");
+    ::close(file);
+    return;
+  }
+
+  auto mapping = ::mmap(nullptr, mCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+  if (mapping == MAP_FAILED) {
+    disable("map");
+    ::close(file);
+    return;
+  }
+  ::close(file);
+  mData = static_cast<char *>(mapping);
+
+  if (std::memcmp(mData, MAGIC, sizeof(MAGIC)) != 0
+      || std::memcmp(mData + sizeof(MAGIC), &VERSION, sizeof(VERSION)) != 0
+      || end() < HEADER_SIZE
+      || end() > mCapacity) {
+    std::memcpy(mData, MAGIC, sizeof(MAGIC));
+    std::memcpy(mData + sizeof(MAGIC), &VERSION, sizeof(VERSION));
+    setEnd(HEADER_SIZE);
+  }
+
+  if (end() > HEADER_SIZE) {
+    LOG(logger::LOG, "SpillJournal: found {:d} bytes of spilled mutations in \"{:s}\"", end() - HEADER_SIZE, mPath);
+    mActive = true;
+  }
+}
+
+SpillJournal::~SpillJournal() {
+  if (mData) {
+    ::munmap(mData, mCapacity);
+  }
+}
+
+std::size_t SpillJournal::end() const {
+  std::uint64_t end;
+  std::memcpy(&end, mData + END_OFFSET, sizeof(end));
+  return static_cast<std::size_t>(end);
+}
+
+void SpillJournal::setEnd(std::size_t end) {
+  auto value = static_cast<std::uint64_t>(end);
+  std::memcpy(mData + END_OFFSET, &value, sizeof(value));
+}
+
+bool SpillJournal::append(Operation operation,
+                          const std::string & key,
+                          const std::string & value,
+                          std::time_t expiry) {
+  if (!enabled()) {
+    if (mDropped.fetch_add(1, std::memory_order_relaxed) == 0) {
+      LOG(logger::ERROR, "SpillJournal::append: no journal. Dropping mutations");
+    }
+    return false;
+  }
+
+  auto recordSize = RECORD_SIZE + key.size() + value.size();
+
+  std::unique_lock<std::mutex> lock{mMutex};
+  auto cursor = end();
+  if (cursor + recordSize > mCapacity) {
+    lock.unlock();
+    if (mDropped.fetch_add(1, std::memory_order_relaxed) == 0) {
+      LOG(logger::ERROR, "SpillJournal::append: journal is full. Dropping mutations");
+    }
+    return false;
+  }
+
+  auto keyLength = static_cast<std::uint16_t>(key.size());
+  auto valueLength = static_cast<std::uint16_t>(value.size());
+  auto expiry64 = static_cast<std::int64_t>(expiry);
+
+  mData[cursor] = operation;
+  mData[cursor + 1] = 0;
+  std::memcpy(mData + cursor + 2, &keyLength, sizeof(keyLength));
+  std::memcpy(mData + cursor + 4, &valueLength, sizeof(valueLength));
+  std::memcpy(mData + cursor + 6, &expiry64, sizeof(expiry64));
+  std::memcpy(mData + cursor + RECORD_SIZE, key.data(), key.size());
+  std::memcpy(mData + cursor + RECORD_SIZE + key.size(), value.data(), value.size());
+
+  // Only publish the record once it is whole
+  setEnd(cursor + recordSize);
+  mActive.store(true, std::memory_order_release);
+
+  return true;
+}
+
+bool SpillJournal::set(const std::string & key, const std::string & value, std::time_t now) {
+  return append(SET, key, value, now + mTTL.load(std::memory_order_relaxed));
+}
+
+bool SpillJournal::remove(const std::string & key) {
+  return append(REMOVE, key, {}, 0);
+}
+
+std::size_t SpillJournal::size() const {
+  if (!enabled()) {
+    return 0;
+  }
+  std::unique_lock<std::mutex> lock{mMutex};
+  return end() - HEADER_SIZE;
+}
+
+std::unordered_map<std::string_view, SpillJournal::Entry> SpillJournal::collect(std::size_t stop) const {
+  std::unordered_map<std::string_view, Entry> latest;
+  auto cursor = HEADER_SIZE;
+  while (cursor < stop) {
+    std::uint16_t keyLength;
+    std::uint16_t valueLength;
+    std::int64_t expiry;
+    std::memcpy(&keyLength, mData + cursor + 2, sizeof(keyLength));
+    std::memcpy(&valueLength, mData + cursor + 4, sizeof(valueLength));
+    std::memcpy(&expiry, mData + cursor + 6, sizeof(expiry));
+
+    std::string_view key{mData + cursor + RECORD_SIZE, keyLength};
+    latest[key] = {static_cast<Operation>(mData[cursor]),
+                   key,
+                   {mData + cursor + RECORD_SIZE + keyLength, valueLength},
+                   static_cast<std::time_t>(expiry)};
+
+    cursor += RECORD_SIZE + keyLength + valueLength;
+  }
+  return latest;
+}
+
+void SpillJournal::deactivate() {
+  mActive.store(false, std::memory_order_release);
+  auto dropped = mDropped.exchange(0, std::memory_order_relaxed);
+  if (dropped > 0) {
+    LOG(logger::ERROR, "SpillJournal::deactivate: {:d} mutations were dropped while the journal was full", dropped);
+  }
+}
+
+void SpillJournal::consume(std::size_t offset) {
+  std::unique_lock<std::mutex> lock{mMutex};
+  auto current = end();
+  std::memmove(mData + HEADER_SIZE, mData + offset, current - offset);
+  setEnd(HEADER_SIZE + current - offset);
+
+  if (current == offset) {
+    deactivate();
+  }
+}
+
+SpillReplayer::SpillReplayer(const Config::Cache & config, SpillJournal & journal)
+    : mJournal{journal},
+      mCache{config, true},
+      mThread{REPLAY_INTERVAL, [this]() { replayOnce(); }} {}
+
+void SpillReplayer::replayOnce() {
+  if (!mJournal.active()) {
+    return;
+  }
+
+  auto now = std::time(nullptr);
+  std::size_t pending{0};
+  std::size_t replayed{0};
+
+  auto send = [&](const SpillJournal::Entry & entry) {
+    std::string key{entry.key};
+    if (entry.operation == SpillJournal::SET) {
+      if (entry.expiry > now) {
+        mCache.set(key, std::string{entry.value}, entry.expiry - now);
+      }
+    } else {
+      mCache.remove(key);
+    }
+
+    ++replayed;
+    if (++pending == REPLAY_BATCH) {
+      pending = 0;
+      return mCache.flush();
+    }
+    return true;
+  };
+
+  // Each round only has what was spilled during the one before, which shrinks as the cache keeps up
+  for (std::size_t round = 0; mJournal.active(); ++round) {
+    pending = 0;
+    if (round == CATCH_UP_ROUNDS) {
+      if (!mJournal.drain(send, [this]() { return mCache.flush(); })) {
+        LOG(logger::INFO, "SpillReplayer::replayOnce: cache still unavailable. Retrying in {:d}s", REPLAY_INTERVAL.count());
+        return;
+      }
+      break;
+    }
+
+    auto offset = mJournal.replay(send);
+    if (offset == 0 || !mCache.flush()) {
+      LOG(logger::INFO, "SpillReplayer::replayOnce: cache still unavailable. Retrying in {:d}s", REPLAY_INTERVAL.count());
+      return;
+    }
+    mJournal.consume(offset);
+  }
+
+  LOG(logger::LOG, "SpillReplayer::replayOnce: replayed {:d} spilled mutations", replayed);
+}
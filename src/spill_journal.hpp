@@ -0,0 +1,239 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <unordered_map>
+#include <cstring>
+#include <ctime>
+
+#include "config.hpp"
+#include "cache.hpp"
+#include "file_lock.hpp"
+#include "periodic.hpp"
+
+/**
+ * Bounded, append-only journal for cache mutations that could not be delivered
+ *
+ * The journal is a memory-mapped file, so spilled mutations survive a restart of the cacher.
+ * Appending is a memcpy under a lock and never touches the network, which keeps the receive
+ * path unblocked while the cache is down. When the journal is full, new mutations are dropped.
+ *
+ * While the journal holds anything, all mutations should be spilled rather than sent directly,
+ * so that a replay never overwrites a newer value with an older one.
+ *
+ * Without a file, or with one that cannot be mapped, every spilled mutation is dropped and counted.
+ *
+ * The file is locked while mapped, since the lock above only covers this process: an instance
+ * taking over on upgrade waits for the old one to let go of it
+ *
+ * File layout (host byte order):
+ * Header: magic (4 bytes) | version (uint32) | end offset (uint64)
+ * Record: operation (uint8) | padding (uint8) | key length (uint16) | value length (uint16) |
+ *         expiry (int64) | key | value
+ */
+class SpillJournal {
+public:
+
+  enum Operation : std::uint8_t {
+    SET = 1,
+    REMOVE = 2
+  };
+
+  struct Entry {
+    Operation operation;
+    std::string_view key;
+    std::string_view value;
+    std::time_t expiry;
+  };
+
+private:
+
+  static constexpr std::size_t HEADER_SIZE = 4 + sizeof(std::uint32_t) + sizeof(std::uint64_t);
+  static constexpr std::size_t RECORD_SIZE = 2 * sizeof(std::uint8_t) + 2 * sizeof(std::uint16_t) + sizeof(std::int64_t);
+
+  const std::string mPath;
+  std::optional<FileLock> mLock;
+  std::atomic<std::time_t> mTTL;
+  std::size_t mCapacity;
+  char * mData{nullptr};
+
+  mutable std::mutex mMutex;
+  std::atomic<bool> mActive{false};
+  std::atomic<std::size_t> mDropped{0};
+
+  std::size_t end() const;
+  void setEnd(std::size_t end);
+
+  /**
+   * The latest record of every key before `stop`
+   */
+  std::unordered_map<std::string_view, Entry> collect(std::size_t stop) const;
+
+  /**
+   * Marks the journal as drained, reporting what was dropped meanwhile. Called under the lock
+   */
+  void deactivate();
+
+  bool append(Operation operation, const std::string & key, const std::string & value, std::time_t expiry);
+
+public:
+
+  /**
+   * Maps the journal file, creating it if needed. Records left over from a previous run are kept
+   *
+   * Waits for any other instance holding the file to exit. Left disabled if SPILL_FILE is empty
+   * or cannot be mapped, which is logged
+   */
+  explicit SpillJournal(const Config::Cache & config);
+  ~SpillJournal();
+
+  /**
+   * Whether the file is mapped, so that mutations can be spilled at all
+   */
+  bool enabled() const {
+    return mData != nullptr;
+  }
+
+  /**
+   * Spills a SET, expiring TTL seconds from `now`
+   *
+   * @return false if the journal is full or disabled and the mutation was dropped
+   */
+  bool set(const std::string & key, const std::string & value, std::time_t now = std::time(nullptr));
+
+  /**
+   * Spills a REMOVE
+   *
+   * @return false if the journal is full or disabled and the mutation was dropped
+   */
+  bool remove(const std::string & key);
+
+  /**
+   * Whether there are spilled mutations still waiting for replay
+   */
+  bool active() const {
+    return mActive.load(std::memory_order_acquire);
+  }
+
+  std::size_t dropped() const {
+    return mDropped.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Changes the TTL of the mutations spilled from now on
+   */
+  void setTtl(std::time_t ttl) {
+    mTTL.store(ttl, std::memory_order_relaxed);
+  }
+
+  /**
+   * Number of bytes used by spilled records
+   */
+  std::size_t size() const;
+
+  /**
+   * Hands the latest mutation of every spilled key to `callback`
+   *
+   * Only the records present at the start of the call are visited, and the views are valid until
+   * `consume` is called. Mutations spilled concurrently are left for the next replay
+   *
+   * @tparam C callable taking (const Entry &), returning false to abort
+   * @return the offset to pass to `consume`, or 0 if aborted
+   */
+  template <typename C>
+  std::size_t replay(C callback) const;
+
+  /**
+   * Discards every record up to `offset`, as returned by `replay`
+   *
+   * The journal becomes inactive if nothing else was spilled in the meantime
+   */
+  void consume(std::size_t offset);
+
+  /**
+   * Hands the latest mutation of every spilled key to `callback`, then `flush`es and discards them,
+   * with spilling held off throughout so that the journal is certain to become inactive
+   *
+   * Meant for the short tail that replays keep leaving behind under sustained load, since the
+   * receive path waits for it
+   *
+   * @tparam C callable taking (const Entry &), returning false to abort
+   * @tparam F callable returning whether what `callback` was given reached the cache
+   * @return false if aborted or not flushed, leaving the journal untouched
+   */
+  template <typename C, typename F>
+  bool drain(C callback, F flush);
+
+  SpillJournal(const SpillJournal &) = delete;
+  SpillJournal(SpillJournal &&) = delete;
+  void operator=(const SpillJournal &) = delete;
+};
+
+template <typename C>
+std::size_t SpillJournal::replay(C callback) const {
+  std::size_t stop;
+  {
+    std::unique_lock<std::mutex> lock{mMutex};
+    stop = end();
+  }
+
+  // Records before `stop` are immutable until consumed, so they can be read without the lock
+  for (const auto & entry : collect(stop)) {
+    if (!callback(entry.second)) {
+      return 0;
+    }
+  }
+
+  return stop;
+}
+
+template <typename C, typename F>
+bool SpillJournal::drain(C callback, F flush) {
+  std::unique_lock<std::mutex> lock{mMutex};
+  for (const auto & entry : collect(end())) {
+    if (!callback(entry.second)) {
+      return false;
+    }
+  }
+  if (!flush()) {
+    return false;
+  }
+
+  setEnd(HEADER_SIZE);
+  deactivate();
+  return true;
+}
+
+/**
+ * Drains the journal into the cache in pipelined batches whenever it holds anything
+ *
+ * A batch whose flush fails leaves the journal untouched, and the whole replay is retried
+ * on the next tick. Replaying is idempotent, since only the latest mutation of each key is sent.
+ *
+ * Mutations keep being spilled during a replay, so it is repeated on what they left, and after a
+ * few rounds the last of them is drained with spilling held off
+ */
+class SpillReplayer {
+private:
+
+  SpillJournal & mJournal;
+  Cache mCache;
+  Periodic mThread;
+
+  void replayOnce();
+
+public:
+
+  SpillReplayer(const Config::Cache & config, SpillJournal & journal);
+
+  SpillReplayer(const SpillReplayer &) = delete;
+  SpillReplayer(SpillReplayer &&) = delete;
+  void operator=(const SpillReplayer &) = delete;
+};
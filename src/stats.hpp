@@ -0,0 +1,69 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+#include <fmt/format.h>
+
+#include "action.hpp"
+
+/**
+ * Process-wide counters, updated with relaxed atomics from the packet threads
+ */
+class Stats {
+private:
+
+  using Counters = std::array<std::atomic<std::uint64_t>, Action::TYPES>;
+
+  Counters mKept{};
+  Counters mShed{};
+
+public:
+
+  /**
+   * Counts an action that was carried out
+   */
+  void kept(Action::ActionType action) {
+    mKept[action].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Counts an action that was dropped to relieve a degraded cache
+   */
+  void shed(Action::ActionType action) {
+    mShed[action].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::uint64_t kept(Action::ActionType action) const {
+    return mKept[action].load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t shed(Action::ActionType action) const {
+    return mShed[action].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * One line per counter, as `<name> <value>`
+   */
+  std::string report() const {
+    std::string report;
+    for (std::size_t i = 0; i < Action::TYPES; ++i) {
+      auto action = static_cast<Action::ActionType>(i);
+      report += fmt::format("kept.{:s} {:d}\nshed.{:s} {:d}\n",
+                            Action::name(action), kept(action),
+                            Action::name(action), shed(action));
+    }
+    return report;
+  }
+
+  Stats() = default;
+  Stats(const Stats &) = delete;
+  Stats(Stats &&) = delete;
+  void operator=(const Stats &) = delete;
+};
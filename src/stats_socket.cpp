@@ -0,0 +1,49 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "stats_socket.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "logger.hpp"
+
+namespace {
+  // Reports are small, so only a client that stopped reading can hold the thread up this long
+  constexpr timeval SEND_TIMEOUT{1, 0};
+}
+
+StatsSocket::StatsSocket(std::string path, std::function<std::string()> report)
+    : mPath{std::move(path)},
+      mReport{std::move(report)} {
+  if (mPath.empty()) {
+    return;
+  }
+
+  mListener.emplace(mPath, "StatsSocket", 8, [this](int client) {
+    serve(client);
+    return true;
+  });
+  LOG(logger::LOG, "StatsSocket: serving stats on {:s}", mPath);
+}
+
+void StatsSocket::serve(int client) const {
+  ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &SEND_TIMEOUT, sizeof(SEND_TIMEOUT));
+
+  auto report = mReport();
+  for (std::size_t sent = 0; sent < report.size();) {
+    auto bytes = ::send(client, report.data() + sent, report.size() - sent, MSG_NOSIGNAL);
+    if (bytes < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(logger::DEBUG, "StatsSocket::serve: client went away: {:s}", std::strerror(errno));
+      break;
+    }
+    sent += static_cast<std::size_t>(bytes);
+  }
+}
@@ -0,0 +1,44 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+
+#include "unix_listener.hpp"
+
+/**
+ * Local query point for the stats
+ *
+ * Listens on a Unix stream socket and answers every connection with the current report before
+ * closing it, so that `nc -U <path>` or `socat - UNIX-CONNECT:<path>` print the stats on demand.
+ * Connections are served one at a time on a thread of its own, away from the packet threads, and
+ * one that stops reading is given up on
+ */
+class StatsSocket {
+private:
+
+  const std::string mPath;
+  const std::function<std::string()> mReport;
+  std::optional<UnixListener> mListener;
+
+  void serve(int client) const;
+
+public:
+
+  /**
+   * @param path where to create the socket, replacing any socket left there. Empty disables it.
+   * A successor taking over on upgrade replaces it too, and keeps it once this one is gone
+   * @param report builds the report sent to each connection
+   * @throws runtime_error the socket could not be created
+   */
+  StatsSocket(std::string path, std::function<std::string()> report);
+
+  ~StatsSocket() = default;
+  StatsSocket(const StatsSocket &) = delete;
+  StatsSocket(StatsSocket &&) = delete;
+  void operator=(const StatsSocket &) = delete;
+};
@@ -0,0 +1,229 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * Hierarchical timing wheel for second-resolution expiries
+ *
+ * Four levels of 64 slots each cover 2^24 seconds (~194 days). Entries further away than that
+ * are parked on the last slot of the top level and re-evaluated when they cascade down.
+ *
+ * Entries live in a pooled node vector and are linked intrusively into their slot, so insert,
+ * refresh and remove are O(1). Every entry cascades at most once per level, which makes expiry
+ * amortised O(1) as well.
+ *
+ * Not thread-safe; the owner must serialize access
+ *
+ * @tparam T the payload handed back on expiry
+ */
+template <typename T>
+class TimerWheel {
+public:
+  using Handle = std::uint32_t;
+  static constexpr Handle INVALID = std::numeric_limits<Handle>::max();
+
+private:
+  static constexpr unsigned int BITS = 6;
+  static constexpr unsigned int SLOTS = 1u << BITS;
+  static constexpr unsigned int LEVELS = 4;
+  static constexpr std::time_t MASK = SLOTS - 1;
+
+  struct Node {
+    T value;
+    std::time_t expiry;
+    Handle previous;
+    Handle next;
+    std::uint16_t slot;
+  };
+
+  std::vector<Node> mNodes{};
+  std::array<Handle, SLOTS * LEVELS> mSlots;
+  Handle mFree{INVALID};
+  std::size_t mSize{0};
+
+  // Next tick to be processed
+  std::time_t mNow;
+  bool mCascaded{false};
+
+  /**
+   * Finds the slot for an expiry relative to the current tick
+   *
+   * The chosen level is the lowest one in which the expiry is less than a full revolution away
+   */
+  std::uint16_t slotFor(std::time_t expiry) const {
+    if (expiry <= mNow) {
+      return static_cast<std::uint16_t>(mNow & MASK);
+    }
+
+    for (unsigned int level = 0; level < LEVELS; ++level) {
+      auto shift = BITS * level;
+      if ((expiry >> shift) - (mNow >> shift) < static_cast<std::time_t>(SLOTS)) {
+        return static_cast<std::uint16_t>(level * SLOTS + ((expiry >> shift) & MASK));
+      }
+    }
+
+    // Beyond the horizon: park it as far as the top level reaches
+    auto shift = BITS * (LEVELS - 1);
+    return static_cast<std::uint16_t>((LEVELS - 1) * SLOTS + (((mNow >> shift) + MASK) & MASK));
+  }
+
+  void link(Handle handle) {
+    auto & node = mNodes[handle];
+    node.slot = slotFor(node.expiry);
+    node.previous = INVALID;
+    node.next = mSlots[node.slot];
+    if (node.next != INVALID) {
+      mNodes[node.next].previous = handle;
+    }
+    mSlots[node.slot] = handle;
+  }
+
+  void unlink(Handle handle) {
+    auto & node = mNodes[handle];
+    if (node.previous != INVALID) {
+      mNodes[node.previous].next = node.next;
+    } else {
+      mSlots[node.slot] = node.next;
+    }
+    if (node.next != INVALID) {
+      mNodes[node.next].previous = node.previous;
+    }
+  }
+
+  void release(Handle handle) {
+    mNodes[handle].next = mFree;
+    mFree = handle;
+    --mSize;
+  }
+
+  /**
+   * Redistributes the higher level slots whose revolution starts at the current tick
+   */
+  void cascade() {
+    for (unsigned int level = LEVELS - 1; level > 0; --level) {
+      auto shift = BITS * level;
+      if ((mNow & ((std::time_t{1} << shift) - 1)) != 0) {
+        continue;
+      }
+
+      auto & head = mSlots[level * SLOTS + ((mNow >> shift) & MASK)];
+      auto handle = head;
+      head = INVALID;
+      while (handle != INVALID) {
+        auto next = mNodes[handle].next;
+        link(handle);
+        handle = next;
+      }
+    }
+  }
+
+public:
+
+  explicit TimerWheel(std::time_t now)
+      : mNow{now} {
+    mSlots.fill(INVALID);
+  }
+
+  /**
+   * Schedules a new entry
+   *
+   * @param value the payload to return on expiry
+   * @param expiry the absolute second at which the entry expires
+   * @return a handle to refresh or remove the entry
+   */
+  Handle insert(T value, std::time_t expiry) {
+    Handle handle;
+    if (mFree != INVALID) {
+      handle = mFree;
+      mFree = mNodes[handle].next;
+      mNodes[handle].value = std::move(value);
+      mNodes[handle].expiry = expiry;
+    } else {
+      handle = static_cast<Handle>(mNodes.size());
+      mNodes.push_back({std::move(value), expiry, INVALID, INVALID, 0});
+    }
+
+    ++mSize;
+    link(handle);
+    return handle;
+  }
+
+  /**
+   * Moves an existing entry to a new expiry
+   */
+  void refresh(Handle handle, std::time_t expiry) {
+    unlink(handle);
+    mNodes[handle].expiry = expiry;
+    link(handle);
+  }
+
+  /**
+   * Removes an entry without triggering expiry
+   */
+  void remove(Handle handle) {
+    unlink(handle);
+    release(handle);
+  }
+
+  const T & value(Handle handle) const {
+    return mNodes[handle].value;
+  }
+
+  std::time_t expiry(Handle handle) const {
+    return mNodes[handle].expiry;
+  }
+
+  std::size_t size() const {
+    return mSize;
+  }
+
+  /**
+   * Expires entries up to and including `now`, handing each payload to `callback`
+   *
+   * At most `budget` entries are expired per call. Whatever is left over is picked up
+   * by the next call, so a burst of expiries is spread across several calls
+   *
+   * @tparam C callable taking T &&
+   * @param now the current second
+   * @param budget maximum number of entries to expire
+   * @param callback called for each expired entry
+   * @return the number of expired entries
+   */
+  template <typename C>
+  std::size_t advance(std::time_t now, std::size_t budget, C callback) {
+    std::size_t expired{0};
+
+    while (mNow <= now) {
+      if (!mCascaded) {
+        cascade();
+        mCascaded = true;
+      }
+
+      auto & head = mSlots[mNow & MASK];
+      while (head != INVALID) {
+        if (expired == budget) {
+          return expired;
+        }
+
+        auto handle = head;
+        unlink(handle);
+        callback(std::move(mNodes[handle].value));
+        release(handle);
+        ++expired;
+      }
+
+      ++mNow;
+      mCascaded = false;
+    }
+
+    return expired;
+  }
+};
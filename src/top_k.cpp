@@ -0,0 +1,73 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "top_k.hpp"
+
+#include <algorithm>
+
+#include <fmt/format.h>
+
+TopK::TopK(std::size_t size)
+    : mSize{size},
+      mCounters{std::make_unique<std::array<std::atomic<std::uint32_t>, DEPTH * WIDTH>>()} {
+  mCurrent.reserve(size);
+}
+
+void TopK::offer(std::size_t hash, std::uint32_t estimate, const std::function<std::string()> & name) {
+  // Heavy items come back often: losing one offer to another thread costs nothing
+  std::unique_lock<std::mutex> lock{mMutex, std::try_to_lock};
+  if (!lock) {
+    return;
+  }
+
+  auto found = std::find_if(mCurrent.begin(), mCurrent.end(), [hash](const Entry & entry) {
+    return entry.hash == hash;
+  });
+
+  if (found != mCurrent.end()) {
+    found->count = std::max(found->count, estimate);
+  } else if (mCurrent.size() < mSize) {
+    mCurrent.push_back({hash, name(), estimate});
+  } else {
+    auto lightest = std::min_element(mCurrent.begin(), mCurrent.end(), [](const Entry & left, const Entry & right) {
+      return left.count < right.count;
+    });
+    if (estimate <= lightest->count) {
+      return;
+    }
+    *lightest = {hash, name(), estimate};
+  }
+
+  if (mCurrent.size() == mSize) {
+    auto lightest = std::min_element(mCurrent.begin(), mCurrent.end(), [](const Entry & left, const Entry & right) {
+      return left.count < right.count;
+    });
+    mThreshold.store(lightest->count, std::memory_order_relaxed);
+  }
+}
+
+void TopK::rotate() {
+  std::lock_guard<std::mutex> lock{mMutex};
+
+  // Increments racing with the reset only blur the edge between two windows
+  for (auto & counter : *mCounters) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+  mThreshold.store(0, std::memory_order_relaxed);
+
+  std::sort(mCurrent.begin(), mCurrent.end(), [](const Entry & left, const Entry & right) {
+    return left.count > right.count;
+  });
+  mLast.swap(mCurrent);
+  mCurrent.clear();
+}
+
+std::string TopK::report(const char * label) const {
+  std::lock_guard<std::mutex> lock{mMutex};
+  std::string report;
+  for (const auto & entry : mLast) {
+    report += fmt::format("top.{:s}.{:s} {:d}\n", label, entry.name, entry.count);
+  }
+  return report;
+}
@@ -0,0 +1,96 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Approximate heaviest hitters of a stream, in bounded memory
+ *
+ * Every item is counted in a Count-Min sketch of relaxed atomic counters, which never
+ * underestimates and overestimates by little for the heavy items. Only items whose estimate beats
+ * the lightest of the current top are offered to it, under a lock that is skipped if already held,
+ * so the hot path is a handful of relaxed increments and one relaxed load.
+ *
+ * Counts are per window: rotate() publishes the top of the window that just ended and starts a new
+ * one, so the report tells what is heavy now and not since the start
+ */
+class TopK {
+private:
+
+  static constexpr std::size_t DEPTH = 4;
+  static constexpr std::size_t WIDTH = 4096;
+
+  struct Entry {
+    std::size_t hash;
+    std::string name;
+    std::uint32_t count;
+  };
+
+  const std::size_t mSize;
+  const std::unique_ptr<std::array<std::atomic<std::uint32_t>, DEPTH * WIDTH>> mCounters;
+  std::atomic<std::uint32_t> mThreshold{0};
+  mutable std::mutex mMutex;
+  std::vector<Entry> mCurrent;
+  std::vector<Entry> mLast;
+
+  void offer(std::size_t hash, std::uint32_t estimate, const std::function<std::string()> & name);
+
+public:
+
+  /**
+   * @param size how many of the heaviest items to keep, none disabling the counting
+   */
+  explicit TopK(std::size_t size);
+
+  /**
+   * Counts an occurrence of an item
+   *
+   * @tparam F callable returning the name of the item as reported, only called when it makes the top
+   * @param item the bytes identifying the item
+   */
+  template <typename F>
+  void add(std::string_view item, F && name) {
+    if (mSize == 0) {
+      return;
+    }
+
+    auto hash = std::hash<std::string_view>{}(item);
+    auto step = (hash >> 32u) | 1u;
+
+    auto estimate = ~std::uint32_t{0};
+    for (std::size_t row = 0; row < DEPTH; ++row) {
+      auto & counter = (*mCounters)[row * WIDTH + (hash + row * step) % WIDTH];
+      estimate = std::min(estimate, counter.fetch_add(1, std::memory_order_relaxed) + 1);
+    }
+
+    if (estimate > mThreshold.load(std::memory_order_relaxed)) {
+      offer(hash, estimate, name);
+    }
+  }
+
+  /**
+   * Ends the current window: its top becomes the one reported, and counting starts over
+   */
+  void rotate();
+
+  /**
+   * The top of the last window, heaviest first, one line each as `top.<label>.<name> <count>`
+   */
+  std::string report(const char * label) const;
+
+  TopK(const TopK &) = delete;
+  TopK(TopK &&) = delete;
+  void operator=(const TopK &) = delete;
+};
@@ -0,0 +1,103 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "unix_listener.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "logger.hpp"
+
+sockaddr_un UnixListener::toAddress(const std::string & path, const char * owner) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error(fmt::format("{:s}: path too long \"{:s}\"", owner, path));
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  return address;
+}
+
+UnixListener::UnixListener(std::string path, const char * owner, int backlog, std::function<bool(int client)> handle)
+    : mPath{std::move(path)},
+      mOwner{owner},
+      mHandle{std::move(handle)} {
+  auto address = toAddress(mPath, mOwner);
+  mSocket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  mWakeUp = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  // Either left behind by a crash, or by the process this one takes over from, which keeps its
+  // listener open but unreachable until it exits
+  ::unlink(mPath.c_str());
+  struct stat status{};
+  if (mSocket < 0
+      || mWakeUp < 0
+      || ::bind(mSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+      || ::listen(mSocket, backlog) != 0
+      || ::stat(mPath.c_str(), &status) != 0) {
+    auto error = errno;
+    if (mSocket >= 0) ::close(mSocket);
+    if (mWakeUp >= 0) ::close(mWakeUp);
+    throw std::runtime_error(fmt::format("{:s}: could not listen on \"{:s}\": {:s}", mOwner, mPath, std::strerror(error)));
+  }
+  mInode = status.st_ino;
+
+  mThread = std::thread{&UnixListener::serve, this};
+}
+
+UnixListener::~UnixListener() {
+  std::uint64_t one{1};
+  if (::write(mWakeUp, &one, sizeof(one)) < 0) {
+    LOG(logger::WARN, "{:s}: could not wake up the server: {:s}", mOwner, std::strerror(errno));
+  }
+  mThread.join();
+
+  ::close(mSocket);
+  ::close(mWakeUp);
+
+  // The path belongs to the successor once it has listened on it
+  struct stat status{};
+  if (::stat(mPath.c_str(), &status) == 0 && status.st_ino == mInode) {
+    ::unlink(mPath.c_str());
+  }
+}
+
+void UnixListener::serve() const {
+  pollfd ready[]{{mSocket, POLLIN, 0}, {mWakeUp, POLLIN, 0}};
+
+  for (;;) {
+    if (::poll(ready, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(logger::ERROR, "{:s}: poll failed: {:s}", mOwner, std::strerror(errno));
+      return;
+    }
+
+    if (ready[1].revents) {
+      return;
+    }
+
+    auto client = ::accept4(mSocket, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+      LOG(logger::WARN, "{:s}: could not accept: {:s}", mOwner, std::strerror(errno));
+      continue;
+    }
+
+    auto more = mHandle(client);
+    ::close(client);
+    if (!more) {
+      return;
+    }
+  }
+}
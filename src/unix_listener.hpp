@@ -0,0 +1,54 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <sys/types.h>
+#include <sys/un.h>
+
+/**
+ * A Unix stream socket served on a thread of its own, one connection at a time
+ *
+ * Whatever is left on the path is replaced. On destruction the path is only removed if it is still
+ * this socket, since a successor taking over on upgrade listens on it while this one winds down
+ */
+class UnixListener {
+private:
+
+  const std::string mPath;
+  const char * const mOwner;
+  const std::function<bool(int)> mHandle;
+  int mSocket{-1};
+  int mWakeUp{-1};
+  ino_t mInode{0};
+  std::thread mThread;
+
+  void serve() const;
+
+public:
+
+  /**
+   * @param owner names the user in errors and logs
+   * @throws runtime_error the path does not fit in an address
+   */
+  static sockaddr_un toAddress(const std::string & path, const char * owner);
+
+  /**
+   * @param path where to create the socket
+   * @param owner names the user in errors and logs
+   * @param backlog connections waiting to be accepted
+   * @param handle called with every client, which is closed once it returns. Returning false stops serving
+   * @throws runtime_error the path cannot be listened on
+   */
+  UnixListener(std::string path, const char * owner, int backlog, std::function<bool(int client)> handle);
+
+  ~UnixListener();
+  UnixListener(const UnixListener &) = delete;
+  UnixListener(UnixListener &&) = delete;
+  void operator=(const UnixListener &) = delete;
+};
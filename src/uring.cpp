@@ -0,0 +1,281 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#include "uring.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+namespace {
+
+  int setup(unsigned entries, io_uring_params & params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+  }
+
+  int enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+  }
+
+  int registerRing(int fd, unsigned opcode, void * argument, unsigned count) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, argument, count));
+  }
+
+  template <typename T>
+  T * at(void * base, unsigned offset) {
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+  }
+}
+
+Uring::Uring(unsigned entries) {
+  io_uring_params params{};
+
+  // Every ring is driven by a single thread, which lets the kernel skip some locking
+  params.flags = IORING_SETUP_SINGLE_ISSUER;
+  mFd = setup(entries, params);
+  if (mFd < 0 && errno == EINVAL) {
+    params = {};
+    mFd = setup(entries, params);
+  }
+  if (mFd < 0) {
+    throw std::runtime_error(fmt::format("Uring: could not set up ring: {:s}", std::strerror(errno)));
+  }
+
+  mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    mSqRingSize = mCqRingSize = std::max(mSqRingSize, mCqRingSize);
+  }
+  mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+  mSqRing = ::mmap(nullptr, mSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFd, IORING_OFF_SQ_RING);
+  if (mSqRing == MAP_FAILED) {
+    mSqRing = nullptr;
+    release();
+    throw std::runtime_error("Uring: could not map submission queue");
+  }
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    mCqRing = mSqRing;
+  } else {
+    mCqRing = ::mmap(nullptr, mCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFd, IORING_OFF_CQ_RING);
+    if (mCqRing == MAP_FAILED) {
+      mCqRing = nullptr;
+      release();
+      throw std::runtime_error("Uring: could not map completion queue");
+    }
+  }
+
+  auto sqes = ::mmap(nullptr, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    release();
+    throw std::runtime_error("Uring: could not map submission entries");
+  }
+  mSqes = static_cast<io_uring_sqe *>(sqes);
+
+  mSqHead = at<unsigned>(mSqRing, params.sq_off.head);
+  mSqTail = at<unsigned>(mSqRing, params.sq_off.tail);
+  mSqMask = *at<unsigned>(mSqRing, params.sq_off.ring_mask);
+  mSqEntries = *at<unsigned>(mSqRing, params.sq_off.ring_entries);
+  mSqArray = at<unsigned>(mSqRing, params.sq_off.array);
+
+  mCqHead = at<unsigned>(mCqRing, params.cq_off.head);
+  mCqTail = at<unsigned>(mCqRing, params.cq_off.tail);
+  mCqMask = *at<unsigned>(mCqRing, params.cq_off.ring_mask);
+  mCqes = at<io_uring_cqe>(mCqRing, params.cq_off.cqes);
+
+  mLocalTail = mSubmittedTail = *mSqTail;
+}
+
+Uring::~Uring() {
+  release();
+}
+
+void Uring::probe() {
+  Uring ring{4};
+
+  constexpr unsigned OPS = 256;
+  std::vector<std::uint8_t> storage(sizeof(io_uring_probe) + OPS * sizeof(io_uring_probe_op));
+  auto probe = reinterpret_cast<io_uring_probe *>(storage.data());
+  if (registerRing(ring.fd(), IORING_REGISTER_PROBE, probe, OPS) != 0) {
+    throw std::runtime_error(fmt::format("Uring::probe: could not probe opcodes: {:s}", std::strerror(errno)));
+  }
+  for (std::uint8_t opcode : {IORING_OP_RECVMSG, IORING_OP_POLL_ADD, IORING_OP_ASYNC_CANCEL, IORING_OP_TIMEOUT}) {
+    if (opcode > probe->last_op || !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED)) {
+      throw std::runtime_error(fmt::format("Uring::probe: opcode {:d} is not supported", opcode));
+    }
+  }
+
+  constexpr std::size_t SIZE = sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_storage) + 16;
+  UringBufferRing buffers{ring, 0, 4, SIZE};
+
+  auto socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  if (socket < 0
+      || ::bind(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+      || ::getsockname(socket, reinterpret_cast<sockaddr *>(&address), &length) != 0
+      || ::sendto(socket, "", 1, 0, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 1) {
+    auto error = errno;
+    if (socket >= 0) ::close(socket);
+    throw std::runtime_error(fmt::format("Uring::probe: could not open a loopback socket: {:s}", std::strerror(error)));
+  }
+
+  // The datagram is already queued, so the receive completes right away
+  msghdr header{};
+  header.msg_namelen = sizeof(sockaddr_storage);
+  auto & sqe = ring.prepare();
+  sqe.opcode = IORING_OP_RECVMSG;
+  sqe.fd = socket;
+  sqe.addr = reinterpret_cast<std::uint64_t>(&header);
+  sqe.len = 1;
+  sqe.ioprio = IORING_RECV_MULTISHOT;
+  sqe.flags = IOSQE_BUFFER_SELECT;
+  sqe.buf_group = buffers.group();
+
+  // Only the first completion tells: the receive may have ended since, out of buffers
+  int result{0};
+  bool more{false};
+  bool first{true};
+  try {
+    ring.submit(1);
+    ring.forEach([&](const io_uring_cqe & cqe) {
+      if (first) {
+        result = cqe.res;
+        more = cqe.flags & IORING_CQE_F_MORE;
+        first = false;
+      }
+    });
+  } catch (const std::exception &) {
+    ::close(socket);
+    throw;
+  }
+  ::close(socket);
+
+  if (result < 0 || !more) {
+    throw std::runtime_error(fmt::format("Uring::probe: multishot recvmsg is not supported: {:s}",
+                                         result < 0 ? std::strerror(-result) : "the receive was not kept armed"));
+  }
+}
+
+void Uring::release() {
+  if (mSqes) {
+    ::munmap(mSqes, mSqesSize);
+    mSqes = nullptr;
+  }
+  if (mCqRing && mCqRing != mSqRing) {
+    ::munmap(mCqRing, mCqRingSize);
+  }
+  mCqRing = nullptr;
+  if (mSqRing) {
+    ::munmap(mSqRing, mSqRingSize);
+    mSqRing = nullptr;
+  }
+  if (mFd >= 0) {
+    ::close(mFd);
+    mFd = -1;
+  }
+}
+
+io_uring_sqe & Uring::prepare() {
+  if (mLocalTail - __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE) >= mSqEntries) {
+    submit();
+  }
+
+  auto index = mLocalTail & mSqMask;
+  auto & sqe = mSqes[index];
+  std::memset(&sqe, 0, sizeof(sqe));
+  mSqArray[index] = index;
+  ++mLocalTail;
+  return sqe;
+}
+
+void Uring::submit(unsigned waitFor) {
+  __atomic_store_n(mSqTail, mLocalTail, __ATOMIC_RELEASE);
+
+  for (;;) {
+    auto result = enter(mFd, mLocalTail - mSubmittedTail, waitFor, waitFor ? IORING_ENTER_GETEVENTS : 0);
+    if (result >= 0) {
+      mSubmittedTail += static_cast<unsigned>(result);
+      return;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    // Completion queue is backed up; the caller drains it before the next call
+    if (errno == EBUSY || errno == EAGAIN) {
+      return;
+    }
+    throw std::runtime_error(fmt::format("Uring::submit: {:s}", std::strerror(errno)));
+  }
+}
+
+UringBufferRing::UringBufferRing(Uring & ring, std::uint16_t group, unsigned count, std::size_t size)
+    : mRing{ring},
+      mGroup{group},
+      mCount{count},
+      mSize{size},
+      mEntriesSize{count * sizeof(io_uring_buf)} {
+  if (count == 0 || count > 32768 || (count & (count - 1)) != 0) {
+    throw std::runtime_error("UringBufferRing: count must be a power of two up to 32768");
+  }
+
+  auto entries = ::mmap(nullptr, mEntriesSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (entries == MAP_FAILED) {
+    throw std::runtime_error("UringBufferRing: could not allocate ring");
+  }
+  mEntries = static_cast<io_uring_buf *>(entries);
+
+  auto buffers = ::mmap(nullptr, count * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buffers == MAP_FAILED) {
+    ::munmap(mEntries, mEntriesSize);
+    throw std::runtime_error("UringBufferRing: could not allocate buffers");
+  }
+  mBuffers = static_cast<std::uint8_t *>(buffers);
+
+  io_uring_buf_reg registration{};
+  registration.ring_addr = reinterpret_cast<std::uint64_t>(mEntries);
+  registration.ring_entries = count;
+  registration.bgid = group;
+  if (registerRing(mRing.fd(), IORING_REGISTER_PBUF_RING, &registration, 1) != 0) {
+    auto error = errno;
+    ::munmap(mBuffers, count * size);
+    ::munmap(mEntries, mEntriesSize);
+    throw std::runtime_error(fmt::format("UringBufferRing: could not register ring: {:s}", std::strerror(error)));
+  }
+
+  for (unsigned id = 0; id < count; ++id) {
+    recycle(static_cast<std::uint16_t>(id));
+  }
+}
+
+UringBufferRing::~UringBufferRing() {
+  io_uring_buf_reg registration{};
+  registration.bgid = mGroup;
+  registerRing(mRing.fd(), IORING_UNREGISTER_PBUF_RING, &registration, 1);
+  ::munmap(mBuffers, mCount * mSize);
+  ::munmap(mEntries, mEntriesSize);
+}
+
+void UringBufferRing::recycle(std::uint16_t id) {
+  auto & entry = mEntries[mTail & (mCount - 1)];
+  entry.addr = reinterpret_cast<std::uint64_t>(mBuffers + id * mSize);
+  entry.len = static_cast<std::uint32_t>(mSize);
+  entry.bid = id;
+  ++mTail;
+
+  // The tail overlays the reserved field of the first entry
+  __atomic_store_n(&mEntries[0].resv, mTail, __ATOMIC_RELEASE);
+}
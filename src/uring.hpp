@@ -0,0 +1,154 @@
+//
+// Created by Marcelo Lima on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <linux/io_uring.h>
+
+/**
+ * Minimal io_uring wrapper over the raw system calls
+ *
+ * Only covers what the server engine needs: a submission and completion queue pair
+ * and provided-buffer rings. Meant to be owned and driven by a single thread
+ */
+class Uring {
+private:
+
+  int mFd{-1};
+
+  void * mSqRing{nullptr};
+  std::size_t mSqRingSize{0};
+  void * mCqRing{nullptr};
+  std::size_t mCqRingSize{0};
+  io_uring_sqe * mSqes{nullptr};
+  std::size_t mSqesSize{0};
+
+  unsigned * mSqHead;
+  unsigned * mSqTail;
+  unsigned mSqMask;
+  unsigned mSqEntries;
+  unsigned * mSqArray;
+
+  unsigned * mCqHead;
+  unsigned * mCqTail;
+  unsigned mCqMask;
+  io_uring_cqe * mCqes;
+
+  // Submissions prepared but not yet handed to the kernel
+  unsigned mLocalTail{0};
+  unsigned mSubmittedTail{0};
+
+  void release();
+
+public:
+
+  /**
+   * @param entries submission queue size, rounded up to a power of two by the kernel
+   * @throws runtime_error if io_uring is not available
+   */
+  explicit Uring(unsigned entries);
+
+  ~Uring();
+  Uring(const Uring &) = delete;
+
+  /**
+   * Checks that the kernel has everything the server engine relies on: the opcodes it submits,
+   * provided-buffer rings and multishot recvmsg. The last one is armed once on a loopback socket,
+   * since older kernels only reject it then
+   *
+   * @throws runtime_error naming what is missing
+   */
+  static void probe();
+
+  void operator=(const Uring &) = delete;
+
+  /**
+   * Reserves a zeroed submission entry, submitting what is queued if the ring is full
+   */
+  io_uring_sqe & prepare();
+
+  /**
+   * Hands the prepared entries to the kernel
+   *
+   * @param waitFor block until at least this many completions are ready
+   */
+  void submit(unsigned waitFor = 0);
+
+  /**
+   * Consumes every ready completion
+   *
+   * @tparam C callable taking const io_uring_cqe &
+   * @return the number of completions
+   */
+  template <typename C>
+  unsigned forEach(C callback) {
+    auto head = *mCqHead;
+    auto tail = __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE);
+
+    for (auto current = head; current != tail; ++current) {
+      callback(mCqes[current & mCqMask]);
+    }
+
+    __atomic_store_n(mCqHead, tail, __ATOMIC_RELEASE);
+    return tail - head;
+  }
+
+  int fd() const {
+    return mFd;
+  }
+};
+
+/**
+ * A group of equally sized buffers the kernel picks from when a receive completes
+ *
+ * Buffers go back to the kernel through `recycle` once their contents are processed
+ */
+class UringBufferRing {
+private:
+
+  Uring & mRing;
+  const std::uint16_t mGroup;
+  const unsigned mCount;
+  const std::size_t mSize;
+
+  io_uring_buf * mEntries{nullptr};
+  std::size_t mEntriesSize;
+  std::uint8_t * mBuffers{nullptr};
+  std::uint16_t mTail{0};
+
+public:
+
+  /**
+   * @param ring the ring to register with
+   * @param group the buffer group id used by IOSQE_BUFFER_SELECT submissions
+   * @param count number of buffers, a power of two up to 32768
+   * @param size size of each buffer
+   * @throws runtime_error if the buffer ring cannot be registered
+   */
+  UringBufferRing(Uring & ring, std::uint16_t group, unsigned count, std::size_t size);
+
+  ~UringBufferRing();
+  UringBufferRing(const UringBufferRing &) = delete;
+  void operator=(const UringBufferRing &) = delete;
+
+  const std::uint8_t * buffer(std::uint16_t id) const {
+    return mBuffers + id * mSize;
+  }
+
+  std::size_t size() const {
+    return mSize;
+  }
+
+  std::uint16_t group() const {
+    return mGroup;
+  }
+
+  /**
+   * Hands a buffer back to the kernel
+   */
+  void recycle(std::uint16_t id);
+};
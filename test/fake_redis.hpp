@@ -0,0 +1,167 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../src/config.hpp"
+
+namespace {
+
+  /**
+   * In-process RESP server understanding SET and DEL
+   *
+   * Serves each connection on a thread of its own and keeps the commands it received
+   */
+  class FakeRedis {
+  private:
+    int mListener;
+    unsigned short mPort;
+    std::thread mThread;
+    std::vector<std::thread> mConnections{};
+    std::vector<int> mSockets{};
+
+    std::mutex mMutex;
+    std::vector<std::vector<std::string>> mCommands{};
+    std::map<std::string, std::string> mData{};
+    bool mFailing{false};
+    std::string mReply{};
+
+    static bool readLine(int socket, std::string & line) {
+      line.clear();
+      char c;
+      while (::recv(socket, &c, 1, 0) == 1) {
+        if (c == '\n' && !line.empty() && line.back() == '\r') {
+          line.pop_back();
+          return true;
+        }
+        line += c;
+      }
+      return false;
+    }
+
+    static bool readCommand(int socket, std::vector<std::string> & command) {
+      std::string line;
+      if (!readLine(socket, line) || line[0] != '*') return false;
+
+      command.resize(std::stoul(line.substr(1)));
+      for (auto & argument : command) {
+        if (!readLine(socket, line) || line[0] != '$') return false;
+        argument.resize(std::stoul(line.substr(1)));
+        if (::recv(socket, argument.data(), argument.size(), MSG_WAITALL) != static_cast<ssize_t>(argument.size()))
+          return false;
+        readLine(socket, line);
+      }
+      return true;
+    }
+
+    std::string execute(const std::vector<std::string> & command) {
+      std::unique_lock<std::mutex> lock{mMutex};
+      mCommands.push_back(command);
+
+      if (mFailing) return "-ERR failing\r\n";
+      if (!mReply.empty()) return mReply;
+      if (command[0] == "SET") {
+        mData[command[1]] = command[2];
+        return "+OK\r\n";
+      }
+      if (command[0] == "DEL") {
+        return ":" + std::to_string(mData.erase(command[1])) + "\r\n";
+      }
+      return "-ERR unknown command\r\n";
+    }
+
+    void converse(int socket) {
+      std::vector<std::string> command;
+      while (readCommand(socket, command)) {
+        auto reply = execute(command);
+        ::send(socket, reply.data(), reply.size(), MSG_NOSIGNAL);
+      }
+    }
+
+    void serve() {
+      int socket;
+      while ((socket = ::accept(mListener, nullptr, nullptr)) >= 0) {
+        std::unique_lock<std::mutex> lock{mMutex};
+        mSockets.push_back(socket);
+        mConnections.emplace_back([this, socket] { converse(socket); });
+      }
+    }
+
+  public:
+
+    FakeRedis() : mListener{::socket(AF_INET, SOCK_STREAM, 0)} {
+      sockaddr_in address{};
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      ::bind(mListener, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+      ::listen(mListener, 16);
+
+      socklen_t length = sizeof(address);
+      ::getsockname(mListener, reinterpret_cast<sockaddr *>(&address), &length);
+      mPort = ntohs(address.sin_port);
+
+      mThread = std::thread{[this] { serve(); }};
+    }
+
+    ~FakeRedis() {
+      ::shutdown(mListener, SHUT_RDWR);
+      ::close(mListener);
+      mThread.join();
+      for (auto socket : mSockets) {
+        ::shutdown(socket, SHUT_RDWR);
+      }
+      for (auto & connection : mConnections) {
+        connection.join();
+      }
+      for (auto socket : mSockets) {
+        ::close(socket);
+      }
+    }
+
+    Config::Cache config() {
+      setenv("RADIUS_CACHE_HOST", "127.0.0.1", true);
+      setenv("RADIUS_CACHE_PORT", std::to_string(mPort).c_str(), true);
+      setenv("RADIUS_CACHE_NO_REPLY", "FALSE", true);
+      auto config = Config::Cache::load("");
+      unsetenv("RADIUS_CACHE_HOST");
+      unsetenv("RADIUS_CACHE_PORT");
+      unsetenv("RADIUS_CACHE_NO_REPLY");
+      return config;
+    }
+
+    std::vector<std::vector<std::string>> commands() {
+      std::unique_lock<std::mutex> lock{mMutex};
+      return mCommands;
+    }
+
+    std::size_t connections() {
+      std::unique_lock<std::mutex> lock{mMutex};
+      return mSockets.size();
+    }
+
+    std::map<std::string, std::string> data() {
+      std::unique_lock<std::mutex> lock{mMutex};
+      return mData;
+    }
+
+    void failing(bool failing) {
+      std::unique_lock<std::mutex> lock{mMutex};
+      mFailing = failing;
+    }
+
+    /**
+     * Answers every command with `reply` as is, or as a real server would if empty
+     */
+    void replying(std::string reply) {
+      std::unique_lock<std::mutex> lock{mMutex};
+      mReply = std::move(reply);
+    }
+  };
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../src/attribute_scanner.hpp"
+
+namespace {
+  void addAttribute(std::vector<std::uint8_t> & packet, std::uint8_t type, std::vector<std::uint8_t> value) {
+    packet.push_back(type);
+    packet.push_back(static_cast<std::uint8_t>(value.size() + 2));
+    packet.insert(packet.end(), value.begin(), value.end());
+  }
+
+  const radius::AttributeScanner::Selection SELECTION{{0, radius::Attribute::ACCT_STATUS_TYPE},
+                                                      {0, radius::Attribute::USER_NAME},
+                                                      {0, radius::Attribute::FRAMED_IP_ADDRESS},
+                                                      {9, 1},
+                                                      {10415, 1}};
+
+  radius::AttributeScanner scan(const std::vector<std::uint8_t> & packet) {
+    return {SELECTION, packet.data(), packet.data() + packet.size()};
+  }
+}
+
+TEST(AttributeScanner, locates_attributes_of_interest) {
+  std::vector<std::uint8_t> packet;
+  addAttribute(packet, 26, {0, 0, 0, 9, 1, 4, 'a', 'b'});
+  addAttribute(packet, radius::Attribute::FRAMED_IP_ADDRESS, {192, 168, 10, 22});
+  addAttribute(packet, 44, {'x', 'y', 'z'});
+  addAttribute(packet, radius::Attribute::USER_NAME, {'1', '2', '3'});
+
+  auto attributes = scan(packet);
+  ASSERT_TRUE(attributes.valid());
+
+  auto address = attributes[radius::Attribute::FRAMED_IP_ADDRESS];
+  ASSERT_TRUE(address);
+  ASSERT_EQ(4, address.length);
+  ASSERT_EQ(packet.data() + 12, address.begin);
+
+  auto userName = attributes[radius::Attribute::USER_NAME];
+  ASSERT_EQ("123", std::string(userName.begin, userName.end()));
+
+  ASSERT_FALSE(attributes[radius::Attribute::ACCT_STATUS_TYPE]);
+  ASSERT_FALSE(attributes[radius::Attribute::INVALID]);
+}
+
+TEST(AttributeScanner, last_occurrence_wins) {
+  std::vector<std::uint8_t> packet;
+  addAttribute(packet, radius::Attribute::USER_NAME, {'1'});
+  addAttribute(packet, radius::Attribute::USER_NAME, {'2'});
+
+  auto userName = scan(packet)[radius::Attribute::USER_NAME];
+  ASSERT_EQ('2', *userName.begin);
+}
+
+TEST(AttributeScanner, stops_once_all_selected_are_seen) {
+  radius::AttributeScanner::Selection selection{{0, radius::Attribute::USER_NAME},
+                                                {0, radius::Attribute::FRAMED_IP_ADDRESS}};
+  std::vector<std::uint8_t> packet;
+  addAttribute(packet, radius::Attribute::USER_NAME, {'1'});
+  addAttribute(packet, radius::Attribute::FRAMED_IP_ADDRESS, {192, 168, 10, 22});
+  addAttribute(packet, radius::Attribute::USER_NAME, {'2'});
+  packet.push_back(44);
+  packet.push_back(1);
+
+  radius::AttributeScanner attributes{selection, packet.data(), packet.data() + packet.size()};
+  ASSERT_TRUE(attributes.valid());
+  ASSERT_EQ('1', *attributes[radius::Attribute::USER_NAME].begin);
+}
+
+TEST(AttributeScanner, vendor_selection_scans_everything) {
+  radius::AttributeScanner::Selection selection{{0, radius::Attribute::USER_NAME}, {9, 1}};
+  std::vector<std::uint8_t> packet;
+  addAttribute(packet, radius::Attribute::USER_NAME, {'1'});
+  addAttribute(packet, 26, {0, 0, 0, 9, 1, 3, 'a'});
+  packet.push_back(44);
+  packet.push_back(1);
+
+  radius::AttributeScanner attributes{selection, packet.data(), packet.data() + packet.size()};
+  ASSERT_FALSE(attributes.valid());
+}
+
+TEST(AttributeScanner, empty_chain_is_valid) {
+  std::vector<std::uint8_t> packet;
+  ASSERT_TRUE(scan(packet).valid());
+}
+
+TEST(AttributeScanner, rejects_malformed_chains) {
+  std::vector<std::uint8_t> packet;
+  addAttribute(packet, radius::Attribute::USER_NAME, {'1', '2', '3'});
+
+  // Overruns the packet
+  auto overrun = packet;
+  overrun[1] += 1;
+  ASSERT_FALSE(scan(overrun).valid());
+
+  // Shorter than its own preamble
+  auto zero = packet;
+  zero[1] = 1;
+  ASSERT_FALSE(scan(zero).valid());
+
+  // Stray byte after the last attribute
+  auto trailing = packet;
+  trailing.push_back(radius::Attribute::USER_NAME);
+  ASSERT_FALSE(scan(trailing).valid());
+}
+
+TEST(AttributeScanner, finds_vendor_attributes) {
+  std::vector<std::uint8_t> packet;
+  addAttribute(packet, radius::Attribute::USER_NAME, {'1'});
+  addAttribute(packet, 26, {0, 0, 0, 9, 1, 5, 'a', 'b', 'c', 2, 3, 'x'});
+  addAttribute(packet, 26, {0, 0, 0x28, 0xAF, 1, 5, '2', '4', '2'});
+
+  auto attributes = scan(packet);
+  ASSERT_TRUE(attributes.valid());
+
+  auto avPair = attributes[radius::AttributeId{9, 1}];
+  ASSERT_EQ("abc", std::string(avPair.begin, avPair.end()));
+
+  auto imsi = attributes[radius::AttributeId{10415, 1}];
+  ASSERT_EQ("242", std::string(imsi.begin, imsi.end()));
+
+  ASSERT_EQ("x", std::string(attributes[radius::AttributeId{9, 2}].begin, attributes[radius::AttributeId{9, 2}].end()));
+  ASSERT_FALSE((attributes[radius::AttributeId{9, 3}]));
+  ASSERT_FALSE((attributes[radius::AttributeId{10415, 2}]));
+}
+
+TEST(AttributeScanner, skips_malformed_vendor_attributes) {
+  std::vector<std::uint8_t> packet;
+  addAttribute(packet, 26, {0, 0, 0, 9, 1, 9, 'a', 'b', 'c'});
+  addAttribute(packet, 26, {0, 0, 0});
+
+  auto attributes = scan(packet);
+  ASSERT_TRUE(attributes.valid());
+  ASSERT_FALSE((attributes[radius::AttributeId{9, 1}]));
+}
+
+TEST(AttributeScanner, vendor_attributes_not_selected) {
+  radius::AttributeScanner::Selection selection{{0, radius::Attribute::USER_NAME}};
+  std::vector<std::uint8_t> packet;
+  addAttribute(packet, 26, {0, 0, 0, 9, 1, 5, 'a', 'b', 'c'});
+
+  radius::AttributeScanner attributes{selection, packet.data(), packet.data() + packet.size()};
+  ASSERT_TRUE(attributes.valid());
+  ASSERT_FALSE((attributes[radius::AttributeId{9, 1}]));
+}
@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "../src/buffer_slab.hpp"
+
+TEST(BufferSlab, buffers_are_cache_line_aligned) {
+  BufferSlab slab{10, 100};
+
+  ASSERT_EQ(10, slab.count());
+  ASSERT_EQ(100, slab.size());
+  for (std::size_t i = 0; i < slab.count(); ++i) {
+    ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(slab[i]) % 64);
+  }
+}
+
+TEST(BufferSlab, buffers_do_not_overlap) {
+  BufferSlab slab{16, 4096};
+
+  for (std::size_t i = 0; i < slab.count(); ++i) {
+    std::memset(slab[i], static_cast<int>(i), slab.size());
+  }
+  for (std::size_t i = 0; i < slab.count(); ++i) {
+    ASSERT_EQ(i, slab[i][0]);
+    ASSERT_EQ(i, slab[i][slab.size() - 1]);
+    if (i > 0) {
+      ASSERT_GE(slab[i], slab[i - 1] + slab.size());
+    }
+  }
+}
+
+TEST(BufferSlab, empty_slab_throws) {
+  ASSERT_ANY_THROW((BufferSlab{0, 4096}));
+  ASSERT_ANY_THROW((BufferSlab{4, 0}));
+}
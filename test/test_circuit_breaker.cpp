@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "../src/circuit_breaker.hpp"
+
+namespace {
+  const CircuitBreaker::Clock::time_point START{};
+  constexpr std::chrono::milliseconds COOLDOWN{1000};
+}
+
+TEST(CircuitBreaker, starts_closed) {
+  CircuitBreaker breaker{3, COOLDOWN};
+
+  ASSERT_EQ(CircuitBreaker::CLOSED, breaker.state());
+  ASSERT_TRUE(breaker.allow(START));
+}
+
+TEST(CircuitBreaker, opens_after_consecutive_failures) {
+  CircuitBreaker breaker{3, COOLDOWN};
+
+  breaker.failure(START);
+  breaker.failure(START);
+  ASSERT_TRUE(breaker.healthy());
+
+  breaker.failure(START);
+  ASSERT_EQ(CircuitBreaker::OPEN, breaker.state());
+  ASSERT_FALSE(breaker.allow(START + COOLDOWN / 2));
+}
+
+TEST(CircuitBreaker, success_resets_failure_count) {
+  CircuitBreaker breaker{3, COOLDOWN};
+
+  breaker.failure(START);
+  breaker.failure(START);
+  breaker.success();
+  breaker.failure(START);
+  breaker.failure(START);
+
+  ASSERT_TRUE(breaker.healthy());
+}
+
+TEST(CircuitBreaker, single_probe_after_cooldown) {
+  CircuitBreaker breaker{1, COOLDOWN};
+  breaker.failure(START);
+
+  ASSERT_TRUE(breaker.allow(START + COOLDOWN));
+  ASSERT_EQ(CircuitBreaker::HALF_OPEN, breaker.state());
+  ASSERT_FALSE(breaker.allow(START + COOLDOWN));
+}
+
+TEST(CircuitBreaker, successful_probe_closes) {
+  CircuitBreaker breaker{1, COOLDOWN};
+  breaker.failure(START);
+  breaker.allow(START + COOLDOWN);
+  breaker.success();
+
+  ASSERT_EQ(CircuitBreaker::CLOSED, breaker.state());
+  ASSERT_TRUE(breaker.allow(START + COOLDOWN));
+}
+
+TEST(CircuitBreaker, failed_probe_reopens) {
+  CircuitBreaker breaker{5, COOLDOWN};
+  for (int i = 0; i < 5; ++i) {
+    breaker.failure(START);
+  }
+  breaker.allow(START + COOLDOWN);
+  breaker.failure(START + COOLDOWN);
+
+  ASSERT_EQ(CircuitBreaker::OPEN, breaker.state());
+  ASSERT_FALSE(breaker.allow(START + COOLDOWN + COOLDOWN / 2));
+  ASSERT_TRUE(breaker.allow(START + COOLDOWN * 2));
+}
+
+TEST(CircuitBreaker, failed_probes_back_off) {
+  CircuitBreaker breaker{1, COOLDOWN, COOLDOWN * 3};
+  breaker.failure(START);
+
+  // Reopened with twice the cooldown
+  auto probe = START + COOLDOWN;
+  breaker.allow(probe);
+  breaker.failure(probe);
+  ASSERT_FALSE(breaker.allow(probe + COOLDOWN * 2 - std::chrono::milliseconds{1}));
+  ASSERT_TRUE(breaker.allow(probe + COOLDOWN * 2));
+
+  // Capped at the maximum
+  probe += COOLDOWN * 2;
+  breaker.failure(probe);
+  ASSERT_FALSE(breaker.allow(probe + COOLDOWN * 3 - std::chrono::milliseconds{1}));
+  ASSERT_TRUE(breaker.allow(probe + COOLDOWN * 3));
+
+  // Reset once closed
+  breaker.success();
+  breaker.failure(probe);
+  ASSERT_TRUE(breaker.allow(probe + COOLDOWN));
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include "../src/codec.hpp"
+#include "../src/encoder.hpp"
+
+namespace {
+  constexpr std::array<std::uint8_t, 4> ADDRESS{192, 168, 10, 22};
+  constexpr std::time_t TIMESTAMP{1781234567};
+}
+
+TEST(Codec, key_round_trip) {
+  auto key = codec::encodeKey("rc", ADDRESS);
+
+  ASSERT_EQ(6, key.size());
+  ASSERT_EQ(ADDRESS, *codec::decodeKey("rc", key));
+}
+
+TEST(Codec, key_with_other_prefix_is_rejected) {
+  auto key = codec::encodeKey("rc", ADDRESS);
+
+  ASSERT_FALSE(codec::decodeKey("xy", key));
+  ASSERT_FALSE(codec::decodeKey("r", key));
+  ASSERT_FALSE(codec::decodeKey("rc", "192.168.10.22"));
+}
+
+TEST(Codec, ipv6_key_round_trip) {
+  std::array<std::uint8_t, codec::IPV6_SIZE> prefix{0x20, 0x01, 0x0D, 0xB8};
+  auto key = codec::encodeKey("rc", prefix);
+
+  ASSERT_EQ(18, key.size());
+  ASSERT_EQ(prefix, *codec::decodeIpv6Key("rc", key));
+  ASSERT_FALSE(codec::decodeIpv6Key("rc", codec::encodeKey("rc", ADDRESS)));
+  ASSERT_FALSE(codec::decodeKey("rc", key));
+}
+
+TEST(Codec, numeric_value_round_trip) {
+  auto value = codec::encodeValue(3, TIMESTAMP, 987654321012345ull);
+  auto session = codec::decodeValue(value);
+
+  ASSERT_EQ(codec::NUMERIC_VALUE_SIZE, value.size());
+  ASSERT_TRUE(session);
+  ASSERT_EQ(3, session->status);
+  ASSERT_EQ(TIMESTAMP, session->timestamp);
+  ASSERT_EQ(987654321012345ull, *session->subscriberId);
+  ASSERT_EQ("987654321012345", session->userName);
+}
+
+TEST(Codec, text_value_round_trip) {
+  auto value = codec::encodeValue(1, TIMESTAMP, "john@example");
+  auto session = codec::decodeValue(value);
+
+  ASSERT_TRUE(session);
+  ASSERT_EQ(1, session->status);
+  ASSERT_EQ(TIMESTAMP, session->timestamp);
+  ASSERT_FALSE(session->subscriberId);
+  ASSERT_EQ("john@example", session->userName);
+}
+
+TEST(Codec, record_round_trip) {
+  auto record = codec::beginRecord(3);
+  codec::appendField(record, std::string_view{"987654321"});
+  codec::appendField(record, std::nullopt);
+  codec::appendField(record, std::string_view{});
+
+  auto fields = codec::decodeRecord(record);
+  ASSERT_TRUE(fields);
+  ASSERT_EQ(3, fields->size());
+  ASSERT_EQ("987654321", *(*fields)[0]);
+  ASSERT_FALSE((*fields)[1]);
+  ASSERT_EQ("", *(*fields)[2]);
+}
+
+TEST(Codec, record_value_round_trip) {
+  auto record = codec::beginRecord(2);
+  codec::appendField(record, std::string_view{"john@example"});
+  codec::appendField(record, std::string_view{"\x0A\x00\x00\x01", 4});
+
+  auto session = codec::decodeValue(codec::encodeRecordValue(1, TIMESTAMP, record));
+  ASSERT_TRUE(session);
+  ASSERT_EQ(1, session->status);
+  ASSERT_EQ(TIMESTAMP, session->timestamp);
+  ASSERT_FALSE(session->subscriberId);
+  ASSERT_EQ("john@example", session->userName);
+  ASSERT_EQ(record, session->record);
+}
+
+TEST(Codec, malformed_record_is_rejected) {
+  auto record = codec::beginRecord(2);
+  codec::appendField(record, std::string_view{"abc"});
+  codec::appendField(record, std::nullopt);
+
+  ASSERT_FALSE(codec::decodeRecord(""));
+  ASSERT_FALSE(codec::decodeRecord(record.substr(0, record.size() - 1)));
+  ASSERT_FALSE(codec::decodeRecord(record + "x"));
+  ASSERT_FALSE(codec::decodeValue(codec::encodeRecordValue(1, TIMESTAMP, record.substr(0, 3))));
+}
+
+TEST(Codec, malformed_value_is_rejected) {
+  auto value = codec::encodeValue(1, TIMESTAMP, 987654321ull);
+
+  ASSERT_FALSE(codec::decodeValue(""));
+  ASSERT_FALSE(codec::decodeValue(value.substr(0, value.size() - 1)));
+  ASSERT_FALSE(codec::decodeValue(value.substr(0, codec::VALUE_HEADER_SIZE)));
+  value[0] = 42;
+  ASSERT_FALSE(codec::decodeValue(value));
+}
+
+TEST(Encoder, text_by_default) {
+  Encoder encoder{Config::Cache::load("")};
+  Action action{Action::STORE, "192.168.10.22", "987654321", 1, ADDRESS, 987654321};
+
+  auto [key, value] = encoder(action, TIMESTAMP);
+
+  ASSERT_EQ("192.168.10.22", key);
+  ASSERT_EQ("987654321", value);
+}
+
+TEST(Encoder, compact) {
+  setenv("RADIUS_CACHE_COMPACT_ENCODING", "TRUE", true);
+  Encoder encoder{Config::Cache::load("")};
+  unsetenv("RADIUS_CACHE_COMPACT_ENCODING");
+
+  Action numeric{Action::STORE, "192.168.10.22", "987654321", 1, ADDRESS, 987654321};
+  auto [key, value] = encoder(numeric, TIMESTAMP);
+
+  ASSERT_EQ(codec::encodeKey("rc", ADDRESS), key);
+  ASSERT_EQ(codec::encodeValue(1, TIMESTAMP, 987654321ull), value);
+
+  // Leading zeros would be lost as a number
+  Action padded{Action::STORE, "192.168.10.22", "0987654321", 1, ADDRESS, 987654321};
+  ASSERT_EQ("0987654321", codec::decodeValue(encoder(padded, TIMESTAMP).second)->userName);
+}
+
+TEST(Encoder, record) {
+  auto record = codec::beginRecord(1);
+  codec::appendField(record, std::string_view{"987654321"});
+  Action action{Action::STORE, "192.168.10.22", "987654321", 1, ADDRESS, 987654321, std::string{record}};
+
+  ASSERT_EQ(record, Encoder{Config::Cache::load("")}(action, TIMESTAMP).second);
+
+  setenv("RADIUS_CACHE_COMPACT_ENCODING", "TRUE", true);
+  Encoder compact{Config::Cache::load("")};
+  unsetenv("RADIUS_CACHE_COMPACT_ENCODING");
+
+  ASSERT_EQ(codec::encodeRecordValue(1, TIMESTAMP, record), compact(action, TIMESTAMP).second);
+}
+
+TEST(Encoder, ipv6_prefix_keys_are_binary) {
+  Encoder encoder{Config::Cache::load("")};
+  std::array<std::uint8_t, codec::IPV6_SIZE> prefix{0x20, 0x01, 0x0D, 0xB8};
+  Action action{Action::STORE, std::nullopt, "987654321", 1, std::nullopt, 987654321, std::nullopt, {prefix}};
+
+  ASSERT_EQ(codec::encodeKey("rc", prefix), encoder.key(action.prefixes.front()));
+  ASSERT_EQ("987654321", encoder.value(action));
+
+  setenv("RADIUS_CACHE_COMPACT_ENCODING", "TRUE", true);
+  Encoder compact{Config::Cache::load("")};
+  unsetenv("RADIUS_CACHE_COMPACT_ENCODING");
+
+  ASSERT_EQ(codec::encodeValue(1, TIMESTAMP, 987654321ull), compact.value(action, TIMESTAMP));
+}
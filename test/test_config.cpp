@@ -53,6 +53,16 @@ TEST(Config, get_bool) {
   unsetenv("RADIUS_SINGLE_CORE");
 }
 
+TEST(Config, get_backend) {
+  std::unique_lock<std::mutex> lock(cacheMutex);
+
+  setenv("RADIUS_CACHE_BACKEND", "abc", true);
+  ASSERT_ANY_THROW(Config::Cache::load(""));
+  setenv("RADIUS_CACHE_BACKEND", "redis", true);
+  ASSERT_ANY_THROW(Config::Cache::load(""));
+  unsetenv("RADIUS_CACHE_BACKEND");
+}
+
 TEST(Config_Server, no_file_no_filter_loads_defaults) {
   auto server = Config::Server::load("");
 
@@ -63,6 +73,26 @@ TEST(Config_Server, no_file_no_filter_loads_defaults) {
   ASSERT_EQ("USER_NAME", server.value);
   ASSERT_EQ("/etc/radius-cacher/filter.txt", server.filterFile);
   ASSERT_EQ(std::chrono::minutes{720}, server.filterRefreshMinutes);
+  ASSERT_EQ(std::chrono::seconds{60}, server.statsIntervalSeconds);
+  ASSERT_EQ(false, server.ioUring);
+  ASSERT_EQ(false, server.busyPoll);
+  ASSERT_TRUE(server.cpuList.empty());
+  ASSERT_EQ(std::chrono::microseconds{50}, server.busyPollMicros);
+  ASSERT_EQ(std::chrono::microseconds{1000}, server.busyPollIdleMicros);
+  ASSERT_EQ(16, server.bufferCount);
+  ASSERT_EQ(4096, server.bufferSize);
+  ASSERT_EQ("/etc/radius-cacher/range-filter.txt", server.rangeFilterFile);
+  ASSERT_EQ("", server.upstreams);
+  ASSERT_EQ(4, server.proxySockets);
+  ASSERT_EQ(std::chrono::milliseconds{3000}, server.proxyTimeoutMillis);
+  ASSERT_EQ(0, server.nasRate);
+  ASSERT_EQ(0, server.nasBurst);
+  ASSERT_EQ(0, server.globalRate);
+  ASSERT_EQ(10, server.topK);
+  ASSERT_EQ("", server.statsSocket);
+  ASSERT_EQ("", server.verboseLevel);
+  ASSERT_EQ("", server.handoverSocket);
+  ASSERT_EQ(std::chrono::milliseconds{5000}, server.drainTimeoutMillis);
 }
 
 TEST(Config_Server, file_loads_properly) {
@@ -75,6 +105,40 @@ TEST(Config_Server, file_loads_properly) {
   ASSERT_EQ("lavlavlav", server.value);
   ASSERT_EQ("my_lame_file", server.filterFile);
   ASSERT_EQ(std::chrono::minutes{5588}, server.filterRefreshMinutes);
+  ASSERT_EQ(std::chrono::seconds{30}, server.statsIntervalSeconds);
+  ASSERT_EQ(true, server.ioUring);
+  ASSERT_EQ(true, server.busyPoll);
+  ASSERT_EQ((std::vector<unsigned int>{0, 2, 3, 4}), server.cpuList);
+  ASSERT_EQ(std::chrono::microseconds{20}, server.busyPollMicros);
+  ASSERT_EQ(std::chrono::microseconds{5000}, server.busyPollIdleMicros);
+  ASSERT_EQ(128, server.bufferCount);
+  ASSERT_EQ(2048, server.bufferSize);
+  ASSERT_EQ("my_lame_ranges", server.rangeFilterFile);
+  ASSERT_EQ("10.0.0.1:1813,10.0.0.2:1813", server.upstreams);
+  ASSERT_EQ(8, server.proxySockets);
+  ASSERT_EQ(std::chrono::milliseconds{1500}, server.proxyTimeoutMillis);
+  ASSERT_EQ(200, server.nasRate);
+  ASSERT_EQ(400, server.nasBurst);
+  ASSERT_EQ(100000, server.globalRate);
+  ASSERT_EQ(25, server.topK);
+  ASSERT_EQ("/run/lame.sock", server.statsSocket);
+  ASSERT_EQ("WARN", server.verboseLevel);
+  ASSERT_EQ("/run/handover.sock", server.handoverSocket);
+  ASSERT_EQ(std::chrono::milliseconds{2500}, server.drainTimeoutMillis);
+}
+
+TEST(Config, get_cpu_list) {
+  std::unique_lock<std::mutex> lock(serverMutex);
+
+  setenv("RADIUS_CPU_LIST", "1-", true);
+  ASSERT_ANY_THROW(Config::Server::load(""));
+  setenv("RADIUS_CPU_LIST", "3-1", true);
+  ASSERT_ANY_THROW(Config::Server::load(""));
+  setenv("RADIUS_CPU_LIST", "a,b", true);
+  ASSERT_ANY_THROW(Config::Server::load(""));
+  setenv("RADIUS_CPU_LIST", "7", true);
+  ASSERT_EQ((std::vector<unsigned int>{7}), Config::Server::load("").cpuList);
+  unsetenv("RADIUS_CPU_LIST");
 }
 
 TEST(Config_Server, env_vars_loads_properly) {
@@ -138,6 +202,21 @@ TEST(Config_Cache, test_no_file_no_env_loads_default) {
   ASSERT_EQ(true, cache.noReply);
   ASSERT_EQ(true, cache.useBinary);
   ASSERT_EQ(true, cache.tcpKeepAlive);
+  ASSERT_EQ(false, cache.localStore);
+  ASSERT_EQ(1024, cache.expiryBudget);
+  ASSERT_EQ("/var/lib/radius-cacher/sessions.snapshot", cache.snapshotFile);
+  ASSERT_EQ(std::chrono::seconds{60}, cache.snapshotIntervalSeconds);
+  ASSERT_EQ("/var/lib/radius-cacher/spill.journal", cache.spillFile);
+  ASSERT_EQ(64, cache.spillSizeMegabytes);
+  ASSERT_EQ(std::chrono::milliseconds{100}, cache.timeoutMillis);
+  ASSERT_EQ(5, cache.failureThreshold);
+  ASSERT_EQ(std::chrono::milliseconds{1000}, cache.cooldownMillis);
+  ASSERT_EQ(false, cache.compactEncoding);
+  ASSERT_EQ("rc", cache.keyPrefix);
+  ASSERT_EQ(Config::Cache::MEMCACHED, cache.backend);
+  ASSERT_EQ(1, cache.poolSize);
+  ASSERT_EQ(1, cache.pipelineDepth);
+  ASSERT_EQ(std::chrono::milliseconds{30000}, cache.cooldownMaxMillis);
 }
 
 TEST(Config_Cache, file_loads_properly) {
@@ -149,6 +228,38 @@ TEST(Config_Cache, file_loads_properly) {
   ASSERT_EQ(false, cache.noReply);
   ASSERT_EQ(false, cache.useBinary);
   ASSERT_EQ(false, cache.tcpKeepAlive);
+  ASSERT_EQ(true, cache.localStore);
+  ASSERT_EQ(321, cache.expiryBudget);
+  ASSERT_EQ("my_snapshot_file", cache.snapshotFile);
+  ASSERT_EQ(std::chrono::seconds{42}, cache.snapshotIntervalSeconds);
+  ASSERT_EQ("my_spill_file", cache.spillFile);
+  ASSERT_EQ(12, cache.spillSizeMegabytes);
+  ASSERT_EQ(std::chrono::milliseconds{250}, cache.timeoutMillis);
+  ASSERT_EQ(7, cache.failureThreshold);
+  ASSERT_EQ(std::chrono::milliseconds{3000}, cache.cooldownMillis);
+  ASSERT_EQ("my_prefix", cache.keyPrefix);
+  ASSERT_EQ(Config::Cache::REDIS, cache.backend);
+  ASSERT_EQ(4, cache.poolSize);
+  ASSERT_EQ(32, cache.pipelineDepth);
+  ASSERT_EQ(std::chrono::milliseconds{60000}, cache.cooldownMaxMillis);
+}
+
+TEST(Config_Cache, compact_encoding_requires_binary) {
+  std::unique_lock<std::mutex> lock(cacheMutex);
+
+  setenv("RADIUS_CACHE_COMPACT_ENCODING", "TRUE", true);
+  ASSERT_TRUE(Config::Cache::load("").compactEncoding);
+
+  setenv("RADIUS_CACHE_USE_BINARY", "FALSE", true);
+  ASSERT_ANY_THROW(Config::Cache::load(""));
+
+  // RESP is binary safe
+  setenv("RADIUS_CACHE_BACKEND", "REDIS", true);
+  ASSERT_TRUE(Config::Cache::load("").compactEncoding);
+
+  unsetenv("RADIUS_CACHE_COMPACT_ENCODING");
+  unsetenv("RADIUS_CACHE_USE_BINARY");
+  unsetenv("RADIUS_CACHE_BACKEND");
 }
 
 TEST(Config_Cache, env_vars_loads_properly) {
@@ -196,3 +307,66 @@ TEST(Config_Cache, env_vars_overloads_file) {
   ASSERT_EQ(false, cache.useBinary);
   ASSERT_EQ(false, cache.tcpKeepAlive);
 }
+
+TEST(Config_Cache, empty_spill_file_disables_the_journal) {
+  std::unique_lock<std::mutex> lock(cacheMutex);
+
+  auto cache = Config::Cache::load("res/test/no_spill.cfg");
+  ASSERT_EQ("", cache.spillFile);
+  ASSERT_EQ("localhost", cache.host);
+
+  setenv("RADIUS_CACHE_SPILL_FILE", "", true);
+  ASSERT_EQ("", Config::Cache::load("res/test/cache.cfg").spillFile);
+  unsetenv("RADIUS_CACHE_SPILL_FILE");
+}
+
+TEST(Config, ipv6_keys_require_binary) {
+  std::unique_lock<std::mutex> serverLock(serverMutex);
+  std::unique_lock<std::mutex> cacheLock(cacheMutex);
+
+  setenv("RADIUS_KEY", "FRAMED_IP_ADDRESS, FRAMED_IPV6_PREFIX", true);
+  ASSERT_NO_THROW((Config{"", ""}));
+
+  setenv("RADIUS_CACHE_USE_BINARY", "FALSE", true);
+  ASSERT_ANY_THROW((Config{"", ""}));
+
+  // RESP is binary safe
+  setenv("RADIUS_CACHE_BACKEND", "REDIS", true);
+  ASSERT_NO_THROW((Config{"", ""}));
+
+  unsetenv("RADIUS_CACHE_BACKEND");
+  setenv("RADIUS_KEY", "FRAMED_IP_ADDRESS", true);
+  ASSERT_NO_THROW((Config{"", ""}));
+
+  unsetenv("RADIUS_KEY");
+  unsetenv("RADIUS_CACHE_USE_BINARY");
+}
+
+TEST(Config_Server, buffers_outnumber_multi_core_threads) {
+  std::unique_lock<std::mutex> lock(serverMutex);
+
+  setenv("RADIUS_SINGLE_CORE", "FALSE", true);
+  setenv("RADIUS_THREAD_POOL_SIZE", "32", true);
+  ASSERT_EQ(33, Config::Server::load("").bufferCount);
+
+  setenv("RADIUS_BUFFER_COUNT", "32", true);
+  ASSERT_ANY_THROW(Config::Server::load(""));
+
+  // Busy polling gives every worker a buffer of its own
+  setenv("RADIUS_BUSY_POLL", "TRUE", true);
+  ASSERT_EQ(32, Config::Server::load("").bufferCount);
+
+  unsetenv("RADIUS_BUSY_POLL");
+  unsetenv("RADIUS_BUFFER_COUNT");
+  unsetenv("RADIUS_THREAD_POOL_SIZE");
+  unsetenv("RADIUS_SINGLE_CORE");
+}
+
+TEST(Config_Server, top_k_is_positive) {
+  std::unique_lock<std::mutex> lock(serverMutex);
+
+  setenv("RADIUS_TOP_K", "0", true);
+  ASSERT_ANY_THROW(Config::Server::load(""));
+
+  unsetenv("RADIUS_TOP_K");
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "fake_redis.hpp"
+#include "../src/connection_pool.hpp"
+
+namespace {
+  Config::Cache poolConfig(FakeRedis & redis, const char * size, const char * depth) {
+    setenv("RADIUS_CACHE_BACKEND", "REDIS", true);
+    setenv("RADIUS_CACHE_POOL_SIZE", size, true);
+    setenv("RADIUS_CACHE_PIPELINE_DEPTH", depth, true);
+    auto config = redis.config();
+    unsetenv("RADIUS_CACHE_BACKEND");
+    unsetenv("RADIUS_CACHE_POOL_SIZE");
+    unsetenv("RADIUS_CACHE_PIPELINE_DEPTH");
+    return config;
+  }
+
+  // One file per test, since ctest runs them in parallel
+  Config::Cache journalConfig(FakeRedis & redis, const char * size, const char * depth) {
+    auto path = std::string{::testing::UnitTest::GetInstance()->current_test_info()->name()} + ".journal";
+    std::remove(path.c_str());
+
+    setenv("RADIUS_CACHE_SPILL_FILE", path.c_str(), true);
+    setenv("RADIUS_CACHE_SPILL_SIZE_MEGABYTES", "1", true);
+    auto config = poolConfig(redis, size, depth);
+    unsetenv("RADIUS_CACHE_SPILL_FILE");
+    unsetenv("RADIUS_CACHE_SPILL_SIZE_MEGABYTES");
+    return config;
+  }
+
+  std::map<std::string, SpillJournal::Entry> replay(const SpillJournal & journal) {
+    std::map<std::string, SpillJournal::Entry> entries;
+    journal.replay([&entries](const SpillJournal::Entry & entry) {
+      entries[std::string{entry.key}] = entry;
+      return true;
+    });
+    return entries;
+  }
+}
+
+TEST(ConnectionPool, keys_spread_over_connections) {
+  FakeRedis redis;
+  ConnectionPool pool{poolConfig(redis, "4", "1")};
+  ASSERT_EQ(4, pool.size());
+
+  for (int i = 0; i < 64; ++i) {
+    ASSERT_TRUE(pool.set(std::to_string(i), "value"));
+  }
+
+  ASSERT_EQ(64, redis.data().size());
+  ASSERT_EQ(4, redis.connections());
+}
+
+TEST(ConnectionPool, pipelined_flushes_at_depth) {
+  FakeRedis redis;
+  ConnectionPool pool{poolConfig(redis, "2", "4")};
+
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(pool.set(std::to_string(i), "value"));
+  }
+  ASSERT_TRUE(redis.commands().empty());
+
+  ASSERT_TRUE(pool.set("3", "value"));
+  ASSERT_EQ(4, redis.data().size());
+
+  ASSERT_TRUE(pool.set("4", "value"));
+  ASSERT_TRUE(pool.flush());
+  ASSERT_EQ(5, redis.data().size());
+}
+
+TEST(ConnectionPool, same_key_stays_in_order) {
+  FakeRedis redis;
+  ConnectionPool pool{poolConfig(redis, "4", "8")};
+
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(pool.set(std::to_string(i), "value"));
+    ASSERT_TRUE(pool.remove(std::to_string(i)));
+  }
+  ASSERT_TRUE(pool.flush());
+
+  ASSERT_EQ(32, redis.commands().size());
+  ASSERT_TRUE(redis.data().empty());
+}
+
+TEST(ConnectionPool, warmup) {
+  FakeRedis redis;
+  ConnectionPool pool{poolConfig(redis, "3", "1")};
+  ASSERT_TRUE(pool.warmup());
+  ASSERT_TRUE(pool.healthy());
+
+  auto config = [] {
+    FakeRedis gone;
+    return poolConfig(gone, "3", "1");
+  }();
+  ConnectionPool unreachable{config};
+  ASSERT_FALSE(unreachable.warmup());
+}
+
+TEST(ConnectionPool, failed_flush_spills_every_queued_request) {
+  FakeRedis redis;
+  auto config = journalConfig(redis, "2", "8");
+  SpillJournal journal{config};
+  ConnectionPool pool{config, &journal};
+
+  ASSERT_TRUE(pool.set("1", "one"));
+  ASSERT_TRUE(pool.set("2", "two"));
+  ASSERT_TRUE(pool.remove("3"));
+  ASSERT_FALSE(journal.active());
+
+  redis.failing(true);
+  ASSERT_FALSE(pool.flush());
+
+  auto spilled = replay(journal);
+  ASSERT_EQ(3u, spilled.size());
+  ASSERT_EQ(SpillJournal::SET, spilled["1"].operation);
+  ASSERT_EQ("one", spilled["1"].value);
+  ASSERT_EQ(SpillJournal::SET, spilled["2"].operation);
+  ASSERT_EQ(SpillJournal::REMOVE, spilled["3"].operation);
+
+  // Nothing spilled is sent again by the pool
+  redis.failing(false);
+  auto sent = redis.commands().size();
+  ASSERT_TRUE(pool.set("4", "four"));
+  ASSERT_TRUE(pool.flush());
+  ASSERT_EQ(sent + 1, redis.commands().size());
+  ASSERT_EQ("4", redis.commands().back()[1]);
+}
+
+TEST(ConnectionPool, failed_flush_without_journal_counts_drops) {
+  FakeRedis redis;
+  auto config = poolConfig(redis, "2", "8");
+  setenv("RADIUS_CACHE_SPILL_FILE", "", true);
+  SpillJournal journal{Config::Cache::load("res/test/store.cfg")};
+  unsetenv("RADIUS_CACHE_SPILL_FILE");
+  ConnectionPool pool{config, &journal};
+
+  ASSERT_TRUE(pool.set("1", "one"));
+  ASSERT_TRUE(pool.set("2", "two"));
+  ASSERT_TRUE(pool.remove("3"));
+
+  redis.failing(true);
+  ASSERT_FALSE(pool.flush());
+  ASSERT_EQ(3u, journal.dropped());
+  ASSERT_FALSE(journal.active());
+}
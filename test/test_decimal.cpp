@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../src/decimal.hpp"
+
+namespace {
+  std::optional<std::uint64_t> parse(const std::string & text) {
+    auto begin = reinterpret_cast<const std::uint8_t *>(text.data());
+    return decimal::parse(begin, begin + text.size());
+  }
+}
+
+TEST(Decimal, parses_every_length) {
+  std::string text;
+  std::uint64_t expected{0};
+  for (int digits = 1; digits <= 19; ++digits) {
+    auto digit = static_cast<char>('0' + digits % 10);
+    text += digit;
+    expected = expected * 10 + (digit - '0');
+
+    ASSERT_EQ(expected, parse(text)) << text;
+  }
+}
+
+TEST(Decimal, limits) {
+  ASSERT_EQ(0u, parse("0"));
+  ASSERT_EQ(18446744073709551615u, parse("18446744073709551615"));
+  ASSERT_FALSE(parse("18446744073709551616"));
+  ASSERT_FALSE(parse("99999999999999999999"));
+  ASSERT_FALSE(parse("100000000000000000000"));
+}
+
+TEST(Decimal, leading_zeros) {
+  ASSERT_EQ(987654321u, parse("0987654321"));
+  ASSERT_EQ(0u, parse("0000000000"));
+  ASSERT_EQ(18446744073709551615u, parse("00000018446744073709551615"));
+}
+
+TEST(Decimal, rejects_non_digits) {
+  ASSERT_FALSE(parse(""));
+  ASSERT_FALSE(parse("user@realm"));
+  ASSERT_FALSE(parse("12345678a"));
+  ASSERT_FALSE(parse("a12345678"));
+  ASSERT_FALSE(parse("1234:678"));
+  ASSERT_FALSE(parse("1234/6789012"));
+  ASSERT_FALSE(parse("-1"));
+  ASSERT_FALSE(parse(" 1"));
+
+  // Every position of a whole word, with bytes right outside the digit range
+  for (std::size_t i = 0; i < 8; ++i) {
+    for (char bad : {'/', ':', '\0', '\xB0'}) {
+      std::string text{"12345678"};
+      text[i] = bad;
+      ASSERT_FALSE(parse(text)) << i << " " << static_cast<int>(bad);
+    }
+  }
+}
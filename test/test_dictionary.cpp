@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include "../src/dictionary.hpp"
+
+TEST(Dictionary, find_by_name) {
+  auto entry = radius::dictionary::find("FRAMED_IP_ADDRESS");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ((radius::AttributeId{0, 8}), entry->id);
+  ASSERT_EQ(radius::ADDRESS, entry->valueType);
+
+  ASSERT_EQ(entry, radius::dictionary::find("Framed-IP-Address"));
+  ASSERT_EQ(nullptr, radius::dictionary::find("FRAMED_IP"));
+  ASSERT_EQ(nullptr, radius::dictionary::find("FRAMED_IP_ADDRESS_"));
+  ASSERT_EQ(nullptr, radius::dictionary::find(""));
+}
+
+TEST(Dictionary, vendor_attributes) {
+  auto avPair = radius::dictionary::find("Cisco-AVPair");
+  ASSERT_NE(nullptr, avPair);
+  ASSERT_EQ((radius::AttributeId{9, 1}), avPair->id);
+
+  auto imsi = radius::dictionary::find("3GPP_IMSI");
+  ASSERT_NE(nullptr, imsi);
+  ASSERT_EQ((radius::AttributeId{10415, 1}), imsi->id);
+  ASSERT_EQ(radius::STRING, imsi->valueType);
+}
+
+TEST(Dictionary, find_by_id) {
+  ASSERT_STREQ("CALLING_STATION_ID", radius::dictionary::find(radius::AttributeId{0, 31})->name);
+  ASSERT_STREQ("FRAMED_IPV6_PREFIX", radius::dictionary::find(radius::AttributeId{0, 97})->name);
+  ASSERT_EQ(nullptr, radius::dictionary::find(radius::AttributeId{9, 31}));
+}
+
+TEST(Dictionary, constexpr_lookup) {
+  static_assert(radius::dictionary::find("NAS-IP-Address")->id.type == 4, "compile time lookup");
+}
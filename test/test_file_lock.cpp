@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "../src/file_lock.hpp"
+
+namespace {
+  const std::string PATH = "/tmp/radius-cacher-test-file.lock";
+}
+
+TEST(FileLock, waits_for_the_holder) {
+  auto holder = std::make_unique<FileLock>(PATH, "test");
+
+  std::atomic<bool> locked{false};
+  std::thread waiter{[&locked]() {
+    FileLock lock{PATH, "test"};
+    locked = true;
+  }};
+
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  ASSERT_FALSE(locked);
+
+  holder.reset();
+  waiter.join();
+  ASSERT_TRUE(locked);
+  std::remove(PATH.c_str());
+}
+
+TEST(FileLock, empty_path_locks_nothing) {
+  FileLock first{"", "test"};
+  FileLock second{"", "test"};
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <fstream>
+
 #include "../src/filter.hpp"
 
 struct FilterTester {
@@ -98,3 +100,44 @@ TEST(Filter, filter_reloader_works_properly) {
   ASSERT_TRUE(tester.filter.contains(9567));
   ASSERT_TRUE(tester.filter.contains(9345));
 }
+
+TEST(Filter, large_filter_is_parsed_across_chunks) {
+  const std::string path = "large_filter.txt";
+  {
+    std::ofstream stream{path, std::ios::trunc};
+    for (std::uint64_t i = 0; i < 500000; ++i) {
+      stream << "id " << i * 3 << " # comment 43\n";
+    }
+    stream << "no digits\n"
+           << "99999999999999999999999\n"
+           << "\n"
+           << "18446744073709551615";
+  }
+
+  FilterTester tester(path);
+
+  ASSERT_EQ(500001u, tester.getFilterSizer());
+  ASSERT_TRUE(tester.filter.contains(0));
+  ASSERT_TRUE(tester.filter.contains(3 * 250000));
+  ASSERT_TRUE(tester.filter.contains(3 * 499999));
+  ASSERT_TRUE(tester.filter.contains(18446744073709551615u));
+  ASSERT_FALSE(tester.filter.contains(43));
+  ASSERT_FALSE(tester.filter.contains(1));
+}
+
+TEST(Filter, duplicates_are_removed) {
+  const std::string path = "duplicate_filter.txt";
+  {
+    std::ofstream stream{path, std::ios::trunc};
+    for (std::uint64_t i = 0; i < 300000; ++i) {
+      stream << (i % 1000) * 7 << "\n";
+    }
+  }
+
+  FilterTester tester(path);
+
+  ASSERT_EQ(1000u, tester.getFilterSizer());
+  ASSERT_TRUE(tester.filter.contains(0));
+  ASSERT_TRUE(tester.filter.contains(999 * 7));
+  ASSERT_FALSE(tester.filter.contains(1));
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../src/handover.hpp"
+
+namespace {
+  const std::string PATH = "/tmp/radius-cacher-test-handover.sock";
+
+  int openUdp() {
+    auto socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    return socket;
+  }
+
+  unsigned short portOf(int socket) {
+    sockaddr_in address{};
+    socklen_t size{sizeof(address)};
+    ::getsockname(socket, reinterpret_cast<sockaddr *>(&address), &size);
+    return ntohs(address.sin_port);
+  }
+
+  bool exists(const std::string & path) {
+    struct stat status{};
+    return ::stat(path.c_str(), &status) == 0;
+  }
+
+  bool waitFor(const std::atomic<bool> & flag) {
+    for (int i = 0; i < 100 && !flag; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    return flag;
+  }
+}
+
+TEST(Handover, nothing_to_take) {
+  ::unlink(PATH.c_str());
+  ASSERT_TRUE(Handover::take(PATH).empty());
+  ASSERT_TRUE(Handover::take("").empty());
+}
+
+TEST(Handover, sockets_are_taken_over) {
+  auto first = openUdp();
+  auto second = openUdp();
+  std::atomic<bool> handedOver{false};
+  Handover handover{PATH, {first, second}, [&handedOver]() { handedOver = true; }};
+
+  auto sockets = Handover::take(PATH);
+  ASSERT_EQ(2u, sockets.size());
+  ASSERT_EQ(portOf(first), portOf(sockets[0]));
+  ASSERT_EQ(portOf(second), portOf(sockets[1]));
+  ASSERT_TRUE(waitFor(handedOver));
+
+  for (auto socket : {first, second, sockets[0], sockets[1]}) {
+    ::close(socket);
+  }
+}
+
+TEST(Handover, queued_datagrams_are_taken_along) {
+  auto socket = openUdp();
+  Handover handover{PATH, {socket}, []() {}};
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(portOf(socket));
+  auto sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+  ::sendto(sender, "queued", 6, 0, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+
+  auto sockets = Handover::take(PATH);
+  ASSERT_EQ(1u, sockets.size());
+  ::close(socket);
+
+  char buffer[16];
+  ASSERT_EQ(6, ::recv(sockets[0], buffer, sizeof(buffer), MSG_DONTWAIT));
+  ASSERT_EQ("queued", std::string(buffer, 6));
+
+  ::close(sender);
+  ::close(sockets[0]);
+}
+
+TEST(Handover, successor_keeps_the_path) {
+  auto socket = openUdp();
+  auto old = std::make_unique<Handover>(PATH, std::vector<int>{socket}, []() {});
+  auto sockets = Handover::take(PATH);
+  ASSERT_EQ(1u, sockets.size());
+
+  auto successor = std::make_unique<Handover>(PATH, sockets, []() {});
+  old.reset();
+  ASSERT_TRUE(exists(PATH));
+  auto again = Handover::take(PATH);
+  ASSERT_EQ(1u, again.size());
+
+  successor.reset();
+  ASSERT_FALSE(exists(PATH));
+
+  ::close(socket);
+  ::close(sockets[0]);
+  ::close(again[0]);
+}
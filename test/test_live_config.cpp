@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include "../src/live_config.hpp"
+
+namespace {
+
+  // One file per test, since ctest runs them in parallel
+  std::string path() {
+    return std::string{::testing::UnitTest::GetInstance()->current_test_info()->name()} + ".cfg";
+  }
+
+  void writeTtl(const std::string & ttl) {
+    std::ofstream stream{path(), std::ios::trunc};
+    stream << "HOST=localhost\nTTL=" << ttl << '\n';
+  }
+}
+
+TEST(LiveConfig, starts_with_the_files) {
+  writeTtl("100");
+  LiveConfig live{"res/test/server.cfg", path()};
+
+  ASSERT_EQ(0u, live.generation());
+  ASSERT_EQ(100, live.get()->cache.ttl);
+  ASSERT_EQ(987, live.get()->server.port);
+}
+
+TEST(LiveConfig, invalid_files_throw_at_start) {
+  writeTtl("abc");
+  ASSERT_ANY_THROW(LiveConfig(path(), path()));
+}
+
+TEST(LiveConfig, load_does_not_publish) {
+  writeTtl("100");
+  LiveConfig live{"res/test/server.cfg", path()};
+
+  writeTtl("200");
+  auto next = live.load();
+  ASSERT_NE(nullptr, next);
+  ASSERT_EQ(200, next->cache.ttl);
+  ASSERT_EQ(100, live.get()->cache.ttl);
+  ASSERT_EQ(0u, live.generation());
+}
+
+TEST(LiveConfig, publish_swaps_the_snapshot) {
+  writeTtl("100");
+  LiveConfig live{"res/test/server.cfg", path()};
+  auto held = live.get();
+
+  writeTtl("200");
+  live.publish(live.load());
+
+  ASSERT_EQ(1u, live.generation());
+  ASSERT_EQ(200, live.get()->cache.ttl);
+  // Whoever still holds the old snapshot keeps it intact
+  ASSERT_EQ(100, held->cache.ttl);
+}
+
+TEST(LiveConfig, invalid_reload_keeps_the_current_snapshot) {
+  writeTtl("100");
+  LiveConfig live{"res/test/server.cfg", path()};
+
+  writeTtl("abc");
+  ASSERT_EQ(nullptr, live.load());
+  ASSERT_EQ(100, live.get()->cache.ttl);
+  ASSERT_EQ(0u, live.generation());
+}
@@ -8,7 +8,7 @@
 #include "../src/logger.hpp"
 
 namespace logger {
-  Level verboseLevel = logger::NONE;
+  std::atomic<Level> verboseLevel{logger::NONE};
 }
 
 int main(int argc, char * argv[]) {
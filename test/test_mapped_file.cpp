@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include "../src/mapped_file.hpp"
+
+namespace {
+
+  // One file per test, since ctest runs them in parallel
+  std::string path() {
+    return std::string{::testing::UnitTest::GetInstance()->current_test_info()->name()} + ".txt";
+  }
+
+  void write(const std::string & content) {
+    std::ofstream{path(), std::ios::binary | std::ios::trunc} << content;
+  }
+
+  std::vector<std::string> lines(std::string_view text) {
+    std::vector<std::string> lines;
+    MappedFile::forEachLine(text, [&lines](std::string_view line) {
+      lines.emplace_back(line);
+    });
+    return lines;
+  }
+}
+
+TEST(MappedFile, missing_file_is_not_open) {
+  MappedFile file{"res/test/missing.txt"};
+  ASSERT_FALSE(file.isOpen());
+  ASSERT_TRUE(file.view().empty());
+}
+
+TEST(MappedFile, empty_file_is_open_and_empty) {
+  write("");
+  MappedFile file{path()};
+  ASSERT_TRUE(file.isOpen());
+  ASSERT_TRUE(file.view().empty());
+  ASSERT_TRUE(lines(file.view()).empty());
+}
+
+TEST(MappedFile, file_is_read_whole) {
+  MappedFile file{"res/test/filter.txt"};
+  ASSERT_TRUE(file.isOpen());
+  ASSERT_EQ((std::vector<std::string>{"123", "345", "567", "1234567890123456"}), lines(file.view()));
+}
+
+TEST(MappedFile, lines_keep_everything_but_the_line_feed) {
+  write("a\r\n\n  b  \nc");
+  MappedFile file{path()};
+  ASSERT_EQ((std::vector<std::string>{"a\r", "", "  b  ", "c"}), lines(file.view()));
+}
+
+TEST(MappedFile, split_cuts_at_line_ends) {
+  std::string text;
+  for (auto i = 0; i < 1000; ++i) {
+    text += std::to_string(i * 7919) + "\n";
+  }
+
+  auto chunks = MappedFile::split(text, 7, 100);
+  ASSERT_EQ(7u, chunks.size());
+
+  std::string joined;
+  for (auto chunk : chunks) {
+    ASSERT_FALSE(chunk.empty());
+    ASSERT_EQ('\n', chunk.back());
+    joined += chunk;
+  }
+  ASSERT_EQ(text, joined);
+}
+
+TEST(MappedFile, split_keeps_small_texts_whole) {
+  ASSERT_EQ(1u, MappedFile::split("1\n2\n3", 8, 100).size());
+  ASSERT_EQ(1u, MappedFile::split("", 8, 100).size());
+
+  // Without a line feed to cut at, the text stays in one piece
+  std::string line(1000, 'x');
+  ASSERT_EQ(1u, MappedFile::split(line, 8, 10).size());
+}
@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "../src/proxy.hpp"
+
+namespace {
+
+  /**
+   * A UDP socket on the loopback, playing either a NAS or an upstream
+   */
+  struct Peer {
+    int socket;
+    sockaddr_in address{};
+
+    Peer() : socket{::socket(AF_INET, SOCK_DGRAM, 0)} {
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      ::bind(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+      socklen_t size{sizeof(address)};
+      ::getsockname(socket, reinterpret_cast<sockaddr *>(&address), &size);
+    }
+
+    ~Peer() {
+      ::close(socket);
+    }
+
+    std::string name() const {
+      return "127.0.0.1:" + std::to_string(ntohs(address.sin_port));
+    }
+
+    const sockaddr * data() const {
+      return reinterpret_cast<const sockaddr *>(&address);
+    }
+
+    std::optional<std::vector<std::uint8_t>> receive(sockaddr_in * source = nullptr, int waitMillis = 1000) const {
+      pollfd ready{socket, POLLIN, 0};
+      if (::poll(&ready, 1, waitMillis) != 1) {
+        return std::nullopt;
+      }
+
+      std::vector<std::uint8_t> packet(4096);
+      sockaddr_in from{};
+      socklen_t size{sizeof(from)};
+      auto bytes = ::recvfrom(socket, packet.data(), packet.size(), 0, reinterpret_cast<sockaddr *>(&from), &size);
+      packet.resize(static_cast<std::size_t>(bytes));
+      if (source) *source = from;
+      return packet;
+    }
+
+    void send(const std::vector<std::uint8_t> & packet, const sockaddr_in & to) const {
+      ::sendto(socket, packet.data(), packet.size(), 0, reinterpret_cast<const sockaddr *>(&to), sizeof(to));
+    }
+  };
+
+  std::vector<std::uint8_t> packet(std::uint8_t code, std::uint8_t id) {
+    std::vector<std::uint8_t> packet(26, 0xAB);
+    packet[0] = code;
+    packet[1] = id;
+    packet[2] = 0;
+    packet[3] = 26;
+    return packet;
+  }
+
+  std::vector<std::uint8_t> request(std::uint8_t id) {
+    return packet(4, id);
+  }
+
+  std::vector<std::uint8_t> response(std::uint8_t id) {
+    return packet(5, id);
+  }
+}
+
+TEST(Proxy, disabled_without_upstreams) {
+  Proxy proxy{"", 4, std::chrono::milliseconds{1000}};
+  ASSERT_FALSE(proxy.enabled());
+}
+
+TEST(Proxy, invalid_upstreams) {
+  ASSERT_THROW((Proxy{"127.0.0.1", 4, std::chrono::milliseconds{1000}}), std::runtime_error);
+  ASSERT_THROW((Proxy{"127.0.0.1:1813,", 4, std::chrono::milliseconds{1000}}), std::runtime_error);
+  ASSERT_THROW((Proxy{":1813", 4, std::chrono::milliseconds{1000}}), std::runtime_error);
+}
+
+TEST(Proxy, forwards_unchanged_and_relays_response) {
+  Peer upstream;
+  Peer nas;
+  Peer listener;
+  Proxy proxy{upstream.name(), 4, std::chrono::milliseconds{1000}};
+  ASSERT_TRUE(proxy.enabled());
+
+  auto sent = request(42);
+  ASSERT_TRUE(proxy.forward(sent.data(), sent.size(), listener.socket, nas.data(), sizeof(sockaddr_in)));
+
+  sockaddr_in proxySocket{};
+  auto forwarded = upstream.receive(&proxySocket);
+  ASSERT_TRUE(forwarded);
+  ASSERT_EQ(sent, *forwarded);
+
+  upstream.send(response(42), proxySocket);
+
+  sockaddr_in source{};
+  auto relayed = nas.receive(&source);
+  ASSERT_TRUE(relayed);
+  ASSERT_EQ(response(42), *relayed);
+  ASSERT_EQ(listener.address.sin_port, source.sin_port);
+}
+
+TEST(Proxy, only_primary_is_relayed) {
+  Peer primary;
+  Peer mirror;
+  Peer nas;
+  Peer listener;
+  Proxy proxy{primary.name() + ", " + mirror.name(), 4, std::chrono::milliseconds{5000}};
+
+  auto sent = request(7);
+  ASSERT_TRUE(proxy.forward(sent.data(), sent.size(), listener.socket, nas.data(), sizeof(sockaddr_in)));
+
+  sockaddr_in fromPrimary{};
+  sockaddr_in fromMirror{};
+  ASSERT_EQ(sent, primary.receive(&fromPrimary));
+  ASSERT_EQ(sent, mirror.receive(&fromMirror));
+
+  mirror.send(response(7), fromMirror);
+  ASSERT_FALSE(nas.receive(nullptr, 100));
+
+  primary.send(response(7), fromPrimary);
+  ASSERT_EQ(response(7), nas.receive());
+}
+
+TEST(Proxy, failed_mirror_does_not_hold_up_the_next) {
+  Peer primary;
+  Peer mirror;
+  Peer nas;
+  Peer listener;
+
+  // Broadcasts are refused without SO_BROADCAST
+  Proxy proxy{primary.name() + ", 255.255.255.255:1813, " + mirror.name(), 4, std::chrono::milliseconds{5000}};
+
+  auto sent = request(7);
+  ASSERT_TRUE(proxy.forward(sent.data(), sent.size(), listener.socket, nas.data(), sizeof(sockaddr_in)));
+  ASSERT_EQ(sent, primary.receive());
+  ASSERT_EQ(sent, mirror.receive());
+  ASSERT_NE(std::string::npos, proxy.report().find("proxy.mirror_dropped 1"));
+}
+
+TEST(Proxy, same_id_in_flight_takes_another_socket) {
+  Peer upstream;
+  Peer first;
+  Peer second;
+  Peer third;
+  Peer listener;
+  Proxy proxy{upstream.name(), 2, std::chrono::milliseconds{1000}};
+
+  auto sent = request(9);
+  ASSERT_TRUE(proxy.forward(sent.data(), sent.size(), listener.socket, first.data(), sizeof(sockaddr_in)));
+  ASSERT_TRUE(proxy.forward(sent.data(), sent.size(), listener.socket, second.data(), sizeof(sockaddr_in)));
+  ASSERT_FALSE(proxy.forward(sent.data(), sent.size(), listener.socket, third.data(), sizeof(sockaddr_in)));
+
+  // A retransmission keeps its entry
+  ASSERT_TRUE(proxy.forward(sent.data(), sent.size(), listener.socket, first.data(), sizeof(sockaddr_in)));
+
+  sockaddr_in socketA{};
+  sockaddr_in socketB{};
+  ASSERT_TRUE(upstream.receive(&socketA));
+  ASSERT_TRUE(upstream.receive(&socketB));
+  ASSERT_NE(socketA.sin_port, socketB.sin_port);
+
+  // Each response goes back to the NAS whose request went out on that socket
+  upstream.send(response(9), socketA);
+  upstream.send(response(9), socketB);
+  ASSERT_TRUE(first.receive());
+  ASSERT_TRUE(second.receive());
+  ASSERT_FALSE(third.receive(nullptr, 100));
+}
+
+TEST(Proxy, expired_entry_is_reused) {
+  Peer upstream;
+  Peer first;
+  Peer second;
+  Peer listener;
+  Proxy proxy{upstream.name(), 1, std::chrono::milliseconds{50}};
+
+  auto sent = request(1);
+  ASSERT_TRUE(proxy.forward(sent.data(), sent.size(), listener.socket, first.data(), sizeof(sockaddr_in)));
+  ASSERT_FALSE(proxy.forward(sent.data(), sent.size(), listener.socket, second.data(), sizeof(sockaddr_in)));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds{100});
+  ASSERT_TRUE(proxy.forward(sent.data(), sent.size(), listener.socket, second.data(), sizeof(sockaddr_in)));
+}
+
+TEST(Proxy, short_packet_is_dropped) {
+  Peer upstream;
+  Peer nas;
+  Proxy proxy{upstream.name(), 1, std::chrono::milliseconds{1000}};
+
+  auto sent = request(1);
+  ASSERT_FALSE(proxy.forward(sent.data(), 10, nas.socket, nas.data(), sizeof(sockaddr_in)));
+  ASSERT_FALSE(upstream.receive(nullptr, 100));
+  ASSERT_NE(std::string::npos, proxy.report().find("proxy.dropped 1"));
+}
@@ -63,7 +63,7 @@ namespace {
 class Parser : public ::testing::Test {
 public:
   RadiusParser parser{"res/test/filter.txt", std::chrono::minutes{0}};
-  std::array<std::uint8_t, 128> buffer{};
+  std::array<std::uint8_t, 512> buffer{};
 };
 
 TEST_F(Parser, empty_buffer) {
@@ -116,6 +116,8 @@ TEST_F(Parser, start) {
   ASSERT_EQ(Action::STORE, action.action);
   ASSERT_EQ("192.168.10.22", *action.key);
   ASSERT_EQ("987654321", *action.value);
+  ASSERT_EQ((std::array<std::uint8_t, 4>{192, 168, 10, 22}), *action.address);
+  ASSERT_EQ(987654321u, *action.subscriberId);
 }
 
 TEST_F(Parser, update) {
@@ -126,6 +128,7 @@ TEST_F(Parser, update) {
 
   auto action = parser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
   ASSERT_EQ(Action::STORE, action.action);
+  ASSERT_EQ(radius::StatusType::UPDATE, action.status);
   ASSERT_EQ("192.168.10.22", *action.key);
   ASSERT_EQ("987654321", *action.value);
 }
@@ -174,3 +177,286 @@ TEST_F(Parser, corrupted_data) {
   auto action = parser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
   ASSERT_EQ(Action::DO_NOTHING, action.action);
 }
+
+TEST_F(Parser, many_vendor_attributes) {
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  for (int i = 0; i < 30; ++i) {
+    ptr = addAttribute(ptr, 26, std::array<std::uint8_t, 8>{0, 0, 0, 9, 1, 4, 'a', 'b'});
+  }
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+
+  auto action = parser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::STORE, action.action);
+  ASSERT_EQ("192.168.10.22", *action.key);
+  ASSERT_EQ("987654321", *action.value);
+}
+
+TEST_F(Parser, corrupted_attribute_after_selected_ones) {
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  ptr = addAttribute(ptr, 44, "session");
+  *(ptr - 8) = 1;
+
+  // The scan stops at User-Name, so the Acct-Session-Id is never read
+  auto action = parser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::STORE, action.action);
+  ASSERT_EQ("987654321", *action.value);
+}
+
+TEST_F(Parser, corrupted_attribute_before_selected_ones) {
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, 44, "session");
+  *(ptr - 8) = 1;
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+
+  auto action = parser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::DO_NOTHING, action.action);
+}
+
+TEST_F(Parser, invalid_address_size) {
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 3>{192, 168, 10});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+
+  auto action = parser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::DO_NOTHING, action.action);
+}
+
+TEST_F(Parser, non_numeric_user_name) {
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "user@realm");
+
+  auto action = parser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::STORE, action.action);
+  ASSERT_EQ("user@realm", *action.value);
+  ASSERT_FALSE(action.subscriberId);
+}
+
+TEST_F(Parser, filtering_ignores_leading_zeros) {
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "001234567890123456");
+
+  auto action = parser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::FILTER, action.action);
+  ASSERT_EQ(1234567890123456u, *action.subscriberId);
+}
+
+TEST_F(Parser, unknown_attribute_names) {
+  ASSERT_ANY_THROW((RadiusParser{"res/test/filter.txt", std::chrono::minutes{0}, "NOT_AN_ATTRIBUTE", "USER_NAME"}));
+  ASSERT_ANY_THROW((RadiusParser{"res/test/filter.txt", std::chrono::minutes{0}, "FRAMED_IP_ADDRESS", "NOPE"}));
+}
+
+TEST_F(Parser, vendor_value) {
+  RadiusParser imsiParser{"res/test/filter.txt", std::chrono::minutes{0}, "FRAMED_IP_ADDRESS", "3GPP-IMSI"};
+
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  ptr = addAttribute(ptr, 26, std::array<std::uint8_t, 12>{0, 0, 0x28, 0xAF, 1, 8, '2', '4', '2', '0', '1', '5'});
+
+  auto action = imsiParser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::STORE, action.action);
+  ASSERT_EQ("192.168.10.22", *action.key);
+  ASSERT_EQ("242015", *action.value);
+  ASSERT_EQ(242015u, *action.subscriberId);
+}
+
+TEST_F(Parser, string_key) {
+  RadiusParser stationParser{"res/test/filter.txt", std::chrono::minutes{0}, "Calling-Station-Id", "USER_NAME"};
+
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::STOP);
+  ptr = addAttribute(ptr, 31, "00-11-22-33-44-55");
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+
+  auto action = stationParser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::REMOVE, action.action);
+  ASSERT_EQ("00-11-22-33-44-55", *action.key);
+  ASSERT_FALSE(action.address);
+}
+
+TEST_F(Parser, projection) {
+  RadiusParser projectionParser{"res/test/filter.txt",
+                                std::chrono::minutes{0},
+                                "FRAMED_IP_ADDRESS",
+                                "USER_NAME, Acct-Session-Id,NAS-IP-Address"};
+
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  ptr = addAttribute(ptr, 44, "session");
+
+  auto action = projectionParser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::STORE, action.action);
+  ASSERT_EQ("987654321", *action.value);
+  ASSERT_EQ(987654321u, *action.subscriberId);
+  ASSERT_TRUE(action.record);
+
+  auto fields = codec::decodeRecord(*action.record);
+  ASSERT_TRUE(fields);
+  ASSERT_EQ(3, fields->size());
+  ASSERT_EQ("987654321", *(*fields)[0]);
+  ASSERT_EQ("session", *(*fields)[1]);
+  ASSERT_FALSE((*fields)[2]);
+}
+
+TEST_F(Parser, single_value_has_no_record) {
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+
+  auto action = parser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::STORE, action.action);
+  ASSERT_FALSE(action.record);
+}
+
+TEST_F(Parser, malformed_projection) {
+  ASSERT_ANY_THROW((RadiusParser{"res/test/filter.txt", std::chrono::minutes{0}, "FRAMED_IP_ADDRESS", ""}));
+  ASSERT_ANY_THROW((RadiusParser{"res/test/filter.txt", std::chrono::minutes{0}, "FRAMED_IP_ADDRESS", "USER_NAME,"}));
+  ASSERT_ANY_THROW((RadiusParser{"res/test/filter.txt", std::chrono::minutes{0}, "FRAMED_IP_ADDRESS", "USER_NAME, ,CLASS"}));
+  ASSERT_ANY_THROW((RadiusParser{"res/test/filter.txt", std::chrono::minutes{0}, "FRAMED_IP_ADDRESS", "USER_NAME,NOPE"}));
+}
+
+TEST_F(Parser, ipv6_prefix_keys) {
+  RadiusParser dualStackParser{"res/test/filter.txt",
+                               std::chrono::minutes{0},
+                               "FRAMED_IP_ADDRESS, FRAMED_IPV6_PREFIX, DELEGATED_IPV6_PREFIX",
+                               "USER_NAME"};
+
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  ptr = addAttribute(ptr,
+                     radius::Attribute::FRAMED_IPV6_PREFIX,
+                     std::array<std::uint8_t, 10>{0, 64, 0x20, 0x01, 0x0D, 0xB8, 0, 0x01, 0, 0});
+  ptr = addAttribute(ptr,
+                     radius::Attribute::DELEGATED_IPV6_PREFIX,
+                     std::array<std::uint8_t, 9>{0, 52, 0x20, 0x01, 0x0D, 0xB8, 0xAB, 0xCD, 0xFF});
+
+  auto action = dualStackParser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::STORE, action.action);
+  ASSERT_EQ("192.168.10.22", *action.key);
+  ASSERT_EQ(2, action.prefixes.size());
+
+  std::array<std::uint8_t, 16> framed{0x20, 0x01, 0x0D, 0xB8, 0, 0x01};
+  std::array<std::uint8_t, 16> delegated{0x20, 0x01, 0x0D, 0xB8, 0xAB, 0xCD, 0xF0};
+  ASSERT_EQ(framed, action.prefixes[0]);
+  ASSERT_EQ(delegated, action.prefixes[1]);
+}
+
+TEST_F(Parser, ipv6_prefix_only) {
+  RadiusParser prefixParser{"res/test/filter.txt", std::chrono::minutes{0}, "FRAMED_IP_ADDRESS,FRAMED_IPV6_PREFIX"};
+
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::STOP);
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IPV6_PREFIX, std::array<std::uint8_t, 4>{0, 16, 0x20, 0x01});
+
+  auto action = prefixParser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::REMOVE, action.action);
+  ASSERT_FALSE(action.key);
+  ASSERT_EQ(1, action.prefixes.size());
+}
+
+TEST_F(Parser, invalid_ipv6_prefix) {
+  RadiusParser prefixParser{"res/test/filter.txt", std::chrono::minutes{0}, "FRAMED_IP_ADDRESS,FRAMED_IPV6_PREFIX"};
+
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IPV6_PREFIX, std::array<std::uint8_t, 4>{0, 129, 0x20, 0x01});
+
+  auto action = prefixParser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::DO_NOTHING, action.action);
+}
+
+TEST_F(Parser, single_text_key) {
+  ASSERT_ANY_THROW((RadiusParser{"res/test/filter.txt", std::chrono::minutes{0}, "FRAMED_IP_ADDRESS,CALLING_STATION_ID"}));
+}
+
+TEST_F(Parser, range_filtering) {
+  RadiusParser rangeParser{"res/test/filter.txt",
+                           std::chrono::minutes{0},
+                           "FRAMED_IP_ADDRESS",
+                           "USER_NAME",
+                           "res/test/range_filter.txt"};
+
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  auto length = closePacket(buffer.begin(), ptr);
+
+  ASSERT_EQ(Action::FILTER, rangeParser(length, buffer.begin(), buffer.end()).action);
+  ASSERT_EQ(Action::STORE, parser(length, buffer.begin(), buffer.end()).action);
+}
+
+TEST_F(Parser, range_filtering_with_another_address_key) {
+  RadiusParser rangeParser{"res/test/filter.txt",
+                           std::chrono::minutes{0},
+                           "NAS_IP_ADDRESS",
+                           "USER_NAME",
+                           "res/test/range_filter.txt"};
+
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, 4, std::array<std::uint8_t, 4>{192, 168, 10, 22});
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{172, 16, 0, 1});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  auto length = closePacket(buffer.begin(), ptr);
+
+  // The NAS is in a filtered range, but not the subscriber
+  auto action = rangeParser(length, buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::STORE, action.action);
+  ASSERT_EQ("192.168.10.22", *action.key);
+
+  ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, 4, std::array<std::uint8_t, 4>{172, 16, 0, 1});
+  ptr = addAttribute(ptr, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{10, 1, 2, 130});
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+
+  ASSERT_EQ(Action::FILTER, rangeParser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end()).action);
+}
+
+TEST_F(Parser, range_filtering_with_string_key) {
+  RadiusParser rangeParser{"res/test/filter.txt",
+                           std::chrono::minutes{0},
+                           "USER_NAME",
+                           "Calling-Station-Id",
+                           "res/test/range_filter.txt"};
+
+  auto ptr = addHeader(buffer.begin(), radius::Header::REQUEST);
+  ptr = addAttribute(ptr, radius::Attribute::ACCT_STATUS_TYPE, radius::StatusType::START);
+  ptr = addAttribute(ptr, radius::Attribute::USER_NAME, "987654321");
+  ptr = addAttribute(ptr, 31, "00-11-22-33-44-55");
+  auto length = closePacket(buffer.begin(), ptr);
+
+  // No Framed-IP-Address, so no range to match
+  ASSERT_EQ(Action::STORE, rangeParser(length, buffer.begin(), buffer.end()).action);
+
+  ptr = addAttribute(buffer.begin() + length, radius::Attribute::FRAMED_IP_ADDRESS, std::array<std::uint8_t, 4>{10, 2, 0, 1});
+  auto action = rangeParser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end());
+  ASSERT_EQ(Action::FILTER, action.action);
+  ASSERT_EQ("987654321", *action.key);
+  ASSERT_FALSE(action.address);
+
+  // Outside of the ranges
+  *(ptr - 4) = 11;
+  ASSERT_EQ(Action::STORE, rangeParser(closePacket(buffer.begin(), ptr), buffer.begin(), buffer.end()).action);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "../src/radix_sort.hpp"
+
+namespace {
+  std::vector<std::uint64_t> random(std::size_t count, std::uint64_t min, std::uint64_t max) {
+    std::mt19937_64 engine{count};
+    std::uniform_int_distribution<std::uint64_t> distribution{min, max};
+    std::vector<std::uint64_t> values(count);
+    for (auto & value : values) {
+      value = distribution(engine);
+    }
+    return values;
+  }
+
+  void expectSorted(std::vector<std::uint64_t> values, std::size_t threads) {
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::uint64_t> scratch;
+    radix::sort(values, scratch, threads);
+    ASSERT_EQ(expected, values);
+  }
+}
+
+TEST(RadixSort, small_input_is_sorted) {
+  expectSorted({}, 4);
+  expectSorted({3, 1, 2}, 4);
+  expectSorted(random(1000, 0, UINT64_MAX), 4);
+}
+
+TEST(RadixSort, full_range_is_sorted) {
+  expectSorted(random(1 << 20, 0, UINT64_MAX), 1);
+  expectSorted(random(1 << 20, 0, UINT64_MAX), 4);
+}
+
+TEST(RadixSort, shared_digits_are_skipped) {
+  // Identifiers of one magnitude share their top digits, and these multiples of 2048 their lowest
+  auto values = random(1 << 20, 100000000000000, 999999999999999);
+  for (auto & value : values) {
+    value &= ~std::uint64_t{0x7FF};
+  }
+  expectSorted(values, 3);
+}
+
+TEST(RadixSort, duplicates_are_kept) {
+  auto values = random(1 << 20, 0, 1000);
+  values.push_back(UINT64_MAX);
+  values.push_back(0);
+  expectSorted(values, 8);
+}
+
+TEST(RadixSort, equal_values_are_sorted) {
+  expectSorted(std::vector<std::uint64_t>(1 << 20, 42), 4);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include "../src/range_filter.hpp"
+
+struct RangeFilterTester {
+  RangeFilter filter;
+
+  RangeFilterTester(std::string path, unsigned short seconds = 0)
+      : filter{std::move(path), std::chrono::seconds{seconds}} {}
+
+  auto inline getSize() const {
+    return filter.mTables[filter.mCurrent].size;
+  }
+
+  auto inline getChunks() const {
+    return filter.mTables[filter.mCurrent].chunks.size();
+  }
+
+  void inline setFilePath(const std::string & path) {
+    auto * targetPath = (std::string *)&(filter.mFilePath);
+    *targetPath = path;
+  }
+
+  void inline reload() {
+    filter.reload();
+  }
+};
+
+namespace {
+  std::uint32_t address(std::uint8_t a, std::uint8_t b, std::uint8_t c, std::uint8_t d) {
+    return static_cast<std::uint32_t>(a) << 24u | static_cast<std::uint32_t>(b) << 16u
+           | static_cast<std::uint32_t>(c) << 8u | d;
+  }
+}
+
+TEST(RangeFilter, no_file_filters_nothing) {
+  RangeFilterTester tester("");
+  ASSERT_EQ(0u, tester.getSize());
+  ASSERT_FALSE(tester.filter.contains(address(10, 0, 0, 1)));
+
+  RangeFilterTester missing("res/test/not_there.txt");
+  ASSERT_FALSE(missing.filter.contains(address(10, 0, 0, 1)));
+}
+
+TEST(RangeFilter, skips_malformed_lines) {
+  RangeFilterTester tester("res/test/range_filter.txt");
+  ASSERT_EQ(5u, tester.getSize());
+  ASSERT_FALSE(tester.filter.contains(address(172, 16, 0, 1)));
+}
+
+TEST(RangeFilter, longest_prefix_decides) {
+  RangeFilterTester tester("res/test/range_filter.txt");
+
+  ASSERT_TRUE(tester.filter.contains(address(10, 0, 0, 0)));
+  ASSERT_TRUE(tester.filter.contains(address(10, 255, 255, 255)));
+  ASSERT_FALSE(tester.filter.contains(address(11, 0, 0, 0)));
+  ASSERT_FALSE(tester.filter.contains(address(9, 255, 255, 255)));
+
+  // Carved out of the /8
+  ASSERT_FALSE(tester.filter.contains(address(10, 1, 0, 1)));
+  ASSERT_FALSE(tester.filter.contains(address(10, 1, 2, 127)));
+
+  // Put back within the hole, minus a single address
+  ASSERT_TRUE(tester.filter.contains(address(10, 1, 2, 128)));
+  ASSERT_TRUE(tester.filter.contains(address(10, 1, 2, 199)));
+  ASSERT_FALSE(tester.filter.contains(address(10, 1, 2, 200)));
+  ASSERT_TRUE(tester.filter.contains(address(10, 1, 2, 255)));
+
+  ASSERT_TRUE(tester.filter.contains(std::array<std::uint8_t, 4>{192, 168, 10, 22}));
+  ASSERT_FALSE(tester.filter.contains(std::array<std::uint8_t, 4>{192, 168, 10, 23}));
+
+  ASSERT_EQ(2u, tester.getChunks());
+}
+
+TEST(RangeFilter, reloads_properly) {
+  RangeFilterTester tester("res/test/range_filter.txt");
+  ASSERT_TRUE(tester.filter.contains(address(10, 0, 0, 1)));
+
+  tester.setFilePath("res/test/range_filter2.txt");
+  tester.reload();
+
+  ASSERT_EQ(1u, tester.getSize());
+  ASSERT_EQ(0u, tester.getChunks());
+  ASSERT_FALSE(tester.filter.contains(address(10, 0, 0, 1)));
+  ASSERT_TRUE(tester.filter.contains(address(100, 64, 0, 0)));
+  ASSERT_TRUE(tester.filter.contains(address(100, 127, 255, 255)));
+  ASSERT_FALSE(tester.filter.contains(address(100, 128, 0, 0)));
+}
+
+TEST(RangeFilter, keeps_previous_table_if_file_is_gone) {
+  RangeFilterTester tester("res/test/range_filter2.txt");
+
+  tester.setFilePath("res/test/not_there.txt");
+  tester.reload();
+
+  ASSERT_TRUE(tester.filter.contains(address(100, 64, 0, 0)));
+}
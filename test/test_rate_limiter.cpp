@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <arpa/inet.h>
+
+#include "../src/rate_limiter.hpp"
+
+namespace {
+
+  using namespace std::chrono_literals;
+
+  std::vector<std::uint8_t> packet(std::uint8_t status) {
+    return {
+        4, 1, 0, 26,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        40, 6, 0, 0, 0, status
+    };
+  }
+
+  const auto START = packet(1);
+  const auto UPDATE = packet(3);
+
+  constexpr std::uint32_t NAS_A = 0x0A000001;
+  constexpr std::uint32_t NAS_B = 0x0A000002;
+
+  bool admit(RateLimiter & limiter, std::uint32_t nas, const std::vector<std::uint8_t> & packet, RateLimiter::Clock::time_point now) {
+    return limiter.admit(nas, packet.data(), packet.size(), now);
+  }
+}
+
+TEST(RateLimiter, disabled_admits_everything) {
+  RateLimiter limiter{0, 0, 0};
+  ASSERT_FALSE(limiter.enabled());
+
+  auto now = RateLimiter::Clock::now();
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(admit(limiter, NAS_A, UPDATE, now));
+  }
+}
+
+TEST(RateLimiter, nas_is_held_to_its_burst) {
+  RateLimiter limiter{10, 10, 0};
+  auto now = RateLimiter::Clock::now();
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(admit(limiter, NAS_A, START, now));
+  }
+  ASSERT_FALSE(admit(limiter, NAS_A, START, now));
+
+  // Other NASes have buckets of their own
+  ASSERT_TRUE(admit(limiter, NAS_B, START, now));
+}
+
+TEST(RateLimiter, bucket_refills_at_rate) {
+  RateLimiter limiter{10, 10, 0};
+  auto now = RateLimiter::Clock::now();
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(admit(limiter, NAS_A, START, now));
+  }
+  ASSERT_FALSE(admit(limiter, NAS_A, START, now));
+
+  ASSERT_FALSE(admit(limiter, NAS_A, START, now + 50ms));
+  ASSERT_TRUE(admit(limiter, NAS_A, START, now + 100ms));
+  ASSERT_FALSE(admit(limiter, NAS_A, START, now + 100ms));
+
+  ASSERT_TRUE(admit(limiter, NAS_A, START, now + 1100ms));
+}
+
+TEST(RateLimiter, updates_are_shed_first) {
+  RateLimiter limiter{10, 10, 0};
+  auto now = RateLimiter::Clock::now();
+
+  // Updates may only take the upper half of the bucket
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(admit(limiter, NAS_A, UPDATE, now));
+  }
+  ASSERT_FALSE(admit(limiter, NAS_A, UPDATE, now));
+
+  // Starts and stops get the rest
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(admit(limiter, NAS_A, START, now));
+  }
+  ASSERT_FALSE(admit(limiter, NAS_A, START, now));
+}
+
+TEST(RateLimiter, single_packet_burst_admits_updates) {
+  RateLimiter limiter{1, 1, 0};
+  auto now = RateLimiter::Clock::now();
+
+  ASSERT_TRUE(admit(limiter, NAS_A, UPDATE, now));
+  ASSERT_FALSE(admit(limiter, NAS_A, UPDATE, now));
+  ASSERT_TRUE(admit(limiter, NAS_A, UPDATE, now + 1s));
+}
+
+TEST(RateLimiter, global_budget) {
+  RateLimiter limiter{0, 0, 4};
+  auto now = RateLimiter::Clock::now();
+
+  ASSERT_TRUE(admit(limiter, NAS_A, START, now));
+  ASSERT_TRUE(admit(limiter, NAS_B, START, now));
+  ASSERT_TRUE(admit(limiter, NAS_A, START, now));
+  ASSERT_TRUE(admit(limiter, 0, START, now));
+  ASSERT_FALSE(admit(limiter, NAS_B, START, now));
+  ASSERT_NE(std::string::npos, limiter.report().find("limiter.shed.global 1\n"));
+}
+
+TEST(RateLimiter, shed_counters_per_nas) {
+  RateLimiter limiter{1, 1, 0};
+  auto now = RateLimiter::Clock::now();
+
+  ASSERT_TRUE(admit(limiter, NAS_A, START, now));
+  ASSERT_FALSE(admit(limiter, NAS_A, START, now));
+  ASSERT_FALSE(admit(limiter, NAS_A, START, now));
+  ASSERT_TRUE(admit(limiter, NAS_B, START, now));
+
+  auto report = limiter.report();
+  ASSERT_NE(std::string::npos, report.find("limiter.shed.nas.10.0.0.1 2\n"));
+  ASSERT_EQ(std::string::npos, report.find("10.0.0.2"));
+}
+
+TEST(RateLimiter, source_address) {
+  RateLimiter limiter{1, 1, 0};
+  auto now = RateLimiter::Clock::now();
+
+  sockaddr_in source{};
+  source.sin_family = AF_INET;
+  source.sin_addr.s_addr = htonl(NAS_A);
+
+  auto address = reinterpret_cast<const sockaddr *>(&source);
+  ASSERT_TRUE(limiter.admit(address, START.data(), START.size(), now));
+  ASSERT_FALSE(limiter.admit(address, START.data(), START.size(), now));
+  ASSERT_FALSE(admit(limiter, NAS_A, START, now));
+}
+
+TEST(RateLimiter, many_nases) {
+  RateLimiter limiter{1, 1, 0};
+  auto now = RateLimiter::Clock::now();
+
+  // More NASes than slots: those left out are not limited
+  for (std::uint32_t nas = 1; nas <= 5000; ++nas) {
+    ASSERT_TRUE(admit(limiter, nas, START, now));
+  }
+}
+
+TEST(RateLimiter, global_rejection_refunds_the_nas) {
+  RateLimiter limiter{1, 5, 10};
+  auto now = RateLimiter::Clock::now();
+
+  // Two other NASes take the whole global budget
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(admit(limiter, NAS_B, START, now));
+    ASSERT_TRUE(admit(limiter, NAS_B + 1, START, now));
+  }
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_FALSE(admit(limiter, NAS_A, START, now));
+  }
+
+  // Once the global bucket refills, the NAS still has its whole burst
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(admit(limiter, NAS_A, START, now + 1s));
+  }
+  ASSERT_FALSE(admit(limiter, NAS_A, START, now + 1s));
+}
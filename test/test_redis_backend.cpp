@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "fake_redis.hpp"
+#include "../src/redis_backend.hpp"
+
+TEST(RedisBackend, set_with_expiry) {
+  FakeRedis redis;
+  RedisBackend backend{redis.config(), false};
+
+  ASSERT_TRUE(backend.set("192.168.10.22", "987654321", 60));
+  ASSERT_TRUE(backend.set("192.168.10.23", "123456789", 0));
+
+  auto commands = redis.commands();
+  ASSERT_EQ(2, commands.size());
+  ASSERT_EQ((std::vector<std::string>{"SET", "192.168.10.22", "987654321", "EX", "60"}), commands[0]);
+  ASSERT_EQ((std::vector<std::string>{"SET", "192.168.10.23", "123456789"}), commands[1]);
+}
+
+TEST(RedisBackend, remove_missing_key_succeeds) {
+  FakeRedis redis;
+  RedisBackend backend{redis.config(), false};
+
+  ASSERT_TRUE(backend.set("192.168.10.22", "987654321", 60));
+  ASSERT_TRUE(backend.remove("192.168.10.22"));
+  ASSERT_TRUE(backend.remove("192.168.10.22"));
+  ASSERT_TRUE(redis.data().empty());
+}
+
+TEST(RedisBackend, binary_safe) {
+  FakeRedis redis;
+  RedisBackend backend{redis.config(), false};
+  std::string key{"rc\xC0\xA8\r\n", 6};
+  std::string value{"\x01\x00\r\n$3", 6};
+
+  ASSERT_TRUE(backend.set(key, value, 60));
+  ASSERT_EQ(value, redis.data()[key]);
+}
+
+TEST(RedisBackend, pipelined_holds_until_flush) {
+  FakeRedis redis;
+  RedisBackend backend{redis.config(), true};
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(backend.set(std::to_string(i), "value", 60));
+  }
+  ASSERT_TRUE(redis.commands().empty());
+
+  ASSERT_TRUE(backend.flush());
+  ASSERT_EQ(100, redis.data().size());
+}
+
+TEST(RedisBackend, error_reply_fails) {
+  FakeRedis redis;
+  RedisBackend backend{redis.config(), false};
+
+  redis.failing(true);
+  ASSERT_FALSE(backend.set("192.168.10.22", "987654321", 60));
+
+  redis.failing(false);
+  ASSERT_TRUE(backend.set("192.168.10.22", "987654321", 60));
+}
+
+TEST(RedisBackend, malformed_bulk_length_disconnects) {
+  FakeRedis redis;
+  RedisBackend backend{redis.config(), false};
+
+  redis.replying("$abc\r\n");
+  ASSERT_FALSE(backend.set("192.168.10.22", "987654321", 60));
+
+  redis.replying("");
+  ASSERT_TRUE(backend.set("192.168.10.22", "987654321", 60));
+  ASSERT_EQ(2u, redis.connections());
+}
+
+TEST(RedisBackend, unreachable_server_fails) {
+  auto config = [] {
+    FakeRedis redis;
+    return redis.config();
+  }();
+  RedisBackend backend{config, false};
+
+  ASSERT_FALSE(backend.set("192.168.10.22", "987654321", 60));
+  ASSERT_FALSE(backend.flush());
+}
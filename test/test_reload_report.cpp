@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include "../src/reload_report.hpp"
+
+TEST(ReloadReport, first_load_adds_everything) {
+  ReloadReport report;
+  report.diff({}, {1, 2, 3});
+
+  ASSERT_EQ(3u, report.entries());
+  ASSERT_EQ(3u, report.added());
+  ASSERT_EQ(0u, report.removed());
+  ASSERT_EQ((std::vector<std::uint64_t>{1, 2, 3}), report.addedSample());
+  ASSERT_TRUE(report.removedSample().empty());
+}
+
+TEST(ReloadReport, diff_finds_added_and_removed) {
+  ReloadReport report;
+  report.diff({123, 345, 567, 1234567890123456}, {345, 567, 9123, 1234567890123456});
+
+  ASSERT_EQ(4u, report.entries());
+  ASSERT_EQ(1u, report.added());
+  ASSERT_EQ(1u, report.removed());
+  ASSERT_EQ((std::vector<std::uint64_t>{9123}), report.addedSample());
+  ASSERT_EQ((std::vector<std::uint64_t>{123}), report.removedSample());
+}
+
+TEST(ReloadReport, sample_is_bounded) {
+  std::vector<std::uint64_t> before;
+  std::vector<std::uint64_t> after;
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    before.push_back(i * 2);
+    after.push_back(i * 2 + 1);
+  }
+
+  ReloadReport report;
+  report.diff(before, after);
+
+  ASSERT_EQ(1000u, report.added());
+  ASSERT_EQ(1000u, report.removed());
+  ASSERT_EQ(ReloadReport::SAMPLE, report.addedSample().size());
+  ASSERT_EQ(ReloadReport::SAMPLE, report.removedSample().size());
+  ASSERT_EQ(1u, report.addedSample().front());
+  ASSERT_EQ(0u, report.removedSample().front());
+}
+
+TEST(ReloadReport, record_is_one_line) {
+  ReloadReport report;
+  report.lap("parse");
+  report.diff({1, 2}, {2, 3});
+  report.duplicates(5);
+  report.memory(2048, 4096);
+
+  auto record = report.record();
+  ASSERT_EQ(std::string::npos, record.find('\n'));
+  ASSERT_EQ(0u, record.find("entries=2 added=1 removed=1 added.sample=3 removed.sample=1 duplicates=5 time.parse_ms="));
+  ASSERT_NE(std::string::npos, record.find(" time.total_ms="));
+  ASSERT_NE(std::string::npos, record.find(" memory.footprint_kib=2 memory.peak_kib=4"));
+}
+
+TEST(ReloadReport, empty_samples_are_marked) {
+  ReloadReport report;
+  report.diff({1}, {1});
+
+  ASSERT_NE(std::string::npos, report.record().find("added=0 removed=0 added.sample=- removed.sample=-"));
+}
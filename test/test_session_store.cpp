@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include "../src/session_store.hpp"
+
+namespace {
+  constexpr std::time_t START = 1000000;
+
+  Config::Cache makeConfig(bool enabled = true) {
+    return Config::Cache::load(enabled ? "res/test/store.cfg" : "");
+  }
+
+  // One call per shard
+  std::size_t expireAll(SessionStore & store, std::time_t now) {
+    std::size_t expired{0};
+    for (std::size_t i = 0; i < SessionStore::SHARDS; ++i) {
+      expired += store.expire(now);
+    }
+    return expired;
+  }
+}
+
+TEST(SessionStore, disabled_store_keeps_nothing) {
+  SessionStore store{makeConfig(false), START};
+  store.store("192.168.10.22", "987654321", START);
+
+  ASSERT_EQ(0u, store.size());
+}
+
+TEST(SessionStore, store_and_remove) {
+  SessionStore store{makeConfig(), START};
+  store.store("192.168.10.22", "987654321", START);
+  store.store("192.168.10.23", "987654322", START);
+  ASSERT_EQ(2u, store.size());
+
+  store.remove("192.168.10.22");
+  ASSERT_EQ(1u, store.size());
+}
+
+TEST(SessionStore, sessions_expire_after_ttl) {
+  SessionStore store{makeConfig(), START};
+  store.store("192.168.10.22", "987654321", START);
+
+  ASSERT_EQ(0u, expireAll(store, START + 59));
+  ASSERT_EQ(1u, expireAll(store, START + 60));
+  ASSERT_EQ(0u, store.size());
+}
+
+TEST(SessionStore, update_refreshes_expiry) {
+  SessionStore store{makeConfig(), START};
+  store.store("192.168.10.22", "987654321", START);
+  store.store("192.168.10.22", "987654321", START + 30);
+
+  ASSERT_EQ(0u, expireAll(store, START + 60));
+  ASSERT_EQ(1u, store.size());
+  ASSERT_EQ(1u, expireAll(store, START + 90));
+}
+
+TEST(SessionStore, new_ttl_applies_to_later_stores) {
+  SessionStore store{makeConfig(), START};
+  store.store("192.168.10.22", "987654321", START);
+  store.setTtl(120);
+  store.store("192.168.10.23", "987654322", START);
+
+  ASSERT_EQ(1u, expireAll(store, START + 60));
+  ASSERT_EQ(1u, expireAll(store, START + 120));
+}
+
+TEST(SessionStore, expiry_is_bounded_per_call) {
+  setenv("RADIUS_CACHE_EXPIRY_BUDGET", "2", true);
+  SessionStore store{makeConfig(), START};
+  unsetenv("RADIUS_CACHE_EXPIRY_BUDGET");
+
+  for (int i = 0; i < 200; ++i) {
+    store.store("10.0.0." + std::to_string(i), "1", START);
+  }
+
+  auto expired = store.expire(START + 60);
+  ASSERT_LE(expired, 2u);
+  ASSERT_GE(store.size(), 198u);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <map>
+
+#include "../src/snapshot.hpp"
+
+namespace {
+  constexpr std::time_t START = 1000000;
+
+  // One file per test, since ctest runs them in parallel
+  std::string path() {
+    return std::string{::testing::UnitTest::GetInstance()->current_test_info()->name()} + ".snapshot";
+  }
+
+  using Sessions = std::map<std::string, std::pair<std::string, std::time_t>>;
+
+  Sessions readAll(std::time_t now) {
+    Sessions sessions;
+    Snapshot::read(path(), now, [&sessions](std::string_view key, std::string_view value, std::time_t expiry) {
+      sessions[std::string{key}] = {std::string{value}, expiry};
+    });
+    return sessions;
+  }
+
+  void writeStore(std::size_t count) {
+    SessionStore store{Config::Cache::load("res/test/store.cfg"), START};
+    for (std::size_t i = 0; i < count; ++i) {
+      store.store("10.0.0." + std::to_string(i), std::to_string(1000 + i), START + i);
+    }
+    ASSERT_EQ(count, Snapshot::write(path(), store));
+  }
+}
+
+TEST(Snapshot, missing_file_throws) {
+  std::remove(path().c_str());
+  ASSERT_ANY_THROW(readAll(START));
+}
+
+TEST(Snapshot, invalid_header_throws) {
+  {
+    std::ofstream stream{path()};
+    stream << "this is not a snapshot";
+  }
+  ASSERT_ANY_THROW(readAll(START));
+}
+
+TEST(Snapshot, round_trip) {
+  writeStore(100);
+
+  auto sessions = readAll(START);
+  ASSERT_EQ(100u, sessions.size());
+  ASSERT_EQ("1000", sessions["10.0.0.0"].first);
+  ASSERT_EQ(START + 60, sessions["10.0.0.0"].second);
+  ASSERT_EQ("1099", sessions["10.0.0.99"].first);
+  ASSERT_EQ(START + 99 + 60, sessions["10.0.0.99"].second);
+}
+
+TEST(Snapshot, expired_sessions_are_skipped) {
+  writeStore(100);
+
+  auto sessions = readAll(START + 60 + 49);
+  ASSERT_EQ(50u, sessions.size());
+  ASSERT_EQ(0u, sessions.count("10.0.0.49"));
+  ASSERT_EQ(1u, sessions.count("10.0.0.50"));
+}
+
+TEST(Snapshot, truncated_file_reads_up_to_last_whole_record) {
+  writeStore(100);
+
+  std::string content;
+  {
+    std::ifstream stream{path(), std::ios::binary};
+    content.assign(std::istreambuf_iterator<char>{stream}, {});
+  }
+  {
+    std::ofstream stream{path(), std::ios::binary | std::ios::trunc};
+    stream.write(content.data(), content.size() - 3);
+  }
+
+  ASSERT_EQ(99u, readAll(START).size());
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <thread>
+
+#include "../src/spill_journal.hpp"
+
+namespace {
+
+  // One file per test, since ctest runs them in parallel
+  Config::Cache makeConfig(bool fresh = true) {
+    auto path = std::string{::testing::UnitTest::GetInstance()->current_test_info()->name()} + ".journal";
+    if (fresh) {
+      std::remove(path.c_str());
+    }
+
+    setenv("RADIUS_CACHE_SPILL_FILE", path.c_str(), true);
+    setenv("RADIUS_CACHE_SPILL_SIZE_MEGABYTES", "1", true);
+    auto config = Config::Cache::load("res/test/store.cfg");
+    unsetenv("RADIUS_CACHE_SPILL_FILE");
+    unsetenv("RADIUS_CACHE_SPILL_SIZE_MEGABYTES");
+    return config;
+  }
+
+  struct Replayed {
+    std::map<std::string, SpillJournal::Entry> entries;
+    std::map<std::string, std::string> values;
+    std::size_t offset;
+  };
+
+  Replayed replay(const SpillJournal & journal) {
+    Replayed replayed;
+    replayed.offset = journal.replay([&replayed](const SpillJournal::Entry & entry) {
+      replayed.entries[std::string{entry.key}] = entry;
+      replayed.values[std::string{entry.key}] = std::string{entry.value};
+      return true;
+    });
+    return replayed;
+  }
+}
+
+TEST(SpillJournal, starts_inactive) {
+  auto config = makeConfig();
+  SpillJournal journal{config};
+
+  ASSERT_FALSE(journal.active());
+  ASSERT_EQ(0u, journal.size());
+}
+
+TEST(SpillJournal, superseded_keys_are_collapsed) {
+  auto config = makeConfig();
+  SpillJournal journal{config};
+
+  ASSERT_TRUE(journal.set("192.168.10.22", "987654321", 1000));
+  ASSERT_TRUE(journal.set("192.168.10.22", "123456789", 1000));
+  ASSERT_TRUE(journal.set("192.168.10.23", "987654321", 1000));
+  ASSERT_TRUE(journal.remove("192.168.10.23"));
+  ASSERT_TRUE(journal.set("192.168.10.24", "555", 1000));
+  ASSERT_TRUE(journal.active());
+
+  auto replayed = replay(journal);
+  ASSERT_EQ(3u, replayed.entries.size());
+  ASSERT_EQ(SpillJournal::SET, replayed.entries["192.168.10.22"].operation);
+  ASSERT_EQ("123456789", replayed.values["192.168.10.22"]);
+  ASSERT_EQ(1060, replayed.entries["192.168.10.22"].expiry);
+  ASSERT_EQ(SpillJournal::REMOVE, replayed.entries["192.168.10.23"].operation);
+  ASSERT_EQ("555", replayed.values["192.168.10.24"]);
+
+  journal.consume(replayed.offset);
+  ASSERT_FALSE(journal.active());
+  ASSERT_EQ(0u, journal.size());
+}
+
+TEST(SpillJournal, mutations_spilled_during_replay_are_kept) {
+  auto config = makeConfig();
+  SpillJournal journal{config};
+
+  journal.set("192.168.10.22", "987654321", 1000);
+  auto replayed = replay(journal);
+
+  journal.set("192.168.10.22", "123456789", 1000);
+  journal.consume(replayed.offset);
+  ASSERT_TRUE(journal.active());
+
+  replayed = replay(journal);
+  ASSERT_EQ(1u, replayed.entries.size());
+  ASSERT_EQ("123456789", replayed.values["192.168.10.22"]);
+}
+
+TEST(SpillJournal, aborted_replay_consumes_nothing) {
+  auto config = makeConfig();
+  SpillJournal journal{config};
+
+  journal.set("192.168.10.22", "987654321", 1000);
+  ASSERT_EQ(0u, journal.replay([](const SpillJournal::Entry &) { return false; }));
+  ASSERT_TRUE(journal.active());
+  ASSERT_EQ(1u, replay(journal).entries.size());
+}
+
+TEST(SpillJournal, drain_catches_up_with_spills_during_replay) {
+  auto config = makeConfig();
+  SpillJournal journal{config};
+
+  journal.set("192.168.10.22", "987654321", 1000);
+  auto offset = journal.replay([&journal](const SpillJournal::Entry &) {
+    return journal.set("192.168.10.23", "123456789", 1000);
+  });
+  journal.consume(offset);
+  ASSERT_TRUE(journal.active());
+
+  std::map<std::string, std::string> drained;
+  ASSERT_TRUE(journal.drain([&drained](const SpillJournal::Entry & entry) {
+    drained[std::string{entry.key}] = std::string{entry.value};
+    return true;
+  }, []() { return true; }));
+
+  ASSERT_EQ(1u, drained.size());
+  ASSERT_EQ("123456789", drained["192.168.10.23"]);
+  ASSERT_FALSE(journal.active());
+  ASSERT_EQ(0u, journal.size());
+}
+
+TEST(SpillJournal, spills_wait_for_drain) {
+  auto config = makeConfig();
+  SpillJournal journal{config};
+
+  journal.set("192.168.10.22", "987654321", 1000);
+  std::atomic<bool> spilled{false};
+  std::thread spiller;
+  ASSERT_TRUE(journal.drain([&](const SpillJournal::Entry &) {
+    spiller = std::thread{[&]() {
+      journal.set("192.168.10.22", "123456789", 1000);
+      spilled = true;
+    }};
+    return true;
+  }, [&spilled]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    return !spilled;
+  }));
+  spiller.join();
+
+  // Spilled after the drain, so it is left for the next replay
+  ASSERT_TRUE(journal.active());
+  ASSERT_EQ("123456789", replay(journal).values["192.168.10.22"]);
+}
+
+TEST(SpillJournal, failed_drain_consumes_nothing) {
+  auto config = makeConfig();
+  SpillJournal journal{config};
+
+  journal.set("192.168.10.22", "987654321", 1000);
+  auto size = journal.size();
+  ASSERT_FALSE(journal.drain([](const SpillJournal::Entry &) { return true; }, []() { return false; }));
+  ASSERT_TRUE(journal.active());
+  ASSERT_EQ(size, journal.size());
+
+  ASSERT_FALSE(journal.drain([](const SpillJournal::Entry &) { return false; }, []() { return true; }));
+  ASSERT_TRUE(journal.active());
+  ASSERT_EQ(size, journal.size());
+}
+
+TEST(SpillJournal, survives_restart) {
+  {
+    auto config = makeConfig();
+    SpillJournal journal{config};
+    journal.set("192.168.10.22", "987654321", 1000);
+  }
+
+  auto config = makeConfig(false);
+  SpillJournal journal{config};
+  ASSERT_TRUE(journal.active());
+  ASSERT_EQ("987654321", replay(journal).values["192.168.10.22"]);
+}
+
+TEST(SpillJournal, full_journal_drops_mutations) {
+  auto config = makeConfig();
+  SpillJournal journal{config};
+
+  std::string value(250, 'x');
+  std::size_t accepted{0};
+  for (int i = 0; i < 10000; ++i) {
+    if (journal.set(std::to_string(i), value, 1000)) {
+      ++accepted;
+    }
+  }
+
+  ASSERT_LT(accepted, 10000u);
+  ASSERT_GT(accepted, 3000u);
+  ASSERT_EQ(10000u - accepted, journal.dropped());
+  ASSERT_EQ(accepted, replay(journal).entries.size());
+}
+
+TEST(SpillJournal, empty_path_disables) {
+  setenv("RADIUS_CACHE_SPILL_FILE", "", true);
+  auto config = Config::Cache::load("res/test/store.cfg");
+  unsetenv("RADIUS_CACHE_SPILL_FILE");
+
+  SpillJournal journal{config};
+  ASSERT_FALSE(journal.enabled());
+  ASSERT_FALSE(journal.set("192.168.10.22", "987654321", 1000));
+  ASSERT_FALSE(journal.remove("192.168.10.22"));
+  ASSERT_FALSE(journal.active());
+  ASSERT_EQ(0u, journal.size());
+  ASSERT_EQ(2u, journal.dropped());
+}
+
+TEST(SpillJournal, unreachable_path_disables) {
+  setenv("RADIUS_CACHE_SPILL_FILE", "/nonexistent/spill.journal", true);
+  auto config = Config::Cache::load("res/test/store.cfg");
+  unsetenv("RADIUS_CACHE_SPILL_FILE");
+
+  SpillJournal journal{config};
+  ASSERT_FALSE(journal.enabled());
+  ASSERT_FALSE(journal.set("192.168.10.22", "987654321", 1000));
+  ASSERT_FALSE(journal.active());
+}
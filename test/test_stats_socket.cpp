@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../src/stats_socket.hpp"
+
+namespace {
+  std::string query(const std::string & path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+    auto socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (::connect(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+      ::close(socket);
+      return "unreachable";
+    }
+
+    std::string response;
+    char buffer[256];
+    for (ssize_t bytes; (bytes = ::read(socket, buffer, sizeof(buffer))) > 0;) {
+      response.append(buffer, static_cast<std::size_t>(bytes));
+    }
+    ::close(socket);
+    return response;
+  }
+
+  const std::string PATH = "/tmp/radius-cacher-test-stats.sock";
+}
+
+TEST(StatsSocket, answers_each_connection) {
+  int calls{0};
+  StatsSocket socket{PATH, [&calls]() { return "kept.STORE " + std::to_string(++calls) + "\n"; }};
+
+  ASSERT_EQ("kept.STORE 1\n", query(PATH));
+  ASSERT_EQ("kept.STORE 2\n", query(PATH));
+}
+
+TEST(StatsSocket, large_report) {
+  std::string report(100000, 'x');
+  StatsSocket socket{PATH, [&report]() { return report; }};
+
+  ASSERT_EQ(report, query(PATH));
+}
+
+TEST(StatsSocket, replaces_stale_socket_and_cleans_up) {
+  {
+    StatsSocket first{PATH, []() { return std::string{"first"}; }};
+  }
+  ASSERT_NE(0, ::access(PATH.c_str(), F_OK));
+
+  StatsSocket second{PATH, []() { return std::string{"second"}; }};
+  ASSERT_EQ("second", query(PATH));
+}
+
+TEST(StatsSocket, empty_path_disables) {
+  StatsSocket socket{"", []() { return std::string{}; }};
+  ASSERT_EQ("unreachable", query(""));
+}
+
+TEST(StatsSocket, successor_keeps_the_path) {
+  auto old = std::make_unique<StatsSocket>(PATH, []() { return std::string{"old"}; });
+  StatsSocket successor{PATH, []() { return std::string{"successor"}; }};
+
+  old.reset();
+  ASSERT_EQ("successor", query(PATH));
+}
+
+TEST(StatsSocket, stalled_client_is_given_up_on) {
+  std::string report(16 * 1024 * 1024, 'x');
+  StatsSocket socket{PATH, [&report]() { return report; }};
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  PATH.copy(address.sun_path, sizeof(address.sun_path) - 1);
+  auto stalled = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_EQ(0, ::connect(stalled, reinterpret_cast<sockaddr *>(&address), sizeof(address)));
+
+  // Never read from, so the next connection is only answered once the first send times out
+  ASSERT_EQ(report, query(PATH));
+  ::close(stalled);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "../src/timer_wheel.hpp"
+
+namespace {
+  constexpr std::time_t START = 1000000;
+
+  auto collect(TimerWheel<int> & wheel, std::time_t now, std::size_t budget = 1000000) {
+    std::set<int> expired;
+    wheel.advance(now, budget, [&expired](int value) { expired.insert(value); });
+    return expired;
+  }
+}
+
+TEST(TimerWheel, empty_wheel_expires_nothing) {
+  TimerWheel<int> wheel{START};
+  ASSERT_TRUE(collect(wheel, START + 100000).empty());
+}
+
+TEST(TimerWheel, expires_at_deadline_only) {
+  TimerWheel<int> wheel{START};
+  wheel.insert(1, START + 10);
+
+  ASSERT_TRUE(collect(wheel, START + 9).empty());
+  ASSERT_EQ(std::set<int>{1}, collect(wheel, START + 10));
+  ASSERT_EQ(0u, wheel.size());
+}
+
+TEST(TimerWheel, overdue_entries_expire_immediately) {
+  TimerWheel<int> wheel{START};
+  wheel.insert(1, START - 50);
+
+  ASSERT_EQ(std::set<int>{1}, collect(wheel, START));
+}
+
+TEST(TimerWheel, cascades_through_all_levels) {
+  TimerWheel<int> wheel{START};
+  std::vector<std::time_t> offsets{1, 63, 64, 65, 4095, 4096, 4097, 5400, 262143, 262144, 300000, 16777215};
+  for (std::size_t i = 0; i < offsets.size(); ++i) {
+    wheel.insert(static_cast<int>(i), START + offsets[i]);
+  }
+
+  for (std::size_t i = 0; i < offsets.size(); ++i) {
+    ASSERT_TRUE(collect(wheel, START + offsets[i] - 1).empty()) << "offset " << offsets[i];
+    ASSERT_EQ(std::set<int>{static_cast<int>(i)}, collect(wheel, START + offsets[i])) << "offset " << offsets[i];
+  }
+  ASSERT_EQ(0u, wheel.size());
+}
+
+TEST(TimerWheel, beyond_horizon_is_not_lost) {
+  TimerWheel<int> wheel{START};
+  wheel.insert(1, START + 20000000);
+
+  ASSERT_TRUE(collect(wheel, START + 19999999).empty());
+  ASSERT_EQ(std::set<int>{1}, collect(wheel, START + 20000000));
+}
+
+TEST(TimerWheel, refresh_postpones_expiry) {
+  TimerWheel<int> wheel{START};
+  auto handle = wheel.insert(1, START + 10);
+
+  ASSERT_TRUE(collect(wheel, START + 5).empty());
+  wheel.refresh(handle, START + 5400);
+
+  ASSERT_TRUE(collect(wheel, START + 5399).empty());
+  ASSERT_EQ(std::set<int>{1}, collect(wheel, START + 5400));
+}
+
+TEST(TimerWheel, remove_cancels_expiry) {
+  TimerWheel<int> wheel{START};
+  auto handle = wheel.insert(1, START + 10);
+  wheel.insert(2, START + 10);
+  wheel.remove(handle);
+
+  ASSERT_EQ(std::set<int>{2}, collect(wheel, START + 10));
+}
+
+TEST(TimerWheel, handles_are_recycled) {
+  TimerWheel<int> wheel{START};
+  auto handle = wheel.insert(1, START + 10);
+  wheel.remove(handle);
+
+  ASSERT_EQ(handle, wheel.insert(2, START + 20));
+  ASSERT_EQ(2, wheel.value(handle));
+}
+
+TEST(TimerWheel, budget_bounds_each_slice) {
+  TimerWheel<int> wheel{START};
+  for (int i = 0; i < 100; ++i) {
+    wheel.insert(i, START + 1 + i % 3);
+  }
+
+  std::size_t total{0};
+  std::size_t slices{0};
+  while (wheel.size() > 0) {
+    auto expired = collect(wheel, START + 10, 7).size();
+    ASSERT_LE(expired, 7u);
+    total += expired;
+    ++slices;
+  }
+
+  ASSERT_EQ(100u, total);
+  ASSERT_EQ(15u, slices);
+}
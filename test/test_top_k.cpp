@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/top_k.hpp"
+
+namespace {
+  void add(TopK & top, const std::string & item, int times) {
+    for (int i = 0; i < times; ++i) {
+      top.add(item, [&item]() { return item; });
+    }
+  }
+}
+
+TEST(TopK, empty_until_rotated) {
+  TopK top{3};
+  add(top, "a", 10);
+  ASSERT_EQ("", top.report("nas"));
+
+  top.rotate();
+  ASSERT_EQ("top.nas.a 10\n", top.report("nas"));
+}
+
+TEST(TopK, heaviest_first) {
+  TopK top{3};
+  add(top, "light", 5);
+  add(top, "heavy", 50);
+  add(top, "middle", 20);
+  top.rotate();
+
+  ASSERT_EQ("top.key.heavy 50\ntop.key.middle 20\ntop.key.light 5\n", top.report("key"));
+}
+
+TEST(TopK, heavy_hitters_displace_light_ones) {
+  TopK top{2};
+  for (int i = 0; i < 100; ++i) {
+    add(top, "noise" + std::to_string(i), 1);
+  }
+  add(top, "storm", 500);
+  add(top, "busy", 200);
+  top.rotate();
+
+  ASSERT_EQ("top.x.storm 500\ntop.x.busy 200\n", top.report("x"));
+}
+
+TEST(TopK, windows_start_over) {
+  TopK top{2};
+  add(top, "old", 100);
+  top.rotate();
+  add(top, "new", 3);
+  top.rotate();
+
+  ASSERT_EQ("top.x.new 3\n", top.report("x"));
+}
+
+TEST(TopK, name_is_built_once) {
+  TopK top{2};
+  int names{0};
+  for (int i = 0; i < 100; ++i) {
+    top.add("a", [&names]() {
+      ++names;
+      return std::string{"a"};
+    });
+  }
+  ASSERT_EQ(1, names);
+}
+
+TEST(TopK, concurrent_counts_are_not_lost) {
+  TopK top{4};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&top]() {
+      add(top, "shared", 10000);
+    });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  add(top, "shared", 1);
+  top.rotate();
+
+  ASSERT_EQ("top.x.shared 40001\n", top.report("x"));
+}
+
+TEST(TopK, zero_size_counts_nothing) {
+  TopK top{0};
+  add(top, "a", 10);
+  top.rotate();
+
+  ASSERT_EQ("", top.report("nas"));
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../src/unix_listener.hpp"
+
+namespace {
+  const std::string PATH = "/tmp/radius-cacher-test-listener.sock";
+
+  // Waits for the listener to close the connection
+  bool served(const std::string & path) {
+    auto address = UnixListener::toAddress(path, "test");
+    auto socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (::connect(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+      ::close(socket);
+      return false;
+    }
+
+    char byte;
+    ::read(socket, &byte, sizeof(byte));
+    ::close(socket);
+    return true;
+  }
+}
+
+TEST(UnixListener, serves_until_the_handler_declines) {
+  std::atomic<int> calls{0};
+  {
+    UnixListener listener{PATH, "test", 4, [&calls](int) { return ++calls < 2; }};
+    ASSERT_TRUE(served(PATH));
+    ASSERT_TRUE(served(PATH));
+  }
+
+  ASSERT_EQ(2, calls);
+  struct stat status{};
+  ASSERT_NE(0, ::stat(PATH.c_str(), &status));
+}
+
+TEST(UnixListener, path_too_long) {
+  ASSERT_ANY_THROW(UnixListener::toAddress(std::string(200, 'x'), "test"));
+  ASSERT_ANY_THROW((UnixListener{std::string(200, 'x'), "test", 1, [](int) { return true; }}));
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../src/uring.hpp"
+
+namespace {
+
+  std::unique_ptr<Uring> makeRing() {
+    try {
+      return std::make_unique<Uring>(8);
+    } catch (const std::exception &) {
+      return nullptr;
+    }
+  }
+
+  int bindLoopback(sockaddr_in & address) {
+    auto socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+
+    socklen_t length = sizeof(address);
+    ::getsockname(socket, reinterpret_cast<sockaddr *>(&address), &length);
+    return socket;
+  }
+}
+
+TEST(UringBufferRing, rejects_invalid_count) {
+  auto ring = makeRing();
+  if (!ring) GTEST_SKIP() << "io_uring not available";
+
+  ASSERT_ANY_THROW((UringBufferRing{*ring, 0, 0, 64}));
+  ASSERT_ANY_THROW((UringBufferRing{*ring, 0, 3, 64}));
+}
+
+TEST(Uring, nop_completes) {
+  auto ring = makeRing();
+  if (!ring) GTEST_SKIP() << "io_uring not available";
+
+  for (std::uint64_t i = 0; i < 20; ++i) {
+    auto & sqe = ring->prepare();
+    sqe.opcode = IORING_OP_NOP;
+    sqe.user_data = i;
+  }
+  ring->submit(1);
+
+  std::vector<std::uint64_t> completed;
+  while (completed.size() < 20) {
+    ring->forEach([&](const io_uring_cqe & cqe) { completed.push_back(cqe.user_data); });
+    if (completed.size() < 20) ring->submit(1);
+  }
+  ASSERT_EQ(20, completed.size());
+}
+
+TEST(Uring, multishot_recvmsg_into_provided_buffers) {
+  auto ring = makeRing();
+  if (!ring) GTEST_SKIP() << "io_uring not available";
+
+  constexpr std::size_t SIZE = sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_storage) + 64;
+  std::unique_ptr<UringBufferRing> buffers;
+  try {
+    buffers = std::make_unique<UringBufferRing>(*ring, 7, 4, SIZE);
+  } catch (const std::exception &) {
+    GTEST_SKIP() << "provided buffer rings not available";
+  }
+
+  sockaddr_in address{};
+  auto receiver = bindLoopback(address);
+  auto sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+  msghdr header{};
+  header.msg_namelen = sizeof(sockaddr_storage);
+
+  auto & sqe = ring->prepare();
+  sqe.opcode = IORING_OP_RECVMSG;
+  sqe.fd = receiver;
+  sqe.addr = reinterpret_cast<std::uint64_t>(&header);
+  sqe.len = 1;
+  sqe.ioprio = IORING_RECV_MULTISHOT;
+  sqe.flags = IOSQE_BUFFER_SELECT;
+  sqe.buf_group = buffers->group();
+  ring->submit();
+
+  // More packets than buffers, to make sure they are recycled
+  std::vector<std::string> sent;
+  for (int i = 0; i < 10; ++i) {
+    sent.push_back("packet " + std::to_string(i));
+  }
+
+  std::vector<std::string> received;
+  for (const auto & packet : sent) {
+    ::sendto(sender, packet.data(), packet.size(), 0, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+
+    ring->submit(1);
+    ring->forEach([&](const io_uring_cqe & cqe) {
+      ASSERT_GE(cqe.res, 0);
+      ASSERT_TRUE(cqe.flags & IORING_CQE_F_BUFFER);
+      ASSERT_TRUE(cqe.flags & IORING_CQE_F_MORE);
+
+      auto id = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+      auto out = reinterpret_cast<const io_uring_recvmsg_out *>(buffers->buffer(id));
+      auto payload = reinterpret_cast<const char *>(buffers->buffer(id))
+                     + sizeof(io_uring_recvmsg_out) + header.msg_namelen;
+      received.emplace_back(payload, out->payloadlen);
+      buffers->recycle(id);
+    });
+  }
+
+  ::close(sender);
+  ::close(receiver);
+  ASSERT_EQ(sent, received);
+}
+
+TEST(Uring, probe_matches_the_engine) {
+  auto ring = makeRing();
+  if (!ring) GTEST_SKIP() << "io_uring not available";
+  try {
+    UringBufferRing buffers{*ring, 0, 1, 64};
+  } catch (const std::exception &) {
+    GTEST_SKIP() << "provided buffer rings not available";
+  }
+
+  // Whatever it lacks, the probe should say so rather than leave it to the receive loop
+  try {
+    Uring::probe();
+  } catch (const std::exception & e) {
+    ASSERT_NE(std::string::npos, std::string{e.what()}.find("multishot recvmsg")) << e.what();
+  }
+}